@@ -3,7 +3,9 @@
 
 // Qt Includes
 #include <QDebug>
+#include <QHideEvent>
 #include <QPaintEvent>
+#include <QShowEvent>
 #include <QPainter>
 #include <QPen>      
 #include <QPointF>   
@@ -20,7 +22,6 @@ AnimationPreviewWidget::AnimationPreviewWidget(QWidget *parent)
 {
     connect(&m_timer, &QTimer::timeout, this, &AnimationPreviewWidget::updateAnimation);
     m_timer.setInterval(16);
-    m_timer.start();
 
     setMinimumSize(50, 100);
     setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::Preferred);
@@ -37,6 +38,20 @@ void AnimationPreviewWidget::setLoopDuration(int ms) {
     }
 }
 
+/**
+ * @brief Starts the animation clock only once the preview is actually visible,
+ * so it does not tick during application startup or while hidden.
+ */
+void AnimationPreviewWidget::showEvent(QShowEvent *event) {
+    QWidget::showEvent(event);
+    if (!m_timer.isActive()) m_timer.start();
+}
+
+void AnimationPreviewWidget::hideEvent(QHideEvent *event) {
+    QWidget::hideEvent(event);
+    m_timer.stop();
+}
+
 void AnimationPreviewWidget::updateAnimation() {
     if (m_loopDurationMs <= 0) return;
 
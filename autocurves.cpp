@@ -0,0 +1,229 @@
+#include "autocurves.h"
+#include "bakeservice.h"
+#include "curvefitter.h"
+
+#include <QImage>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cmath>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+const int MAX_BINS = 65536;
+
+/**
+ * @brief Counts rows [first, last) into counts (4 * bins entries, channel major).
+ */
+void countRows(const QImage& image, int first, int last, int bins, bool deep, quint64 *counts)
+{
+    quint64 *red = counts;
+    quint64 *green = counts + bins;
+    quint64 *blue = counts + 2 * bins;
+    quint64 *luma = counts + 3 * bins;
+    const int width = image.width();
+    // Values are 16 bit in deep images and 8 bit otherwise; shifting the scaled value
+    // maps them onto the bins without a division per pixel.
+    const int shift = deep ? 16 : 8;
+    for (int y = first; y < last; ++y) {
+        if (deep) {
+            const QRgba64 *line = reinterpret_cast<const QRgba64*>(image.constScanLine(y));
+            for (int x = 0; x < width; ++x) {
+                const quint64 r = line[x].red(), g = line[x].green(), b = line[x].blue();
+                ++red[(r * bins) >> shift];
+                ++green[(g * bins) >> shift];
+                ++blue[(b * bins) >> shift];
+                ++luma[(((2126 * r + 7152 * g + 722 * b) / 10000) * bins) >> shift];
+            }
+        } else {
+            const QRgb *line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+            for (int x = 0; x < width; ++x) {
+                const quint64 r = qRed(line[x]), g = qGreen(line[x]), b = qBlue(line[x]);
+                ++red[(r * bins) >> shift];
+                ++green[(g * bins) >> shift];
+                ++blue[(b * bins) >> shift];
+                ++luma[(((2126 * r + 7152 * g + 722 * b) / 10000) * bins) >> shift];
+            }
+        }
+    }
+}
+
+}
+
+/**
+ * @brief Fraction of pixels with a value below x, treating the pixels of a bin as
+ * spread evenly across it. 0 at x = 0 and 1 at x = 1.
+ */
+qreal ImageHistogram::fractionBelow(Channel channel, qreal x) const
+{
+    if (total == 0) return std::clamp(x, 0.0, 1.0);
+    const qreal position = std::clamp(x, 0.0, 1.0) * bins;
+    const int bin = std::min(bins - 1, static_cast<int>(position));
+    const qreal inBin = (position - bin) * counts[channel][bin];
+    return (cumulative[channel][bin] + inBin) / static_cast<qreal>(total);
+}
+
+/**
+ * @brief The value below which the given fraction of pixels lies; the inverse of
+ * fractionBelow().
+ */
+qreal ImageHistogram::quantile(Channel channel, qreal fraction) const
+{
+    if (total == 0) return std::clamp(fraction, 0.0, 1.0);
+    const qreal target = std::clamp(fraction, 0.0, 1.0) * total;
+    const QVector<quint64>& sums = cumulative[channel];
+    // The last bin whose start lies at or below the target.
+    int bin = static_cast<int>(std::upper_bound(sums.cbegin(), sums.cend() - 1, target,
+                                                [](qreal value, quint64 sum) { return value < sum; })
+                               - sums.cbegin()) - 1;
+    bin = std::clamp(bin, 0, bins - 1);
+    const quint64 inBin = counts[channel][bin];
+    const qreal offset = inBin ? std::clamp((target - sums[bin]) / inBin, 0.0, 1.0) : 0.0;
+    return (bin + offset) / bins;
+}
+
+/**
+ * @brief Bins the red, green, blue and luma values of every pixel; alpha is ignored.
+ * More than 256 bins (or a 16-bit image) reads the pixels at 16 bits.
+ */
+ImageHistogram AutoCurves::histogram(const QImage& source, int bins, QThreadPool *pool)
+{
+    ImageHistogram result;
+    if (source.isNull()) return result;
+
+    result.bins = std::clamp(bins, 2, MAX_BINS);
+    const bool deep = result.bins > 256 || source.depth() > 32;
+    const QImage image = source.convertToFormat(deep ? QImage::Format_RGBX64 : QImage::Format_RGB32);
+    const int height = image.height();
+    const int binCount = result.bins;
+    const int stride = 4 * binCount;
+
+    const int jobs = pool ? std::clamp(pool->maxThreadCount(), 1, height) : 1;
+    QVector<quint64> partial(static_cast<qsizetype>(jobs) * stride, 0);
+    quint64 *partialData = partial.data();
+    BakeService::parallelFor(jobs, 1, [&image, partialData, height, jobs, stride, binCount, deep](int firstJob, int lastJob) {
+        for (int j = firstJob; j < lastJob; ++j) {
+            const int first = static_cast<int>(static_cast<qint64>(height) * j / jobs);
+            const int last = static_cast<int>(static_cast<qint64>(height) * (j + 1) / jobs);
+            countRows(image, first, last, binCount, deep, partialData + static_cast<qsizetype>(j) * stride);
+        }
+    }, pool);
+
+    for (int c = 0; c < 4; ++c) {
+        result.counts[c].fill(0, result.bins);
+        result.cumulative[c].fill(0, result.bins + 1);
+        for (int j = 0; j < jobs; ++j) {
+            const quint64 *counts = partialData + static_cast<qsizetype>(j) * stride + static_cast<qsizetype>(c) * result.bins;
+            for (int b = 0; b < result.bins; ++b) result.counts[c][b] += counts[b];
+        }
+        for (int b = 0; b < result.bins; ++b) {
+            result.cumulative[c][b + 1] = result.cumulative[c][b] + result.counts[c][b];
+        }
+    }
+    result.total = static_cast<quint64>(image.width()) * height;
+    return result;
+}
+
+/**
+ * @brief Builds the RED, GREEN and BLUE curves for the histogram.
+ * @param maxError - If not null, receives the largest fitting error over all channels.
+ */
+CurveSampler::ChannelMap AutoCurves::generate(const ImageHistogram& histogram, const AutoCurveSettings& settings,
+                                              qreal *maxError)
+{
+    const CurveWidget::ActiveChannel channels[3] = {
+        CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN, CurveWidget::ActiveChannel::BLUE
+    };
+    CurveSampler::ChannelMap result;
+    qreal worst = 0.0;
+
+    for (int c = 0; c < 3; ++c) {
+        const ImageHistogram::Channel source = settings.linked ? ImageHistogram::Luma : static_cast<ImageHistogram::Channel>(c);
+
+        if (settings.mode == AutoCurveSettings::Mode::Levels) {
+            const qreal low = histogram.quantile(source, settings.clip);
+            const qreal high = histogram.quantile(source, 1.0 - settings.clip);
+            QVector<QPointF> points = { QPointF(0.0, 0.0) };
+            if (high - low >= 1e-3) {
+                if (low > 1e-6) points.append(QPointF(low, 0.0));
+                if (high < 1.0 - 1e-6) points.append(QPointF(high, 1.0));
+            }
+            points.append(QPointF(1.0, 1.0));
+            result.insert(channels[c], CurveFitter::polylineNodes(points));
+            continue;
+        }
+
+        QVector<qreal> ys(EqualizeSamples);
+        for (int i = 0; i < EqualizeSamples; ++i) {
+            const qreal x = static_cast<qreal>(i) / (EqualizeSamples - 1);
+            ys[i] = x + settings.strength * (histogram.fractionBelow(source, x) - x);
+        }
+        qreal error = 0.0;
+        result.insert(channels[c], CurveFitter::fitSamples(ys, settings.maxNodes, settings.tolerance, &error));
+        worst = std::max(worst, error);
+    }
+
+    if (maxError) *maxError = worst;
+    return result;
+}
+
+/**
+ * @brief Bins for a histogram used in matching: MatchBins for images with more than
+ * 8 bits per channel, 256 otherwise. An 8-bit image spread over 65536 bins fills only
+ * every 257th one, and its CDF turns into a staircase the fit chases node by node.
+ */
+int AutoCurves::matchBins(const QImage& image)
+{
+    switch (image.format()) {
+    case QImage::Format_Grayscale16:
+    case QImage::Format_RGBX64:
+    case QImage::Format_RGBA64:
+    case QImage::Format_RGBA64_Premultiplied:
+    case QImage::Format_RGBX16FPx4:
+    case QImage::Format_RGBA16FPx4:
+    case QImage::Format_RGBA16FPx4_Premultiplied:
+    case QImage::Format_RGBX32FPx4:
+    case QImage::Format_RGBA32FPx4:
+    case QImage::Format_RGBA32FPx4_Premultiplied:
+    case QImage::Format_BGR30:
+    case QImage::Format_A2BGR30_Premultiplied:
+    case QImage::Format_RGB30:
+    case QImage::Format_A2RGB30_Premultiplied:
+        return MatchBins;
+    default:
+        return 256;
+    }
+}
+
+/**
+ * @brief Histogram matching: the RED, GREEN and BLUE curves that map the source's
+ * values onto the reference's distribution. The transfer function is monotonic, so
+ * the fitted curves are too. Bin each image with matchBins(); the two may differ.
+ * @param maxError - If not null, receives the largest fitting error over all channels.
+ */
+CurveSampler::ChannelMap AutoCurves::matchHistograms(const ImageHistogram& source, const ImageHistogram& reference,
+                                                     const AutoCurveSettings& settings, qreal *maxError)
+{
+    const CurveWidget::ActiveChannel channels[3] = {
+        CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN, CurveWidget::ActiveChannel::BLUE
+    };
+    CurveSampler::ChannelMap result;
+    qreal worst = 0.0;
+
+    for (int c = 0; c < 3; ++c) {
+        const ImageHistogram::Channel channel = settings.linked ? ImageHistogram::Luma : static_cast<ImageHistogram::Channel>(c);
+        QVector<qreal> ys(MatchSamples);
+        for (int i = 0; i < MatchSamples; ++i) {
+            const qreal x = static_cast<qreal>(i) / (MatchSamples - 1);
+            const qreal matched = reference.quantile(channel, source.fractionBelow(channel, x));
+            ys[i] = x + settings.strength * (matched - x);
+        }
+        qreal error = 0.0;
+        result.insert(channels[c], CurveFitter::fitSamples(ys, settings.maxNodes, settings.tolerance, &error));
+        worst = std::max(worst, error);
+    }
+
+    if (maxError) *maxError = worst;
+    return result;
+}
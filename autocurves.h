@@ -0,0 +1,73 @@
+#ifndef AUTOCURVES_H
+#define AUTOCURVES_H
+
+// Qt Includes
+#include <QVector>
+
+// Project Includes
+#include "curvesampler.h"
+
+// Forward Declarations
+class QImage;
+class QThreadPool;
+
+/**
+ * @brief Per-channel value histograms of an image plus their running sums (CDFs).
+ * Values are spread evenly over [0, 1] with `bins` bins; luma is Rec. 709.
+ */
+struct ImageHistogram {
+    enum Channel { Red = 0, Green = 1, Blue = 2, Luma = 3 };
+
+    int bins = 0;
+    quint64 total = 0;
+    QVector<quint64> counts[4];
+    QVector<quint64> cumulative[4];     // bins + 1 entries: pixels in the bins before each bin.
+
+    bool isEmpty() const { return total == 0; }
+    qreal fractionBelow(Channel channel, qreal x) const;
+    qreal quantile(Channel channel, qreal fraction) const;
+};
+
+/**
+ * @brief What AutoCurves::generate() builds from a histogram.
+ */
+struct AutoCurveSettings {
+    enum class Mode {
+        Equalize,   // Map each value to the fraction of pixels below it.
+        Levels      // Stretch the range between the clip quantiles to [0, 1].
+    };
+
+    Mode mode = Mode::Equalize;
+    bool linked = false;            // One curve from luma for all channels, so hues stay put.
+    qreal strength = 1.0;           // Equalize and matching: blend from identity (0) to the full curve (1).
+    qreal clip = 0.005;             // Levels: fraction of pixels clipped at each end.
+    int maxNodes = 12;
+    qreal tolerance = 1.0 / 512.0;  // Largest allowed difference between fitted curve and target.
+};
+
+/**
+ * @brief Starting curves for grading from image statistics.
+ *
+ * histogram() bins an image in parallel on the given pool: each job counts a band of
+ * scanlines into its own table and the tables are summed at the end. generate() turns
+ * the CDFs into equalization or auto-levels curves, and matchHistograms() into the
+ * transfer curves that give a source image the value distribution of a reference
+ * (y = reference quantile of the source's fraction below x). Both are fitted with
+ * CurveFitter into a few nodes so the result stays editable and cheap to sample.
+ */
+class AutoCurves
+{
+public:
+    static ImageHistogram histogram(const QImage& image, int bins = 256, QThreadPool *pool = nullptr);
+    static CurveSampler::ChannelMap generate(const ImageHistogram& histogram, const AutoCurveSettings& settings,
+                                             qreal *maxError = nullptr);
+    static CurveSampler::ChannelMap matchHistograms(const ImageHistogram& source, const ImageHistogram& reference,
+                                                    const AutoCurveSettings& settings, qreal *maxError = nullptr);
+    static int matchBins(const QImage& image);
+
+    static const int EqualizeSamples = 257;
+    static const int MatchSamples = 1025;
+    static const int MatchBins = 65536;     // For 16-bit images, so dark and smooth gradients keep their detail.
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include "bakeservice.h"
+
+#include <QByteArrayView>
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QSemaphore>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+
+BakeService::BakeService()
+    : m_lutCache(4096) // Cost is in KiB, so about 4 MiB of baked rows.
+{
+    // Leave one core to the GUI thread.
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+BakeService& BakeService::instance()
+{
+    static BakeService service;
+    return service;
+}
+
+QThreadPool* BakeService::pool()
+{
+    return &m_pool;
+}
+
+/**
+ * @brief Runs job(first, last) over [0, count) in chunks of chunkSize and returns when
+ * all of them are done. Only these jobs are waited for, not everything else on the
+ * pool. With a null pool the chunks run on the calling thread; pass null from inside
+ * a pool job, since waiting there could starve the pool.
+ */
+void BakeService::parallelFor(int count, int chunkSize, const std::function<void(int first, int last)>& job,
+                              QThreadPool *pool)
+{
+    chunkSize = std::max(1, chunkSize);
+    if (!pool || count <= chunkSize) {
+        for (int first = 0; first < count; first += chunkSize) job(first, std::min(count, first + chunkSize));
+        return;
+    }
+    QSemaphore finished;
+    int jobs = 0;
+    for (int first = 0; first < count; first += chunkSize) {
+        const int last = std::min(count, first + chunkSize);
+        pool->start([&job, &finished, first, last]() {
+            job(first, last);
+            finished.release();
+        });
+        ++jobs;
+    }
+    finished.acquire(jobs);
+}
+
+/**
+ * @brief Hashes the geometry and alignment of every node. Node ids are left out,
+ * so two documents holding the same curves share cache entries.
+ */
+QByteArray BakeService::contentKey(const ChannelMap& channels)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (auto it = channels.constBegin(); it != channels.constEnd(); ++it) {
+        const qint32 header[2] = { static_cast<qint32>(it.key()), static_cast<qint32>(it.value().size()) };
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(header), sizeof(header)));
+        for (const CurveWidget::CurveNode& node : it.value()) {
+            const qreal values[7] = {
+                node.mainPoint.x(), node.mainPoint.y(),
+                node.handleIn.x(), node.handleIn.y(),
+                node.handleOut.x(), node.handleOut.y(),
+                static_cast<qreal>(node.alignment)
+            };
+            hash.addData(QByteArrayView(reinterpret_cast<const char*>(values), sizeof(values)));
+        }
+    }
+    return hash.result();
+}
+
+QVector<float> BakeService::bakeRgb(const ChannelMap& channels, int width)
+{
+    return bakeRgb(contentKey(channels), channels, width);
+}
+
+/**
+ * @brief Returns width interleaved R, G, B values in [0, 1] at the texel positions
+ * i / (width - 1), baking them on a cache miss.
+ * @param key - contentKey() of channels, for callers that already computed it.
+ */
+QVector<float> BakeService::bakeRgb(const QByteArray& key, const ChannelMap& channels, int width)
+{
+    if (width < 1) return QVector<float>();
+
+    const QByteArray cacheKey = key + ':' + QByteArray::number(width);
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        if (const QVector<float> *cached = m_lutCache.object(cacheKey)) {
+            return *cached;
+        }
+    }
+
+    const CurveSampler sampler(channels);
+    const CurveWidget::ActiveChannel order[] = {
+        CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN, CurveWidget::ActiveChannel::BLUE
+    };
+    QVector<qreal> column(width);
+    QVector<float> rgb(width * 3);
+    for (int c = 0; c < 3; ++c) {
+        sampler.sampleUniform(order[c], width, column.data());
+        for (int i = 0; i < width; ++i) {
+            rgb[i * 3 + c] = static_cast<float>(column[i]);
+        }
+    }
+
+    insertCached(cacheKey, rgb);
+    return rgb;
+}
+
+/**
+ * @brief Like bakeRgb(), but on a cache miss starts from previous, the row of the
+ * state right before changes, and resamples only the texels inside the changed
+ * x ranges of the changed channels. Falls back to a full bake if previous does
+ * not have the right size.
+ */
+QVector<float> BakeService::rebakeRgb(const QVector<float>& previous, const ChannelMap& channels, int width,
+                                      const QVector<CurveWidget::CurveChange>& changes)
+{
+    if (width < 2 || previous.size() != width * 3) return bakeRgb(channels, width);
+
+    const QByteArray cacheKey = contentKey(channels) + ':' + QByteArray::number(width);
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        if (const QVector<float> *cached = m_lutCache.object(cacheKey)) {
+            return *cached;
+        }
+    }
+
+    QVector<float> rgb = previous;
+    QVector<qreal> xs;
+    QVector<qreal> ys;
+    for (const CurveWidget::CurveChange& change : changes) {
+        int c = 0;
+        switch (change.channel) {
+        case CurveWidget::ActiveChannel::RED:   c = 0; break;
+        case CurveWidget::ActiveChannel::GREEN: c = 1; break;
+        case CurveWidget::ActiveChannel::BLUE:  c = 2; break;
+        }
+        const int first = std::max(0, static_cast<int>(std::floor(change.xMin * (width - 1.0))));
+        const int last = std::min(width - 1, static_cast<int>(std::ceil(change.xMax * (width - 1.0))));
+        if (first > last) continue;
+
+        const int count = last - first + 1;
+        xs.resize(count);
+        ys.resize(count);
+        for (int i = 0; i < count; ++i) {
+            xs[i] = static_cast<qreal>(first + i) / (width - 1.0);
+        }
+        CurveSampler::sampleNodesSorted(channels.value(change.channel), xs.constData(), count, ys.data());
+        for (int i = 0; i < count; ++i) {
+            rgb[(first + i) * 3 + c] = static_cast<float>(ys[i]);
+        }
+    }
+
+    insertCached(cacheKey, rgb);
+    return rgb;
+}
+
+void BakeService::insertCached(const QByteArray& cacheKey, const QVector<float>& rgb)
+{
+    const int cost = std::max(1, static_cast<int>(rgb.size() * sizeof(float) / 1024));
+    QMutexLocker locker(&m_cacheMutex);
+    m_lutCache.insert(cacheKey, new QVector<float>(rgb), cost);
+}
+
+void BakeService::clearCache()
+{
+    QMutexLocker locker(&m_cacheMutex);
+    m_lutCache.clear();
+}
@@ -0,0 +1,56 @@
+#ifndef BAKESERVICE_H
+#define BAKESERVICE_H
+
+// Qt Includes
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QThreadPool>
+#include <QVector>
+
+// Standard Library Includes
+#include <functional>
+
+// Project Includes
+#include "curvesampler.h"
+
+/**
+ * @brief Process-wide bake resources shared by every open document.
+ *
+ * Owns the worker pool used for background analyses and a cache of baked RGB
+ * LUT rows keyed by the content of the curves (not by document or revision),
+ * so identical curves in different tabs, or a state reached again through undo,
+ * are only baked once. The cache may be used from any thread.
+ */
+class BakeService
+{
+public:
+    using ChannelMap = CurveSampler::ChannelMap;
+
+    static BakeService& instance();
+
+    QThreadPool* pool();
+
+    static void parallelFor(int count, int chunkSize, const std::function<void(int first, int last)>& job,
+                            QThreadPool *pool);
+
+    static QByteArray contentKey(const ChannelMap& channels);
+    QVector<float> bakeRgb(const ChannelMap& channels, int width);
+    QVector<float> bakeRgb(const QByteArray& key, const ChannelMap& channels, int width);
+    QVector<float> rebakeRgb(const QVector<float>& previous, const ChannelMap& channels, int width,
+                             const QVector<CurveWidget::CurveChange>& changes);
+    void clearCache();
+
+private:
+    void insertCached(const QByteArray& cacheKey, const QVector<float>& rgb);
+
+    BakeService();
+    BakeService(const BakeService&) = delete;
+    BakeService& operator=(const BakeService&) = delete;
+
+    QThreadPool m_pool;
+    QMutex m_cacheMutex;
+    QCache<QByteArray, QVector<float>> m_lutCache;
+};
+
+#endif
@@ -0,0 +1,198 @@
+#include "batchbaker.h"
+#include "bakeservice.h"
+#include "crossingsolver.h"
+#include "curveproject.h"
+#include "lutexport.h"
+#include "vertexweights.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QJsonArray>
+
+QJsonObject BakeResult::toJson() const
+{
+    QJsonObject obj;
+    obj["project"] = projectPath;
+    obj["ok"] = ok;
+    if (!lutPath.isEmpty()) obj["lut"] = lutPath;
+    if (!variantPaths.isEmpty()) obj["variants"] = QJsonArray::fromStringList(variantPaths);
+    if (!framesPath.isEmpty()) obj["frames"] = framesPath;
+    if (!frameTablePath.isEmpty()) obj["frame_table"] = frameTablePath;
+    if (!weightsPath.isEmpty()) obj["weights"] = weightsPath;
+    if (!eventsPath.isEmpty()) {
+        obj["events"] = eventsPath;
+        obj["event_count"] = eventCount;
+    }
+    if (width > 0) obj["width"] = width;
+    if (bitDepth > 0) obj["bit_depth"] = bitDepth;
+    if (!content.isEmpty()) obj["content"] = content;
+    if (!error.isEmpty()) obj["error"] = error;
+    return obj;
+}
+
+/**
+ * @brief Bakes one project.
+ */
+BakeResult BatchBaker::bakeFile(const QString& projectPath, const BakeOptions& options)
+{
+    BakeResult result;
+    result.projectPath = projectPath;
+
+    CurveProject::ProjectData project;
+    if (!CurveProject::readFile(projectPath, project, &result.error)) {
+        return result;
+    }
+
+    result.width = project.settings.lutWidth >= 2 ? project.settings.lutWidth : ProjectSettings().lutWidth;
+    result.bitDepth = project.settings.exportBitDepth;
+    result.content = LutExport::contentName(LutExport::contentFromName(project.settings.lutContent));
+    const LutExport::Content content = LutExport::contentFromName(project.settings.lutContent);
+    const QFileInfo info(projectPath);
+    const QDir directory(options.outputDirectory.isEmpty() ? info.absolutePath() : options.outputDirectory);
+
+    if (result.bitDepth == 32) {
+        const QString lutPath = directory.filePath(info.completeBaseName() + QStringLiteral(".pfm"));
+        const FloatRange range = (content == LutExport::Content::Values) ? LutExport::normalizationRange(project.channels) : FloatRange();
+        const QVector<float> rgb = (content == LutExport::Content::Values)
+            ? LutExport::bakeFloatRgb(project.channels, result.width, range)
+            : LutExport::bakeIntegralRgb(project.channels, result.width, content == LutExport::Content::NormalizedIntegral);
+        if (!LutExport::writePfm(lutPath, rgb.constData(), result.width, 1, &result.error)
+            || !LutExport::writeRangeSidecar(lutPath, range, &result.error)) {
+            return result;
+        }
+        result.lutPath = lutPath;
+    } else {
+        if (result.bitDepth != 8 && result.bitDepth != 16) result.bitDepth = 8;
+        const QString lutPath = directory.filePath(info.completeBaseName() + QStringLiteral(".png"));
+        const QVector<float> rgb = (content == LutExport::Content::Values)
+            ? BakeService::instance().bakeRgb(project.channels, result.width)
+            : LutExport::bakeIntegralRgb(project.channels, result.width, content == LutExport::Content::NormalizedIntegral);
+        const QImage image = LutExport::rgbLutImage(rgb, result.width, result.bitDepth);
+        if (image.isNull() || !image.save(lutPath, "PNG")) {
+            result.error = QStringLiteral("Failed to write %1").arg(lutPath);
+            return result;
+        }
+        result.lutPath = lutPath;
+    }
+
+    if (!options.variants.isEmpty()) {
+        QVector<LutTarget> targets = LutExport::parseTargets(options.variants, result.bitDepth);
+        for (LutTarget& target : targets) {
+            target.filePath = LutExport::targetPath(result.lutPath, target);
+        }
+        // Already on a pool thread, so the variants are written one after the other.
+        const QStringList failures = LutExport::exportTargets(project.channels, targets, content);
+        if (!failures.isEmpty()) {
+            result.error = failures.join("; ");
+            return result;
+        }
+        for (const LutTarget& target : std::as_const(targets)) result.variantPaths.append(target.filePath);
+    }
+
+    if (options.bakeFrames) {
+        // Like the main LUT: project content, and unclamped, range-normalized values for float.
+        const bool floatFrames = result.bitDepth == 32;
+        const QVector<float> rgb = LutExport::bakeFrameRgb(project.channels, options.frames, content, !floatFrames);
+        const int frames = options.frames.frameCount();
+        const QString framesPath = directory.filePath(info.completeBaseName()
+                                                      + (floatFrames ? QStringLiteral(".frames.pfm") : QStringLiteral(".frames.png")));
+        bool written = false;
+        if (floatFrames) {
+            const FloatRange range = (content == LutExport::Content::Values) ? LutExport::normalizationRange(project.channels) : FloatRange();
+            QVector<float> normalized = rgb;
+            for (float& value : normalized) value = static_cast<float>(range.normalize(value));
+            written = LutExport::writePfm(framesPath, normalized.constData(), frames, 1, &result.error)
+                      && LutExport::writeRangeSidecar(framesPath, range, &result.error);
+        } else {
+            written = LutExport::rgbLutImage(rgb, frames, result.bitDepth).save(framesPath, "PNG");
+        }
+        if (!written) {
+            if (result.error.isEmpty()) result.error = QStringLiteral("Failed to write %1").arg(framesPath);
+            return result;
+        }
+        result.framesPath = framesPath;
+
+        const QString tablePath = directory.filePath(info.completeBaseName() + QStringLiteral(".frames.csv"));
+        if (!LutExport::writeFrameTable(tablePath, rgb, options.frames, &result.error)) {
+            return result;
+        }
+        result.frameTablePath = tablePath;
+    }
+
+    if (!options.vertexWeights.isEmpty()) {
+        const QString weightsPath = VertexWeights::weightsPath(result.lutPath, result.bitDepth);
+        if (!VertexWeights::write(weightsPath, options.weightsMesh, options.vertexWeights, result.bitDepth, &result.error)) {
+            return result;
+        }
+        result.weightsPath = weightsPath;
+    }
+
+    if (!options.thresholds.isEmpty()) {
+        const QVector<CrossingEvent> events = CrossingSolver::crossings(project.channels, options.thresholds);
+        const QString eventsPath = CrossingSolver::eventTablePath(result.lutPath);
+        if (!CrossingSolver::writeEventTable(eventsPath, events, options.thresholds, &result.error)) {
+            return result;
+        }
+        result.eventsPath = eventsPath;
+        result.eventCount = events.size();
+    }
+
+    result.ok = true;
+    return result;
+}
+
+/**
+ * @brief Bakes projects in parallel. Results come back in the order of projectPaths.
+ * With an output directory, outputs are named by project base name only, so projects
+ * sharing one (from different folders) would write the same files; all of them fail
+ * before anything is baked.
+ */
+QVector<BakeResult> BatchBaker::bakeFiles(const QStringList& projectPaths, const BakeOptions& options)
+{
+    QVector<BakeResult> results(projectPaths.size());
+    QVector<bool> colliding(projectPaths.size(), false);
+    if (!options.outputDirectory.isEmpty()) {
+        QHash<QString, QVector<int>> byName;
+        for (int i = 0; i < projectPaths.size(); ++i) {
+            byName[QFileInfo(projectPaths[i]).completeBaseName().toLower()].append(i);
+        }
+        for (const QVector<int>& indices : std::as_const(byName)) {
+            if (indices.size() < 2) continue;
+            for (int i : indices) {
+                colliding[i] = true;
+                results[i].projectPath = projectPaths[i];
+                results[i].error = QStringLiteral("%1 other project(s) would write the same output files in %2")
+                                       .arg(indices.size() - 1).arg(options.outputDirectory);
+            }
+        }
+    }
+
+    BakeResult *output = results.data();
+    BakeService::parallelFor(projectPaths.size(), 1, [output, &projectPaths, &colliding, &options](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            if (!colliding[i]) output[i] = bakeFile(projectPaths[i], options);
+        }
+    }, BakeService::instance().pool());
+    return results;
+}
+
+QJsonObject BatchBaker::summaryJson(const QVector<BakeResult>& results)
+{
+    int baked = 0, failed = 0, events = 0;
+    QJsonArray projects;
+    for (const BakeResult& result : results) {
+        if (result.ok) ++baked; else ++failed;
+        events += result.eventCount;
+        projects.append(result.toJson());
+    }
+
+    QJsonObject root;
+    root["files"] = results.size();
+    root["baked"] = baked;
+    root["failed"] = failed;
+    root["events"] = events;
+    root["projects"] = projects;
+    return root;
+}
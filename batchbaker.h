@@ -0,0 +1,68 @@
+#ifndef BATCHBAKER_H
+#define BATCHBAKER_H
+
+// Qt Includes
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Project Includes
+#include "lutexport.h" // Required for FrameTiming
+#include "objmesh.h"
+
+/**
+ * @brief What to bake besides each project's LUT. Output goes to outputDirectory,
+ * or next to each project if it is empty.
+ */
+struct BakeOptions {
+    QString outputDirectory;
+    QVector<qreal> thresholds;  // Crossing events are exported if not empty.
+    bool bakeFrames = false;    // Also write a frame strip and frame table for frames.
+    FrameTiming frames;
+    QString variants;           // LutExport::parseTargets() list of extra widths/bit depths, e.g. "64, 1024:16".
+    ObjMesh weightsMesh;
+    QVector<float> vertexWeights;   // VertexWeights::compute() of weightsMesh, written next to each LUT if not empty.
+};
+
+/**
+ * @brief Outcome of baking one project. lutPath/eventsPath are empty if not written.
+ */
+struct BakeResult {
+    QString projectPath;
+    QString lutPath;
+    QString eventsPath;
+    QString framesPath;
+    QString frameTablePath;
+    QStringList variantPaths;
+    QString weightsPath;
+    int width = 0;
+    int bitDepth = 0;
+    QString content;
+    int eventCount = 0;
+    bool ok = false;
+    QString error;
+
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief Headless LUT baking for many projects at once, used by `--bake`.
+ *
+ * Each project is baked with the LUT width, bit depth and content stored in its settings
+ * and, if thresholds are given, gets a sorted threshold-crossing event table
+ * (`<name>.events.json`) next to its LUT. With frame timing, a frame-exact strip
+ * (`<name>.frames.png`) and table (`<name>.frames.csv`) are written as well, and
+ * extra variants (`<name>_<width>.png`) come from one merged walk per project.
+ * Precomputed vertex weights are written alongside as `<name>.weights.png`.
+ * Projects are processed in parallel on the shared BakeService pool.
+ */
+class BatchBaker
+{
+public:
+    static BakeResult bakeFile(const QString& projectPath, const BakeOptions& options);
+    static QVector<BakeResult> bakeFiles(const QStringList& projectPaths, const BakeOptions& options);
+    static QJsonObject summaryJson(const QVector<BakeResult>& results);
+};
+
+#endif
@@ -0,0 +1,234 @@
+#include "crossingsolver.h"
+#include "curveproject.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QtMath>
+
+#include <algorithm>
+#include <cmath>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+// How far to either side of a root the curve is probed to tell crossings from touches.
+const qreal SIDE_PROBE = 1e-6;
+
+inline int sign(qreal v) {
+    return (v > 0.0) - (v < 0.0);
+}
+
+}
+
+/**
+ * @brief Real roots of a t^3 + b t^2 + c t + d in [0, 1], ascending and without
+ * duplicates. Falls back to the quadratic or linear case when the leading terms
+ * vanish; each root is polished with Newton steps on the original polynomial.
+ * @return Number of roots written (0 for the all-zero polynomial).
+ */
+int CrossingSolver::solveCubic01(qreal a, qreal b, qreal c, qreal d, qreal roots[3])
+{
+    const qreal scale = std::max({ std::abs(a), std::abs(b), std::abs(c), std::abs(d) });
+    if (scale == 0.0) return 0;
+    const qreal eps = 1e-12 * scale;
+
+    qreal found[3];
+    int count = 0;
+    if (std::abs(a) <= eps) {
+        if (std::abs(b) <= eps) {
+            if (std::abs(c) > eps) found[count++] = -d / c;
+        } else {
+            const qreal discriminant = c * c - 4.0 * b * d;
+            if (discriminant >= 0.0) {
+                const qreal q = -0.5 * (c + std::copysign(std::sqrt(discriminant), c));
+                found[count++] = q / b;
+                if (std::abs(q) > eps) found[count++] = d / q;
+            }
+        }
+    } else {
+        // Depressed cubic u^3 + p u + q = 0 with t = u - B / 3.
+        const qreal B = b / a, C = c / a, D = d / a;
+        const qreal p = C - B * B / 3.0;
+        const qreal q = 2.0 * B * B * B / 27.0 - B * C / 3.0 + D;
+        const qreal shift = -B / 3.0;
+        const qreal discriminant = q * q / 4.0 + p * p * p / 27.0;
+
+        if (discriminant > 0.0) {
+            const qreal root = std::sqrt(discriminant);
+            found[count++] = std::cbrt(-q / 2.0 + root) + std::cbrt(-q / 2.0 - root) + shift;
+        } else if (p == 0.0) {
+            found[count++] = shift;
+        } else {
+            // Three real roots: trigonometric form.
+            const qreal r = 2.0 * std::sqrt(-p / 3.0);
+            const qreal cosine = std::max(-1.0, std::min(1.0, 3.0 * q / (p * r)));
+            const qreal phi = std::acos(cosine) / 3.0;
+            for (int k = 0; k < 3; ++k) {
+                found[count++] = r * std::cos(phi - 2.0 * M_PI * k / 3.0) + shift;
+            }
+        }
+    }
+
+    int result = 0;
+    for (int i = 0; i < count; ++i) {
+        qreal t = found[i];
+        for (int iter = 0; iter < 2; ++iter) {
+            const qreal value = ((a * t + b) * t + c) * t + d;
+            const qreal slope = (3.0 * a * t + 2.0 * b) * t + c;
+            if (std::abs(slope) <= eps) break;
+            t -= value / slope;
+        }
+        if (t < -1e-9 || t > 1.0 + 1e-9) continue;
+        roots[result++] = std::max(0.0, std::min(1.0, t));
+    }
+    std::sort(roots, roots + result);
+    result = static_cast<int>(std::unique(roots, roots + result, [](qreal l, qreal r) { return r - l <= 1e-9; }) - roots);
+    return result;
+}
+
+/**
+ * @brief All crossings of one channel, sorted by x then threshold.
+ */
+QVector<CrossingEvent> CrossingSolver::channelCrossings(CurveWidget::ActiveChannel channel, const CurveSampler::NodeList& nodes,
+                                                        const QVector<qreal>& thresholds)
+{
+    QVector<CrossingEvent> events;
+    if (nodes.size() < 2) return events;
+
+    QVector<qreal> candidates;
+    for (qreal threshold : thresholds) {
+        candidates.clear();
+        for (int i = 0; i + 1 < nodes.size(); ++i) {
+            const CurveWidget::CurveNode& n0 = nodes[i];
+            const CurveWidget::CurveNode& n1 = nodes[i + 1];
+            const qreal y0 = n0.mainPoint.y(), y1 = n0.handleOut.y(), y2 = n1.handleIn.y(), y3 = n1.mainPoint.y();
+
+            // A vertical segment is a jump at its x.
+            if (std::abs(n1.mainPoint.x() - n0.mainPoint.x()) <= 1e-9) {
+                if ((y0 - threshold) * (y3 - threshold) < 0.0) candidates.append(n0.mainPoint.x());
+                continue;
+            }
+
+            qreal ts[3];
+            const int count = solveCubic01(-y0 + 3.0 * y1 - 3.0 * y2 + y3,
+                                           3.0 * y0 - 6.0 * y1 + 3.0 * y2,
+                                           -3.0 * y0 + 3.0 * y1,
+                                           y0 - threshold, ts);
+            for (int k = 0; k < count; ++k) {
+                candidates.append(CurveSampler::bezierComponent(n0.mainPoint.x(), n0.handleOut.x(), n1.handleIn.x(), n1.mainPoint.x(), ts[k]));
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end(), [](qreal l, qreal r) { return r - l <= 1e-9; }),
+                         candidates.end());
+
+        // Probing both sides at once keeps roots shared by neighbouring segments, and
+        // touches, from turning into events.
+        for (qreal x : std::as_const(candidates)) {
+            if (x < 0.0 || x > 1.0) continue;
+            const qreal probes[2] = { x - SIDE_PROBE, x + SIDE_PROBE };
+            qreal ys[2];
+            CurveSampler::sampleNodesSorted(nodes, probes, 2, ys, false);
+            const int before = sign(ys[0] - threshold);
+            const int after = sign(ys[1] - threshold);
+            if (before == after) continue;
+            events.append({ x, channel, threshold, after > before });
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const CrossingEvent& l, const CrossingEvent& r) {
+        return l.x != r.x ? l.x < r.x : l.threshold < r.threshold;
+    });
+    return events;
+}
+
+/**
+ * @brief Crossings of every channel in one table, sorted by x, then channel, then threshold.
+ */
+QVector<CrossingEvent> CrossingSolver::crossings(const CurveSampler::ChannelMap& channels, const QVector<qreal>& thresholds)
+{
+    QVector<CrossingEvent> events;
+    for (auto it = channels.constBegin(); it != channels.constEnd(); ++it) {
+        events += channelCrossings(it.key(), it.value(), thresholds);
+    }
+    std::stable_sort(events.begin(), events.end(), [](const CrossingEvent& l, const CrossingEvent& r) {
+        if (l.x != r.x) return l.x < r.x;
+        if (l.channel != r.channel) return l.channel < r.channel;
+        return l.threshold < r.threshold;
+    });
+    return events;
+}
+
+/**
+ * @brief Parses a comma or space separated list like "0.25, 0.5".
+ * @param ok - If not null, set to false when an entry is not a number.
+ */
+QVector<qreal> CrossingSolver::parseThresholds(const QString& text, bool *ok)
+{
+    QVector<qreal> thresholds;
+    bool allValid = true;
+    const QStringList parts = text.split(QRegularExpression("[,;\\s]+"), Qt::SkipEmptyParts);
+    for (const QString& part : parts) {
+        bool valid = false;
+        const qreal value = part.toDouble(&valid);
+        if (valid && std::isfinite(value)) {
+            thresholds.append(value);
+        } else {
+            allValid = false;
+        }
+    }
+    std::sort(thresholds.begin(), thresholds.end());
+    thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+    if (ok) *ok = allValid;
+    return thresholds;
+}
+
+QJsonObject CrossingSolver::eventsJson(const QVector<CrossingEvent>& events, const QVector<qreal>& thresholds)
+{
+    QJsonArray thresholdArray;
+    for (qreal threshold : thresholds) thresholdArray.append(threshold);
+
+    QJsonArray eventArray;
+    for (const CrossingEvent& event : events) {
+        QJsonObject obj;
+        obj["x"] = event.x;
+        obj["channel"] = CurveProject::channelName(event.channel);
+        obj["threshold"] = event.threshold;
+        obj["direction"] = event.rising ? "rising" : "falling";
+        eventArray.append(obj);
+    }
+
+    QJsonObject root;
+    root["thresholds"] = thresholdArray;
+    root["count"] = events.size();
+    root["events"] = eventArray;
+    return root;
+}
+
+bool CrossingSolver::writeEventTable(const QString& filePath, const QVector<CrossingEvent>& events,
+                                     const QVector<qreal>& thresholds, QString *errorMessage)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    if (file.write(QJsonDocument(eventsJson(events, thresholds)).toJson(QJsonDocument::Indented)) == -1 || !file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief "dir/name.png" -> "dir/name.events.json".
+ */
+QString CrossingSolver::eventTablePath(const QString& lutPath)
+{
+    const QFileInfo info(lutPath);
+    return info.dir().filePath(info.completeBaseName() + QStringLiteral(".events.json"));
+}
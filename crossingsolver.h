@@ -0,0 +1,45 @@
+#ifndef CROSSINGSOLVER_H
+#define CROSSINGSOLVER_H
+
+// Qt Includes
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+// Project Includes
+#include "curvesampler.h"
+
+/**
+ * @brief One place where a channel's curve crosses a threshold value.
+ */
+struct CrossingEvent {
+    qreal x = 0.0;          // Normalized time, the LUT's U coordinate.
+    CurveWidget::ActiveChannel channel = CurveWidget::ActiveChannel::RED;
+    qreal threshold = 0.0;
+    bool rising = true;     // true if y goes from below to above the threshold.
+};
+
+/**
+ * @brief Finds where curves cross threshold values, e.g. to fire gameplay events.
+ *
+ * Each segment's y(t) = threshold is solved as a cubic in closed form (no dense
+ * sampling), and the roots are mapped to x through the segment's x(t). Points where
+ * the curve only touches a threshold and turns back are not reported. Works on the
+ * unclamped curve, so thresholds of exactly 0 or 1 behave as expected.
+ */
+class CrossingSolver
+{
+public:
+    static int solveCubic01(qreal a, qreal b, qreal c, qreal d, qreal roots[3]);
+    static QVector<CrossingEvent> channelCrossings(CurveWidget::ActiveChannel channel, const CurveSampler::NodeList& nodes,
+                                                   const QVector<qreal>& thresholds);
+    static QVector<CrossingEvent> crossings(const CurveSampler::ChannelMap& channels, const QVector<qreal>& thresholds);
+
+    static QVector<qreal> parseThresholds(const QString& text, bool *ok = nullptr);
+    static QJsonObject eventsJson(const QVector<CrossingEvent>& events, const QVector<qreal>& thresholds);
+    static bool writeEventTable(const QString& filePath, const QVector<CrossingEvent>& events,
+                                const QVector<qreal>& thresholds, QString *errorMessage = nullptr);
+    static QString eventTablePath(const QString& lutPath);
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include "curvedeltacommand.h"
+#include "curvewidget.h"
+#include <QDebug>
+
+#include <algorithm>
+
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+/**
+ * @brief Same geometry and same identity.
+ */
+inline bool sameNode(const CurveWidget::CurveNode& a, const CurveWidget::CurveNode& b) {
+    return a.id == b.id && a == b;
+}
+
+/**
+ * @brief True if both lists hold the same node ids in the same order.
+ */
+bool sameIdOrder(const CurveDeltaCommand::NodeList& a, const CurveDeltaCommand::NodeList& b) {
+    if (a.size() != b.size()) return false;
+    for (int i = 0; i < a.size(); ++i) {
+        if (a[i].id != b[i].id || a[i].id == 0) return false;
+    }
+    return true;
+}
+
+}
+
+
+/**
+ * @brief Constructor implementation. Stores the widget pointer and copies the splices.
+ */
+CurveDeltaCommand::CurveDeltaCommand(CurveWidget *widget,
+                                     const QVector<Splice> &splices,
+                                     const QString &text,
+                                     QUndoCommand *parent)
+    : CurveDeltaCommand(widget, splices, QVector<NodeEdit>(), text, parent)
+{
+}
+
+CurveDeltaCommand::CurveDeltaCommand(CurveWidget *widget,
+                                     const QVector<Splice> &splices,
+                                     const QVector<NodeEdit> &edits,
+                                     const QString &text,
+                                     QUndoCommand *parent)
+    : QUndoCommand(text, parent),
+    m_curveWidget(widget),
+    m_splices(splices),
+    m_edits(edits),
+    m_skipNextRedo(false)
+{
+}
+
+/**
+ * @brief Executes the "undo" action: puts the "before" nodes back.
+ */
+void CurveDeltaCommand::undo()
+{
+    if (!m_curveWidget) {
+        qWarning() << "CurveDeltaCommand::undo() - CurveWidget pointer is null.";
+        return;
+    }
+    apply(false);
+    qDebug() << "Command undone:" << text();
+}
+
+/**
+ * @brief Executes the "redo" action: puts the "after" nodes in place.
+ */
+void CurveDeltaCommand::redo()
+{
+    if (m_skipNextRedo) {
+        m_skipNextRedo = false;
+        return;
+    }
+    if (!m_curveWidget) {
+        qWarning() << "CurveDeltaCommand::redo() - CurveWidget pointer is null.";
+        return;
+    }
+    apply(true);
+    qDebug() << "Command redone:" << text();
+}
+
+/**
+ * @brief Applies all changes forwards (splices, then node edits) or backwards (the exact reverse).
+ */
+void CurveDeltaCommand::apply(bool forward)
+{
+    const QVector<quint32> selectedIds = m_curveWidget->selectedNodeIds();
+
+    if (forward) {
+        for (const Splice &splice : m_splices) {
+            m_curveWidget->replaceNodeRange(splice.channel, splice.index, splice.before.size(), splice.after);
+        }
+        for (const NodeEdit &edit : m_edits) {
+            m_curveWidget->replaceNodeById(edit.channel, edit.after);
+        }
+    } else {
+        for (auto it = m_edits.crbegin(); it != m_edits.crend(); ++it) {
+            m_curveWidget->replaceNodeById(it->channel, it->before);
+        }
+        for (auto it = m_splices.crbegin(); it != m_splices.crend(); ++it) {
+            m_curveWidget->replaceNodeRange(it->channel, it->index, it->after.size(), it->before);
+        }
+    }
+
+    m_curveWidget->finishRestore(selectedIds);
+}
+
+/**
+ * @brief Sums the node storage held by all splices and edits plus the command itself.
+ */
+qsizetype CurveDeltaCommand::approximateMemoryUsage() const
+{
+    qsizetype bytes = sizeof(*this)
+                      + m_splices.capacity() * static_cast<qsizetype>(sizeof(Splice))
+                      + m_edits.capacity() * static_cast<qsizetype>(sizeof(NodeEdit));
+    for (const Splice &splice : m_splices) {
+        bytes += (splice.before.capacity() + splice.after.capacity()) * static_cast<qsizetype>(sizeof(CurveWidget::CurveNode));
+    }
+    return bytes;
+}
+
+/**
+ * @brief Builds the command that turns one full channel state into another, or
+ * returns nullptr if they are identical. Channels whose node order is unchanged
+ * become per-node edits; the rest become one splice each.
+ */
+CurveDeltaCommand* CurveDeltaCommand::fromStates(CurveWidget *widget, const ChannelMap &before, const ChannelMap &after,
+                                                 const QString &text)
+{
+    QVector<Splice> splices;
+    QVector<NodeEdit> edits;
+
+    QList<CurveWidget::ActiveChannel> channels = before.keys();
+    for (CurveWidget::ActiveChannel channel : after.keys()) {
+        if (!before.contains(channel)) channels.append(channel);
+    }
+
+    for (CurveWidget::ActiveChannel channel : channels) {
+        const NodeList oldNodes = before.value(channel);
+        const NodeList newNodes = after.value(channel);
+        if (oldNodes.constData() == newNodes.constData() && oldNodes.size() == newNodes.size()) continue;
+
+        if (sameIdOrder(oldNodes, newNodes)) {
+            for (int i = 0; i < oldNodes.size(); ++i) {
+                if (oldNodes[i] != newNodes[i]) edits.append({channel, oldNodes[i], newNodes[i]});
+            }
+        } else {
+            Splice splice = diff(channel, oldNodes, newNodes);
+            if (!isEmpty(splice)) splices.append(splice);
+        }
+    }
+
+    if (splices.isEmpty() && edits.isEmpty()) return nullptr;
+    return new CurveDeltaCommand(widget, splices, edits, text);
+}
+
+/**
+ * @brief Builds the splice covering everything between the common prefix and the
+ * common suffix of two node lists. Returns an empty splice if they are equal.
+ */
+CurveDeltaCommand::Splice CurveDeltaCommand::diff(CurveWidget::ActiveChannel channel, const NodeList &before, const NodeList &after)
+{
+    const int shorter = std::min(before.size(), after.size());
+
+    int prefix = 0;
+    while (prefix < shorter && sameNode(before[prefix], after[prefix])) ++prefix;
+
+    int suffix = 0;
+    while (suffix < shorter - prefix &&
+           sameNode(before[before.size() - 1 - suffix], after[after.size() - 1 - suffix])) {
+        ++suffix;
+    }
+
+    Splice splice;
+    splice.channel = channel;
+    splice.index = prefix;
+    splice.before = before.mid(prefix, before.size() - prefix - suffix);
+    splice.after = after.mid(prefix, after.size() - prefix - suffix);
+    return splice;
+}
@@ -0,0 +1,92 @@
+#ifndef CURVEDELTACOMMAND_H
+#define CURVEDELTACOMMAND_H
+
+// Qt Includes
+#include <QUndoCommand>
+#include <QMap>
+#include <QVector>
+#include <QString>
+
+// Project Includes
+#include "curvewidget.h" // Required for CurveWidget::ActiveChannel, CurveWidget::CurveNode
+
+/**
+ * @brief An undo command that stores only what changed instead of full snapshots
+ * of every channel.
+ *
+ * Edits that keep a channel's node order are stored per node and addressed by
+ * node id. Structural edits (insert, delete, reorder) are stored as splices:
+ * each replaces before.size() nodes starting at index with after (redo), or the
+ * reverse (undo). The widget keeps its selection across both, by node id.
+ */
+class CurveDeltaCommand : public QUndoCommand
+{
+public:
+    using NodeList = QVector<CurveWidget::CurveNode>;
+    using ChannelMap = QMap<CurveWidget::ActiveChannel, NodeList>;
+
+    /**
+     * @brief One contiguous replacement inside a channel's node list.
+     */
+    struct Splice {
+        CurveWidget::ActiveChannel channel = CurveWidget::ActiveChannel::RED;
+        int index = 0;
+        NodeList before;
+        NodeList after;
+    };
+
+    /**
+     * @brief One node changed in place, found by its id (before.id == after.id).
+     */
+    struct NodeEdit {
+        CurveWidget::ActiveChannel channel = CurveWidget::ActiveChannel::RED;
+        CurveWidget::CurveNode before;
+        CurveWidget::CurveNode after;
+    };
+
+    /**
+     * @brief Constructor for the command.
+     * @param widget - Pointer to the CurveWidget whose nodes are being changed.
+     * @param splices - The replacements, applied in order on redo and in reverse on undo.
+     * @param text - Optional description for the undo/redo action.
+     * @param parent - Optional parent command (usually nullptr).
+     */
+    CurveDeltaCommand(CurveWidget *widget,
+                      const QVector<Splice> &splices,
+                      const QString &text = "Modify Nodes",
+                      QUndoCommand *parent = nullptr);
+
+    CurveDeltaCommand(CurveWidget *widget,
+                      const QVector<Splice> &splices,
+                      const QVector<NodeEdit> &edits,
+                      const QString &text = "Modify Nodes",
+                      QUndoCommand *parent = nullptr);
+
+    void undo() override;
+    void redo() override;
+
+    /**
+     * @brief Makes the next redo() a no-op, for edits already applied to the widget before pushing.
+     */
+    void markApplied() { m_skipNextRedo = true; }
+
+    /**
+     * @brief Estimates the heap footprint of the stored changes in bytes.
+     */
+    qsizetype approximateMemoryUsage() const;
+
+    static CurveDeltaCommand* fromStates(CurveWidget *widget, const ChannelMap &before, const ChannelMap &after,
+                                         const QString &text = "Modify Nodes");
+    static Splice diff(CurveWidget::ActiveChannel channel, const NodeList &before, const NodeList &after);
+    static bool isEmpty(const Splice &splice) { return splice.before.isEmpty() && splice.after.isEmpty(); }
+
+private:
+    void apply(bool forward);
+
+    CurveWidget* m_curveWidget;
+    QVector<Splice> m_splices;
+    QVector<NodeEdit> m_edits;
+    bool m_skipNextRedo;
+};
+
+#endif
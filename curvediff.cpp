@@ -0,0 +1,354 @@
+#include "curvediff.h"
+#include "curvesampler.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QSet>
+
+#include <algorithm>
+#include <cmath>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+const qreal MATCH_TOLERANCE_X = 1e-6;
+
+QJsonObject nodeToJson(const CurveWidget::CurveNode& node)
+{
+    QJsonObject obj;
+    obj["main"] = QJsonArray({node.mainPoint.x(), node.mainPoint.y()});
+    obj["in"]   = QJsonArray({node.handleIn.x(), node.handleIn.y()});
+    obj["out"]  = QJsonArray({node.handleOut.x(), node.handleOut.y()});
+    obj["align"] = static_cast<int>(node.alignment);
+    if (node.id != 0) obj["id"] = static_cast<qint64>(node.id);
+    return obj;
+}
+
+/**
+ * @brief One side's edit relative to the base, with the x range of curve it affects.
+ */
+struct Edit {
+    enum class Kind { Modified, Removed, Added };
+
+    Kind kind = Kind::Modified;
+    int baseIndex = -1;             // -1 for Added.
+    CurveWidget::CurveNode node;    // New node for Modified/Added.
+    qreal lo = 0.0;
+    qreal hi = 0.0;
+
+    bool sameAs(const Edit& other) const
+    {
+        if (kind != other.kind || baseIndex != other.baseIndex) return false;
+        return kind == Kind::Removed || node == other.node;
+    }
+
+    bool overlaps(const Edit& other) const
+    {
+        return lo < other.hi && other.lo < hi;
+    }
+};
+
+/**
+ * @brief Lists the edits turning base into side. A node edit changes the segments on
+ * both sides of it, so its range spans from the previous to the next node.
+ */
+QVector<Edit> collectEdits(const CurveDiff::NodeList& base, const CurveDiff::NodeList& side)
+{
+    QVector<Edit> edits;
+    const QVector<QPair<int, int>> matches = CurveDiff::matchNodes(base, side);
+    QVector<int> sideMatched(side.size(), -1);
+    for (const auto& match : matches) sideMatched[match.second] = match.first;
+
+    auto neighbourRange = [](const CurveDiff::NodeList& nodes, int index, qreal& lo, qreal& hi) {
+        lo = nodes[std::max(0, index - 1)].mainPoint.x();
+        hi = nodes[std::min(static_cast<int>(nodes.size()) - 1, index + 1)].mainPoint.x();
+    };
+
+    QVector<int> baseMatched(base.size(), -1);
+    for (const auto& match : matches) baseMatched[match.first] = match.second;
+
+    for (int i = 0; i < base.size(); ++i) {
+        const int j = baseMatched[i];
+        if (j >= 0 && base[i] == side[j]) continue;
+
+        Edit edit;
+        edit.baseIndex = i;
+        neighbourRange(base, i, edit.lo, edit.hi);
+        if (j >= 0) {
+            edit.kind = Edit::Kind::Modified;
+            edit.node = side[j];
+            qreal lo, hi;
+            neighbourRange(side, j, lo, hi);
+            edit.lo = std::min(edit.lo, lo);
+            edit.hi = std::max(edit.hi, hi);
+        } else {
+            edit.kind = Edit::Kind::Removed;
+        }
+        edits.append(edit);
+    }
+
+    for (int j = 0; j < side.size(); ++j) {
+        if (sideMatched[j] >= 0) continue;
+        Edit edit;
+        edit.kind = Edit::Kind::Added;
+        edit.node = side[j];
+        neighbourRange(side, j, edit.lo, edit.hi);
+        edits.append(edit);
+    }
+    return edits;
+}
+
+}
+
+/**
+ * @brief Pairs nodes of two versions of a channel: first by id (when both carry one),
+ * then the rest by equal x (within 1e-6), in order.
+ * @return (index in from, index in to) pairs.
+ */
+QVector<QPair<int, int>> CurveDiff::matchNodes(const NodeList& from, const NodeList& to)
+{
+    QVector<QPair<int, int>> matches;
+    QVector<bool> fromUsed(from.size(), false);
+    QVector<bool> toUsed(to.size(), false);
+
+    QHash<quint32, int> toById;
+    for (int j = 0; j < to.size(); ++j) {
+        if (to[j].id != 0) toById.insert(to[j].id, j);
+    }
+    for (int i = 0; i < from.size(); ++i) {
+        if (from[i].id == 0) continue;
+        const int j = toById.value(from[i].id, -1);
+        if (j >= 0 && !toUsed[j]) {
+            matches.append({i, j});
+            fromUsed[i] = toUsed[j] = true;
+        }
+    }
+
+    // Both lists are sorted by x, so the remaining nodes pair up in one merge pass.
+    int i = 0, j = 0;
+    while (i < from.size() && j < to.size()) {
+        if (fromUsed[i]) { ++i; continue; }
+        if (toUsed[j]) { ++j; continue; }
+        const qreal dx = from[i].mainPoint.x() - to[j].mainPoint.x();
+        if (std::abs(dx) <= MATCH_TOLERANCE_X) {
+            matches.append({i, j});
+            fromUsed[i] = toUsed[j] = true;
+            ++i; ++j;
+        } else if (dx < 0.0) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+/**
+ * @brief Diffs one channel and measures the largest difference of the two curves over
+ * DeviationSamples evenly spaced x values, using the batch sampler.
+ */
+CurveDiff::ChannelDiff CurveDiff::diffChannel(CurveWidget::ActiveChannel channel, const NodeList& from, const NodeList& to)
+{
+    ChannelDiff diff;
+    diff.channel = channel;
+
+    const QVector<QPair<int, int>> matches = matchNodes(from, to);
+    QVector<bool> fromMatched(from.size(), false);
+    QVector<bool> toMatched(to.size(), false);
+    for (const auto& match : matches) {
+        fromMatched[match.first] = toMatched[match.second] = true;
+        if (from[match.first] != to[match.second]) diff.modified.append(match);
+    }
+    for (int i = 0; i < from.size(); ++i) if (!fromMatched[i]) diff.removed.append(i);
+    for (int j = 0; j < to.size(); ++j) if (!toMatched[j]) diff.added.append(j);
+
+    if (diff.isEmpty()) return diff;
+
+    QVector<qreal> xs(DeviationSamples);
+    for (int k = 0; k < DeviationSamples; ++k) xs[k] = static_cast<qreal>(k) / (DeviationSamples - 1);
+    QVector<qreal> ysFrom(DeviationSamples), ysTo(DeviationSamples);
+    CurveSampler::sampleNodesSorted(from, xs.constData(), DeviationSamples, ysFrom.data());
+    CurveSampler::sampleNodesSorted(to, xs.constData(), DeviationSamples, ysTo.data());
+    for (int k = 0; k < DeviationSamples; ++k) {
+        const qreal deviation = std::abs(ysTo[k] - ysFrom[k]);
+        if (deviation > diff.maxDeviation) {
+            diff.maxDeviation = deviation;
+            diff.maxDeviationX = xs[k];
+        }
+    }
+    return diff;
+}
+
+/**
+ * @brief The machine-readable diff of two projects, one entry per channel.
+ */
+QJsonObject CurveDiff::diffJson(const CurveProject::ProjectData& from, const CurveProject::ProjectData& to)
+{
+    QJsonArray channelArray;
+    bool identical = true;
+    for (auto it = from.channels.constBegin(); it != from.channels.constEnd(); ++it) {
+        const NodeList toNodes = to.channels.value(it.key());
+        const ChannelDiff diff = diffChannel(it.key(), it.value(), toNodes);
+        identical = identical && diff.isEmpty();
+
+        QJsonObject channelObj;
+        channelObj["channel"] = CurveProject::channelName(it.key());
+        QJsonArray added, removed, modified;
+        for (int j : diff.added) {
+            QJsonObject entry;
+            entry["index"] = j;
+            entry["node"] = nodeToJson(toNodes[j]);
+            added.append(entry);
+        }
+        for (int i : diff.removed) {
+            QJsonObject entry;
+            entry["index"] = i;
+            entry["node"] = nodeToJson(it.value()[i]);
+            removed.append(entry);
+        }
+        for (const auto& pair : diff.modified) {
+            QJsonObject entry;
+            entry["old_index"] = pair.first;
+            entry["new_index"] = pair.second;
+            entry["old"] = nodeToJson(it.value()[pair.first]);
+            entry["new"] = nodeToJson(toNodes[pair.second]);
+            modified.append(entry);
+        }
+        channelObj["added"] = added;
+        channelObj["removed"] = removed;
+        channelObj["modified"] = modified;
+        channelObj["max_deviation"] = diff.maxDeviation;
+        channelObj["max_deviation_x"] = diff.maxDeviationX;
+        channelArray.append(channelObj);
+    }
+
+    QJsonArray settingsChanged;
+    const QJsonObject settingsFrom = CurveProject::toJson({}, from.settings).value("settings").toObject();
+    const QJsonObject settingsTo = CurveProject::toJson({}, to.settings).value("settings").toObject();
+    for (auto it = settingsFrom.constBegin(); it != settingsFrom.constEnd(); ++it) {
+        if (settingsTo.value(it.key()) != it.value()) settingsChanged.append(it.key());
+    }
+
+    QJsonObject root;
+    root["identical"] = identical && settingsChanged.isEmpty();
+    root["channels"] = channelArray;
+    root["settings_changed"] = settingsChanged;
+    return root;
+}
+
+/**
+ * @brief Three-way merge of one channel.
+ * @param merged - Receives the merged nodes, or ours on conflict.
+ * @param conflict - If not null, receives a description when the edits overlap.
+ * @return false if both sides made different edits to overlapping x ranges.
+ */
+bool CurveDiff::mergeChannel(const NodeList& base, const NodeList& ours, const NodeList& theirs,
+                             NodeList& merged, QString *conflict)
+{
+    const QVector<Edit> ourEdits = collectEdits(base, ours);
+    const QVector<Edit> theirEdits = collectEdits(base, theirs);
+
+    // Edits made identically on both sides are applied once and never conflict, not
+    // even with the other side's neighbouring edits; only the rest is checked for overlap.
+    QVector<Edit> ourOwn;
+    QVector<Edit> theirOwn;
+    for (const Edit& ourEdit : ourEdits) {
+        const bool shared = std::any_of(theirEdits.cbegin(), theirEdits.cend(),
+                                        [&ourEdit](const Edit& theirEdit) { return theirEdit.sameAs(ourEdit); });
+        if (!shared) ourOwn.append(ourEdit);
+    }
+    for (const Edit& theirEdit : theirEdits) {
+        const bool shared = std::any_of(ourEdits.cbegin(), ourEdits.cend(),
+                                        [&theirEdit](const Edit& ourEdit) { return theirEdit.sameAs(ourEdit); });
+        if (!shared) theirOwn.append(theirEdit);
+    }
+
+    for (const Edit& theirEdit : std::as_const(theirOwn)) {
+        for (const Edit& ourEdit : std::as_const(ourOwn)) {
+            if (theirEdit.overlaps(ourEdit)) {
+                if (conflict) {
+                    *conflict = QString("edits overlap in x [%1, %2]")
+                                    .arg(std::max(theirEdit.lo, ourEdit.lo))
+                                    .arg(std::min(theirEdit.hi, ourEdit.hi));
+                }
+                merged = ours;
+                return false;
+            }
+        }
+    }
+    const QVector<Edit> applied = ourEdits + theirOwn;
+
+    NodeList result;
+    QVector<bool> removed(base.size(), false);
+    NodeList replaced = base;
+    for (const Edit& edit : std::as_const(applied)) {
+        switch (edit.kind) {
+        case Edit::Kind::Modified: replaced[edit.baseIndex] = edit.node; break;
+        case Edit::Kind::Removed:  removed[edit.baseIndex] = true; break;
+        case Edit::Kind::Added:    result.append(edit.node); break;
+        }
+    }
+    for (int i = 0; i < base.size(); ++i) {
+        if (!removed[i]) result.append(replaced[i]);
+    }
+    std::stable_sort(result.begin(), result.end(), [](const CurveWidget::CurveNode& a, const CurveWidget::CurveNode& b) {
+        return a.mainPoint.x() < b.mainPoint.x();
+    });
+
+    // Both sides may have handed out the same new id.
+    QSet<quint32> seenIds;
+    for (CurveWidget::CurveNode& node : result) {
+        if (node.id == 0) continue;
+        if (seenIds.contains(node.id)) node.id = 0; else seenIds.insert(node.id);
+    }
+
+    merged = result;
+    return true;
+}
+
+/**
+ * @brief Merges whole projects. Settings merge field by field; a field both sides
+ * changed differently keeps ours and is reported as a conflict.
+ */
+CurveDiff::MergeResult CurveDiff::merge(const CurveProject::ProjectData& base, const CurveProject::ProjectData& ours,
+                                        const CurveProject::ProjectData& theirs)
+{
+    MergeResult result;
+    for (auto it = base.channels.constBegin(); it != base.channels.constEnd(); ++it) {
+        NodeList merged;
+        QString conflict;
+        if (mergeChannel(it.value(), ours.channels.value(it.key()), theirs.channels.value(it.key()), merged, &conflict)) {
+            ++result.mergedChannels;
+        } else {
+            result.conflicts.append(QString("Channel %1: %2").arg(CurveProject::channelName(it.key()), conflict));
+        }
+        result.channels.insert(it.key(), merged);
+    }
+    CurveProject::assignMissingIds(result.channels);
+
+    auto mergeField = [&result](const char *name, auto baseValue, auto ourValue, auto theirValue) {
+        if (ourValue != baseValue && theirValue != baseValue && ourValue != theirValue) {
+            result.conflicts.append(QString("Setting %1 changed on both sides; keeping ours").arg(name));
+            return ourValue;
+        }
+        return (ourValue != baseValue) ? ourValue : theirValue;
+    };
+    result.settings.lutWidth = mergeField("lut_width", base.settings.lutWidth, ours.settings.lutWidth, theirs.settings.lutWidth);
+    result.settings.exportBitDepth = mergeField("export_bit_depth", base.settings.exportBitDepth, ours.settings.exportBitDepth, theirs.settings.exportBitDepth);
+    result.settings.lutContent = mergeField("lut_content", base.settings.lutContent, ours.settings.lutContent, theirs.settings.lutContent);
+    result.settings.previewRgbCombined = mergeField("preview_rgb_combined", base.settings.previewRgbCombined, ours.settings.previewRgbCombined, theirs.settings.previewRgbCombined);
+    result.settings.drawInactive = mergeField("draw_inactive", base.settings.drawInactive, ours.settings.drawInactive, theirs.settings.drawInactive);
+    result.settings.clampHandles = mergeField("clamp_handles", base.settings.clampHandles, ours.settings.clampHandles, theirs.settings.clampHandles);
+    return result;
+}
+
+QJsonObject CurveDiff::mergeJson(const MergeResult& result)
+{
+    QJsonObject root;
+    root["clean"] = result.conflicts.isEmpty();
+    root["merged_channels"] = result.mergedChannels;
+    root["conflicts"] = QJsonArray::fromStringList(result.conflicts);
+    return root;
+}
@@ -0,0 +1,65 @@
+#ifndef CURVEDIFF_H
+#define CURVEDIFF_H
+
+// Qt Includes
+#include <QJsonObject>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Project Includes
+#include "curveproject.h"
+
+/**
+ * @brief Semantic diff and three-way merge of curve projects.
+ *
+ * Nodes are matched by id where both sides carry one (format 1.2) and otherwise by
+ * x position. Diffs report added, removed and modified nodes per channel plus the
+ * largest difference of the sampled curves. Merges apply both sides' edits to the
+ * base as long as they touch disjoint x ranges of a channel; a channel whose edits
+ * overlap is reported as a conflict and keeps "ours".
+ */
+class CurveDiff
+{
+public:
+    using NodeList = QVector<CurveWidget::CurveNode>;
+
+    /**
+     * @brief Node level changes of one channel between two versions.
+     */
+    struct ChannelDiff {
+        CurveWidget::ActiveChannel channel = CurveWidget::ActiveChannel::RED;
+        QVector<int> added;                 // Indices into the new version.
+        QVector<int> removed;               // Indices into the old version.
+        QVector<QPair<int, int>> modified;  // (old index, new index)
+        qreal maxDeviation = 0.0;
+        qreal maxDeviationX = 0.0;
+
+        bool isEmpty() const { return added.isEmpty() && removed.isEmpty() && modified.isEmpty(); }
+    };
+
+    /**
+     * @brief Result of merge(). conflicts holds one readable line per conflicting channel or setting.
+     */
+    struct MergeResult {
+        CurveProject::ChannelMap channels;
+        ProjectSettings settings;
+        QStringList conflicts;
+        int mergedChannels = 0;
+    };
+
+    static QVector<QPair<int, int>> matchNodes(const NodeList& from, const NodeList& to);
+    static ChannelDiff diffChannel(CurveWidget::ActiveChannel channel, const NodeList& from, const NodeList& to);
+    static QJsonObject diffJson(const CurveProject::ProjectData& from, const CurveProject::ProjectData& to);
+
+    static bool mergeChannel(const NodeList& base, const NodeList& ours, const NodeList& theirs,
+                             NodeList& merged, QString *conflict = nullptr);
+    static MergeResult merge(const CurveProject::ProjectData& base, const CurveProject::ProjectData& ours,
+                             const CurveProject::ProjectData& theirs);
+    static QJsonObject mergeJson(const MergeResult& result);
+
+    static const int DeviationSamples = 4096;
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "curvefitter.h"
+
+#include <algorithm>
+#include <cmath>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+/**
+ * @brief Fritsch-Butland tangents at the knots: a weighted harmonic mean of the
+ * neighbouring slopes, 0 at local extrema, one-sided at the ends.
+ */
+QVector<qreal> knotTangents(const QVector<QPointF>& knots)
+{
+    const int n = knots.size();
+    QVector<qreal> slopes(n - 1);
+    for (int k = 0; k + 1 < n; ++k) {
+        slopes[k] = (knots[k + 1].y() - knots[k].y()) / (knots[k + 1].x() - knots[k].x());
+    }
+    QVector<qreal> tangents(n);
+    tangents[0] = slopes[0];
+    tangents[n - 1] = slopes[n - 2];
+    for (int k = 1; k + 1 < n; ++k) {
+        const qreal d0 = slopes[k - 1];
+        const qreal d1 = slopes[k];
+        if (d0 * d1 <= 0.0) {
+            tangents[k] = 0.0;
+            continue;
+        }
+        const qreal h0 = knots[k].x() - knots[k - 1].x();
+        const qreal h1 = knots[k + 1].x() - knots[k].x();
+        tangents[k] = 3.0 * (h0 + h1) / ((2.0 * h1 + h0) / d0 + (h1 + 2.0 * h0) / d1);
+    }
+    return tangents;
+}
+
+qreal hermite(const QPointF& p0, const QPointF& p1, qreal m0, qreal m1, qreal x)
+{
+    const qreal h = p1.x() - p0.x();
+    const qreal t = (x - p0.x()) / h;
+    const qreal t2 = t * t;
+    const qreal t3 = t2 * t;
+    return (2.0 * t3 - 3.0 * t2 + 1.0) * p0.y() + (t3 - 2.0 * t2 + t) * h * m0
+           + (-2.0 * t3 + 3.0 * t2) * p1.y() + (t3 - t2) * h * m1;
+}
+
+CurveWidget::CurveNode knotNode(const QVector<QPointF>& knots, const QVector<qreal>& tangents, int k)
+{
+    CurveWidget::CurveNode node(knots[k]);
+    node.alignment = CurveWidget::HandleAlignment::Aligned;
+    if (k > 0) {
+        const qreal h = (knots[k].x() - knots[k - 1].x()) / 3.0;
+        node.handleIn = QPointF(knots[k].x() - h, std::clamp(knots[k].y() - tangents[k] * h, 0.0, 1.0));
+    }
+    if (k + 1 < knots.size()) {
+        const qreal h = (knots[k + 1].x() - knots[k].x()) / 3.0;
+        node.handleOut = QPointF(knots[k].x() + h, std::clamp(knots[k].y() + tangents[k] * h, 0.0, 1.0));
+    }
+    if (k == 0 || k + 1 == knots.size()) node.alignment = CurveWidget::HandleAlignment::Free;
+    return node;
+}
+
+}
+
+/**
+ * @brief Fits ys, sampled at x = i / (ys.size() - 1), with at most maxNodes nodes.
+ * @param maxError - If not null, receives the largest remaining difference at the samples.
+ */
+CurveFitter::NodeList CurveFitter::fitSamples(const QVector<qreal>& ys, int maxNodes, qreal tolerance, qreal *maxError)
+{
+    const int count = ys.size();
+    if (count < 2) return NodeList();
+    const qreal step = 1.0 / (count - 1);
+    auto sampleAt = [&ys, step](int i) { return QPointF(i * step, std::clamp(ys[i], 0.0, 1.0)); };
+
+    QVector<int> knotIndices = { 0, count - 1 };
+    QVector<QPointF> knots = { sampleAt(0), sampleAt(count - 1) };
+    QVector<qreal> tangents = knotTangents(knots);
+    qreal worst = 0.0;
+
+    for (;;) {
+        // Walk the samples and knots together to find the worst fitted sample.
+        worst = 0.0;
+        int worstIndex = -1;
+        int segment = 0;
+        for (int i = 1; i + 1 < count; ++i) {
+            while (knotIndices[segment + 1] < i) ++segment;
+            if (knotIndices[segment + 1] == i) continue;
+            const qreal error = std::abs(hermite(knots[segment], knots[segment + 1], tangents[segment],
+                                                 tangents[segment + 1], i * step) - sampleAt(i).y());
+            if (error > worst) {
+                worst = error;
+                worstIndex = i;
+            }
+        }
+        if (worst <= tolerance || worstIndex < 0 || knots.size() >= std::max(2, maxNodes)) break;
+
+        const int position = std::upper_bound(knotIndices.cbegin(), knotIndices.cend(), worstIndex) - knotIndices.cbegin();
+        knotIndices.insert(position, worstIndex);
+        knots.insert(position, sampleAt(worstIndex));
+        tangents = knotTangents(knots);
+    }
+
+    if (maxError) *maxError = worst;
+    NodeList nodes;
+    nodes.reserve(knots.size());
+    for (int k = 0; k < knots.size(); ++k) nodes.append(knotNode(knots, tangents, k));
+    return nodes;
+}
+
+/**
+ * @brief Nodes that trace the polyline through points (ascending x, from 0 to 1)
+ * exactly, with handles at a third of each straight span.
+ */
+CurveFitter::NodeList CurveFitter::polylineNodes(const QVector<QPointF>& points)
+{
+    NodeList nodes;
+    for (int k = 0; k < points.size(); ++k) {
+        CurveWidget::CurveNode node(points[k]);
+        node.alignment = CurveWidget::HandleAlignment::Free;
+        if (k > 0) node.handleIn = points[k] + (points[k - 1] - points[k]) / 3.0;
+        if (k + 1 < points.size()) node.handleOut = points[k] + (points[k + 1] - points[k]) / 3.0;
+        nodes.append(node);
+    }
+    return nodes;
+}
@@ -0,0 +1,30 @@
+#ifndef CURVEFITTER_H
+#define CURVEFITTER_H
+
+// Qt Includes
+#include <QPointF>
+#include <QVector>
+
+// Project Includes
+#include "curvewidget.h" // Required for CurveWidget::CurveNode
+
+/**
+ * @brief Fits sampled y(x) tables with a few editable Bézier nodes.
+ *
+ * fitSamples() starts from the two end points and keeps adding a node at the sample
+ * with the largest error until the tolerance or the node budget is reached. Between
+ * nodes the curve is a cubic Hermite with Fritsch-Butland tangents, written as Bézier
+ * handles at a third of each span, so x(t) is linear (cheap, exact sampling) and
+ * monotonic data stays monotonic with handles inside the unit square.
+ */
+class CurveFitter
+{
+public:
+    using NodeList = QVector<CurveWidget::CurveNode>;
+
+    static NodeList fitSamples(const QVector<qreal>& ys, int maxNodes = 12, qreal tolerance = 1.0 / 512.0,
+                               qreal *maxError = nullptr);
+    static NodeList polylineNodes(const QVector<QPointF>& points);
+};
+
+#endif
@@ -0,0 +1,137 @@
+#include "curvelibrarydock.h"
+#include "curvelibrarymodel.h"
+
+#include <QDir>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QListView>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QShowEvent>
+#include <QVBoxLayout>
+
+CurveLibraryDock::CurveLibraryDock(QWidget *parent)
+    : QDockWidget(tr("Curve Library"), parent),
+    m_model(new CurveLibraryModel(this)),
+    m_view(nullptr),
+    m_statusLabel(nullptr),
+    m_scanRequested(false)
+{
+    setObjectName("curveLibraryDock");
+
+    QWidget *content = new QWidget(this);
+    QVBoxLayout *layout = new QVBoxLayout(content);
+    layout->setContentsMargins(4, 4, 4, 4);
+
+    QHBoxLayout *headerLayout = new QHBoxLayout();
+    m_statusLabel = new QLabel(content);
+    m_statusLabel->setTextInteractionFlags(Qt::NoTextInteraction);
+    QPushButton *browseButton = new QPushButton(tr("Folder..."), content);
+    headerLayout->addWidget(m_statusLabel, 1);
+    headerLayout->addWidget(browseButton);
+    layout->addLayout(headerLayout);
+
+    // Uniform, batched icon layout keeps the view cheap for libraries with thousands of
+    // entries: only the visible rows are asked for data, and so for thumbnails.
+    m_view = new QListView(content);
+    m_view->setViewMode(QListView::IconMode);
+    m_view->setResizeMode(QListView::Adjust);
+    m_view->setMovement(QListView::Static);
+    m_view->setUniformItemSizes(true);
+    m_view->setLayoutMode(QListView::Batched);
+    m_view->setBatchSize(256);
+    m_view->setIconSize(CurveLibraryModel::thumbnailSize());
+    m_view->setGridSize(CurveLibraryModel::thumbnailSize() + QSize(28, 28));
+    m_view->setWordWrap(false);
+    m_view->setTextElideMode(Qt::ElideMiddle);
+    m_view->setModel(m_model);
+    layout->addWidget(m_view);
+
+    setWidget(content);
+
+    connect(browseButton, &QPushButton::clicked, this, &CurveLibraryDock::onBrowseClicked);
+    connect(m_view, &QListView::activated, this, &CurveLibraryDock::onItemActivated);
+    connect(m_model, &CurveLibraryModel::rowsInserted, this, &CurveLibraryDock::updateStatus);
+    connect(m_model, &CurveLibraryModel::modelReset, this, &CurveLibraryDock::updateStatus);
+    connect(m_model, &CurveLibraryModel::scanFinished, this, &CurveLibraryDock::updateStatus);
+    connect(m_view->verticalScrollBar(), &QScrollBar::valueChanged, this, &CurveLibraryDock::updateVisibleRows);
+    connect(m_view->verticalScrollBar(), &QScrollBar::rangeChanged, this, &CurveLibraryDock::updateVisibleRows);
+    updateStatus();
+}
+
+/**
+ * @brief Sets the library folder. Scans right away if the dock is visible, otherwise
+ * on first show.
+ */
+void CurveLibraryDock::setDirectory(const QString& directory)
+{
+    m_directory = directory;
+    m_scanRequested = false;
+    if (isVisible()) {
+        m_scanRequested = true;
+        m_model->setDirectory(m_directory);
+    }
+    updateStatus();
+    emit directoryChanged(m_directory);
+}
+
+QString CurveLibraryDock::directory() const
+{
+    return m_directory;
+}
+
+void CurveLibraryDock::showEvent(QShowEvent *event)
+{
+    QDockWidget::showEvent(event);
+    if (!m_scanRequested && !m_directory.isEmpty()) {
+        m_scanRequested = true;
+        m_model->setDirectory(m_directory);
+    }
+}
+
+void CurveLibraryDock::onBrowseClicked()
+{
+    const QString directory = QFileDialog::getExistingDirectory(this, tr("Choose Curve Library Folder"), m_directory);
+    if (!directory.isEmpty()) {
+        setDirectory(directory);
+    }
+}
+
+void CurveLibraryDock::onItemActivated(const QModelIndex& index)
+{
+    const QString filePath = index.data(CurveLibraryModel::FilePathRole).toString();
+    if (!filePath.isEmpty()) {
+        emit projectActivated(filePath);
+    }
+}
+
+void CurveLibraryDock::updateStatus()
+{
+    if (m_directory.isEmpty()) {
+        m_statusLabel->setText(tr("No folder chosen"));
+        return;
+    }
+    const QString folderName = QDir(m_directory).dirName();
+    const int count = m_model->rowCount();
+    m_statusLabel->setText(m_model->isScanning()
+                           ? tr("%1: scanning... %2").arg(folderName).arg(count)
+                           : tr("%1: %2 projects").arg(folderName).arg(count));
+    m_statusLabel->setToolTip(m_directory);
+}
+
+/**
+ * @brief Reports the rows in view to the model so it can drop queued thumbnails that
+ * scrolled away. The static icon layout fills fixed grid cells left to right, so the
+ * range follows from the scroll offset; one extra line is kept on either side.
+ */
+void CurveLibraryDock::updateVisibleRows()
+{
+    const QSize grid = m_view->gridSize();
+    const QRect viewport = m_view->viewport()->rect();
+    const int columns = qMax(1, viewport.width() / grid.width());
+    const int offset = m_view->verticalScrollBar()->value();
+    const int firstLine = qMax(0, offset / grid.height() - 1);
+    const int lastLine = (offset + viewport.height()) / grid.height() + 1;
+    m_model->setVisibleRows(firstLine * columns, (lastLine + 1) * columns - 1);
+}
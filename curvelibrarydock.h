@@ -0,0 +1,51 @@
+#ifndef CURVELIBRARYDOCK_H
+#define CURVELIBRARYDOCK_H
+
+// Qt Includes
+#include <QDockWidget>
+#include <QString>
+
+// Forward Declarations
+class CurveLibraryModel;
+class QLabel;
+class QListView;
+class QModelIndex;
+class QShowEvent;
+
+/**
+ * @brief Dock listing the curve projects of a folder as thumbnails.
+ * Double-clicking an entry emits projectActivated(). The folder is only scanned
+ * once the dock is first shown, so a hidden library costs nothing at startup.
+ */
+class CurveLibraryDock : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit CurveLibraryDock(QWidget *parent = nullptr);
+
+    void setDirectory(const QString& directory);
+    QString directory() const;
+
+signals:
+    void projectActivated(const QString& filePath);
+    void directoryChanged(const QString& directory);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void onBrowseClicked();
+    void onItemActivated(const QModelIndex& index);
+    void updateStatus();
+    void updateVisibleRows();
+
+private:
+    CurveLibraryModel *m_model;
+    QListView *m_view;
+    QLabel *m_statusLabel;
+    QString m_directory;
+    bool m_scanRequested;
+};
+
+#endif
@@ -0,0 +1,351 @@
+#include "curvelibrarymodel.h"
+#include "bakeservice.h"
+#include "curveproject.h"
+
+#include <QColor>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPen>
+#include <QStandardPaths>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+const int SCAN_BATCH_SIZE = 256;
+const int THUMBNAIL_SAMPLES = 48;
+const int MAX_THUMBNAIL_JOBS = 4;
+
+/**
+ * @brief Transparent image shown until a row's thumbnail is ready, so every row has
+ * the same decoration size from the start.
+ */
+const QImage& placeholderThumbnail()
+{
+    static const QImage placeholder = [] {
+        QImage image(CurveLibraryModel::thumbnailSize(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        return image;
+    }();
+    return placeholder;
+}
+
+}
+
+CurveLibraryModel::CurveLibraryModel(QObject *parent)
+    : QAbstractListModel(parent),
+    m_cacheDirectory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails"),
+    m_thumbnails(512),
+    m_runningThumbnails(0),
+    m_jobs(std::make_shared<JobState>()),
+    m_scanning(false)
+{
+}
+
+/**
+ * @brief Cancels the scan and any thumbnail jobs, then waits for the ones already
+ * running so none of them can reach a deleted model. Jobs still queued on the pool
+ * see the new generation and return without touching it.
+ */
+CurveLibraryModel::~CurveLibraryModel()
+{
+    ++m_jobs->generation;
+    QMutexLocker locker(&m_jobs->mutex);
+    while (m_jobs->running > 0) m_jobs->idle.wait(&m_jobs->mutex);
+}
+
+/**
+ * @brief Registers a job as running unless its generation is stale.
+ */
+bool CurveLibraryModel::JobState::enter(quint64 expected)
+{
+    QMutexLocker locker(&mutex);
+    if (generation.load() != expected) return false;
+    ++running;
+    return true;
+}
+
+void CurveLibraryModel::JobState::leave()
+{
+    QMutexLocker locker(&mutex);
+    if (--running == 0) idle.wakeAll();
+}
+
+/**
+ * @brief Clears the list and starts scanning directory (recursively) for projects.
+ */
+void CurveLibraryModel::setDirectory(const QString& directory)
+{
+    const quint64 generation = ++m_jobs->generation;
+
+    beginResetModel();
+    m_directory = directory;
+    m_entries.clear();
+    m_rowByPath.clear();
+    m_pendingThumbnails.clear();
+    m_queuedThumbnails.clear();
+    m_runningThumbnails = 0;
+    m_failedThumbnails.clear();
+    endResetModel();
+
+    if (directory.isEmpty() || !QDir(directory).exists()) {
+        m_scanning = false;
+        emit scanFinished(0);
+        return;
+    }
+
+    m_scanning = true;
+    std::shared_ptr<JobState> jobs = m_jobs;
+    BakeService::instance().pool()->start([this, directory, generation, jobs]() {
+        if (!jobs->enter(generation)) return;
+        QVector<Entry> batch;
+        batch.reserve(SCAN_BATCH_SIZE);
+        QDirIterator it(directory, {"*.json"}, QDir::Files | QDir::Readable, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            if (jobs->generation.load() != generation) {
+                jobs->leave();
+                return;
+            }
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            batch.append({info.absoluteFilePath(), info.completeBaseName(), info.size(),
+                          info.lastModified().toMSecsSinceEpoch()});
+            if (batch.size() == SCAN_BATCH_SIZE) {
+                QMetaObject::invokeMethod(this, [this, generation, batch]() {
+                    appendEntries(generation, batch);
+                }, Qt::QueuedConnection);
+                batch.clear();
+            }
+        }
+        QMetaObject::invokeMethod(this, [this, generation, batch]() {
+            appendEntries(generation, batch);
+            finishScan(generation);
+        }, Qt::QueuedConnection);
+        jobs->leave();
+    });
+}
+
+QString CurveLibraryModel::directory() const
+{
+    return m_directory;
+}
+
+bool CurveLibraryModel::isScanning() const
+{
+    return m_scanning;
+}
+
+/**
+ * @brief Tells the model which rows a view currently shows. Queued thumbnails for
+ * rows outside [first, last] are dropped; they are requested again if the view
+ * paints those rows later.
+ */
+void CurveLibraryModel::setVisibleRows(int first, int last)
+{
+    QVector<Entry> queued;
+    for (const Entry& entry : std::as_const(m_queuedThumbnails)) {
+        const int row = m_rowByPath.value(entry.filePath, -1);
+        if (row >= first && row <= last) {
+            queued.append(entry);
+        } else {
+            m_pendingThumbnails.remove(entry.filePath);
+        }
+    }
+    m_queuedThumbnails = queued;
+}
+
+int CurveLibraryModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+/**
+ * @brief Asking for a row's decoration is what schedules its thumbnail, so only rows
+ * the view lays out and paints ever cost a file read.
+ */
+QVariant CurveLibraryModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size()) return QVariant();
+    const Entry& entry = m_entries[index.row()];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return entry.name;
+    case Qt::ToolTipRole:
+    case FilePathRole:
+        return entry.filePath;
+    case Qt::DecorationRole:
+        if (const QImage *thumbnail = m_thumbnails.object(entry.filePath)) {
+            return *thumbnail;
+        }
+        requestThumbnail(entry);
+        return placeholderThumbnail();
+    default:
+        return QVariant();
+    }
+}
+
+QSize CurveLibraryModel::thumbnailSize()
+{
+    return QSize(72, 72);
+}
+
+/**
+ * @brief Draws the R, G and B curves into a new image. Uses no widgets, so it runs on
+ * worker threads.
+ */
+QImage CurveLibraryModel::renderThumbnail(const CurveSampler::ChannelMap& channels, const QSize& size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(QColor(0x2B, 0x2B, 0x2B));
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const QRectF area = QRectF(QPointF(0, 0), size).adjusted(4, 4, -4, -4);
+    painter.setPen(QPen(QColor(0x50, 0x50, 0x50), 1.0));
+    painter.drawRect(area);
+
+    const CurveSampler sampler(channels);
+    const struct { CurveWidget::ActiveChannel channel; QColor color; } layers[] = {
+        { CurveWidget::ActiveChannel::RED,   QColor(0xF0, 0x50, 0x50) },
+        { CurveWidget::ActiveChannel::GREEN, QColor(0x50, 0xD0, 0x60) },
+        { CurveWidget::ActiveChannel::BLUE,  QColor(0x50, 0x90, 0xF0) }
+    };
+
+    qreal ys[THUMBNAIL_SAMPLES];
+    for (const auto& layer : layers) {
+        sampler.sampleUniform(layer.channel, THUMBNAIL_SAMPLES, ys);
+        QPainterPath path;
+        for (int i = 0; i < THUMBNAIL_SAMPLES; ++i) {
+            const QPointF p(area.left() + area.width() * i / (THUMBNAIL_SAMPLES - 1.0),
+                            area.bottom() - area.height() * ys[i]);
+            if (i == 0) path.moveTo(p); else path.lineTo(p);
+        }
+        painter.setPen(QPen(layer.color, 1.5));
+        painter.drawPath(path);
+    }
+    painter.end();
+    return image;
+}
+
+/**
+ * @brief Cache file name for a project. Path, size and mtime are hashed together, so
+ * a lookup needs only the stat done by the scan and an edited file misses naturally.
+ */
+QString CurveLibraryModel::thumbnailCacheFile(const QString& cacheDirectory, const Entry& entry)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(entry.filePath.toUtf8());
+    hash.addData(QByteArray::number(entry.size));
+    hash.addData(QByteArray::number(entry.modifiedMsecs));
+    const QSize size = thumbnailSize();
+    hash.addData(QByteArray::number(size.width()) + 'x' + QByteArray::number(size.height()));
+    return cacheDirectory + '/' + QString::fromLatin1(hash.result().toHex()) + ".png";
+}
+
+/**
+ * @brief Queues a thumbnail for entry. At most MAX_THUMBNAIL_JOBS run on the pool at
+ * once, so a fast scroll through a large library cannot flood it.
+ */
+void CurveLibraryModel::requestThumbnail(const Entry& entry) const
+{
+    if (m_pendingThumbnails.contains(entry.filePath) || m_failedThumbnails.contains(entry.filePath)) return;
+    m_pendingThumbnails.insert(entry.filePath);
+    m_queuedThumbnails.append(entry);
+    startQueuedThumbnails();
+}
+
+void CurveLibraryModel::startQueuedThumbnails() const
+{
+    while (m_runningThumbnails < MAX_THUMBNAIL_JOBS && !m_queuedThumbnails.isEmpty()) {
+        startThumbnailJob(m_queuedThumbnails.takeFirst());
+    }
+}
+
+void CurveLibraryModel::startThumbnailJob(const Entry& entry) const
+{
+    ++m_runningThumbnails;
+
+    // data() is const, but the result is delivered to the model itself on the GUI thread.
+    CurveLibraryModel *self = const_cast<CurveLibraryModel*>(this);
+    const quint64 generation = m_jobs->generation.load();
+    std::shared_ptr<JobState> jobs = m_jobs;
+    const QString cacheDirectory = m_cacheDirectory;
+
+    BakeService::instance().pool()->start([self, entry, generation, jobs, cacheDirectory]() {
+        if (!jobs->enter(generation)) return;
+
+        const QString cacheFile = thumbnailCacheFile(cacheDirectory, entry);
+        QImage image;
+        if (!image.load(cacheFile, "PNG")) {
+            CurveSampler::ChannelMap channels;
+            QString errorMessage;
+            if (CurveProject::readChannelsFromFile(entry.filePath, channels, &errorMessage)) {
+                image = renderThumbnail(channels, thumbnailSize());
+                if (!QDir().mkpath(cacheDirectory) || !image.save(cacheFile, "PNG")) {
+                    qWarning() << "Could not write thumbnail cache file:" << cacheFile;
+                }
+            } else {
+                qWarning() << "Library: skipping" << entry.filePath << "-" << errorMessage;
+            }
+        }
+
+        QMetaObject::invokeMethod(self, [self, generation, entry, image]() {
+            self->storeThumbnail(generation, entry.filePath, image);
+        }, Qt::QueuedConnection);
+        jobs->leave();
+    });
+}
+
+void CurveLibraryModel::appendEntries(quint64 generation, const QVector<Entry>& entries)
+{
+    if (generation != m_jobs->generation.load() || entries.isEmpty()) return;
+
+    const int first = m_entries.size();
+    beginInsertRows(QModelIndex(), first, first + entries.size() - 1);
+    for (const Entry& entry : entries) {
+        m_rowByPath.insert(entry.filePath, m_entries.size());
+        m_entries.append(entry);
+    }
+    endInsertRows();
+}
+
+void CurveLibraryModel::finishScan(quint64 generation)
+{
+    if (generation != m_jobs->generation.load()) return;
+    m_scanning = false;
+    emit scanFinished(m_entries.size());
+}
+
+/**
+ * @brief Keeps a finished thumbnail, repaints its row and starts the next queued job.
+ * A null image marks a project that could not be read; it keeps the placeholder and
+ * is not retried.
+ */
+void CurveLibraryModel::storeThumbnail(quint64 generation, const QString& filePath, const QImage& image)
+{
+    if (generation != m_jobs->generation.load()) return;
+    m_pendingThumbnails.remove(filePath);
+    --m_runningThumbnails;
+    startQueuedThumbnails();
+
+    if (image.isNull()) {
+        m_failedThumbnails.insert(filePath);
+        return;
+    }
+    m_thumbnails.insert(filePath, new QImage(image));
+
+    const int row = m_rowByPath.value(filePath, -1);
+    if (row >= 0) {
+        const QModelIndex changed = index(row);
+        emit dataChanged(changed, changed, {Qt::DecorationRole});
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef CURVELIBRARYMODEL_H
+#define CURVELIBRARYMODEL_H
+
+// Qt Includes
+#include <QAbstractListModel>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+
+// Project Includes
+#include "curvesampler.h" // Required for CurveSampler::ChannelMap
+
+// Standard Library Includes
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief List model over the curve projects (`*.json`) below a directory.
+ *
+ * The directory is walked on the shared BakeService pool and rows arrive in
+ * batches, so the list is usable while a large library is still being scanned.
+ * Thumbnails are only requested for rows a view actually asks to paint. Each one
+ * is loaded from the on-disk thumbnail cache or rendered headlessly and written
+ * there, keyed by the file's path, size and modification time. Only a few thumbnail
+ * jobs run at once; the rest wait in the model and are dropped once their rows
+ * scroll out of view.
+ */
+class CurveLibraryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        FilePathRole = Qt::UserRole + 1
+    };
+
+    explicit CurveLibraryModel(QObject *parent = nullptr);
+    ~CurveLibraryModel();
+
+    void setDirectory(const QString& directory);
+    QString directory() const;
+    bool isScanning() const;
+    void setVisibleRows(int first, int last);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    static QSize thumbnailSize();
+    static QImage renderThumbnail(const CurveSampler::ChannelMap& channels, const QSize& size);
+
+signals:
+    void scanFinished(int projectCount);
+
+private:
+    struct Entry {
+        QString filePath;
+        QString name;
+        qint64 size = 0;
+        qint64 modifiedMsecs = 0;
+    };
+
+    /**
+     * @brief Shared with the model's pool jobs. The generation is bumped on every rescan
+     * and on destruction; jobs holding an older value stop early. Jobs that get past
+     * enter() are counted until leave(), so the destructor waits for those alone.
+     */
+    struct JobState {
+        std::atomic<quint64> generation{0};
+        QMutex mutex;
+        QWaitCondition idle;
+        int running = 0;
+
+        bool enter(quint64 expected);
+        void leave();
+    };
+
+    static QString thumbnailCacheFile(const QString& cacheDirectory, const Entry& entry);
+    void requestThumbnail(const Entry& entry) const;
+    void startQueuedThumbnails() const;
+    void startThumbnailJob(const Entry& entry) const;
+    void appendEntries(quint64 generation, const QVector<Entry>& entries);
+    void finishScan(quint64 generation);
+    void storeThumbnail(quint64 generation, const QString& filePath, const QImage& image);
+
+    QString m_directory;
+    QString m_cacheDirectory;
+    QVector<Entry> m_entries;
+    QHash<QString, int> m_rowByPath;
+    mutable QCache<QString, QImage> m_thumbnails;
+    mutable QSet<QString> m_pendingThumbnails;
+    mutable QVector<Entry> m_queuedThumbnails;
+    mutable int m_runningThumbnails;
+    QSet<QString> m_failedThumbnails;
+    std::shared_ptr<JobState> m_jobs;
+    bool m_scanning;
+};
+
+#endif
@@ -0,0 +1,332 @@
+#include "curveproject.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QList>
+#include <QPair>
+#include <QPointF>
+#include <QSaveFile>
+#include <QSet>
+#include <QString>
+
+#include <algorithm>
+#include <limits>
+
+const char *const CurveProject::FormatVersion = "1.2";
+
+/**
+ * @brief Returns the project key of a channel ("RED", "GREEN" or "BLUE"), or an
+ * empty string for an unknown channel.
+ */
+QString CurveProject::channelName(CurveWidget::ActiveChannel channel)
+{
+    switch (channel) {
+    case CurveWidget::ActiveChannel::RED:   return "RED";
+    case CurveWidget::ActiveChannel::GREEN: return "GREEN";
+    case CurveWidget::ActiveChannel::BLUE:  return "BLUE";
+    }
+    return QString();
+}
+
+/**
+ * @brief Serializes all channels into the project "channels" object
+ * (keys RED/GREEN/BLUE, each an array of {main, in, out, align, id} nodes).
+ */
+QJsonObject CurveProject::channelsToJson(const ChannelMap& channels)
+{
+    QJsonObject channelsObj;
+    for (auto it = channels.constBegin(); it != channels.constEnd(); ++it) {
+        CurveWidget::ActiveChannel channelKey = it.key();
+        const QVector<CurveWidget::CurveNode>& nodesVector = it.value();
+
+        const QString channelStringKey = channelName(channelKey);
+        if (channelStringKey.isEmpty()) {
+            qWarning() << "Skipping unknown channel key during save:" << static_cast<int>(channelKey);
+            continue;
+        }
+
+        QJsonArray nodesArray;
+        for (const CurveWidget::CurveNode& node : nodesVector) {
+            QJsonObject nodeObj;
+            nodeObj["main"] = QJsonArray({node.mainPoint.x(), node.mainPoint.y()});
+            nodeObj["in"]   = QJsonArray({node.handleIn.x(), node.handleIn.y()});
+            nodeObj["out"]  = QJsonArray({node.handleOut.x(), node.handleOut.y()});
+            nodeObj["align"] = static_cast<int>(node.alignment);
+            if (node.id != 0) nodeObj["id"] = static_cast<qint64>(node.id);
+            nodesArray.append(nodeObj);
+        }
+        channelsObj[channelStringKey] = nodesArray;
+    }
+    return channelsObj;
+}
+
+/**
+ * @brief Parses the project "channels" object. Gaps that older or hand-edited files
+ * have are repaired and reported through warnings instead of failing the load: a
+ * missing channel becomes a linear curve and a missing or unknown alignment becomes
+ * Free. Node ids (format 1.2) are kept; duplicates are dropped so they get reassigned.
+ * @param channelsObj - The JSON object holding the per-channel node arrays.
+ * @param channels - Receives the parsed nodes; only written on success.
+ * @param warnings - If not null, receives one line per repaired problem.
+ * @param errorMessage - If not null, receives the reason for a failure.
+ * @return false if a node is malformed beyond repair.
+ */
+bool CurveProject::channelsFromJson(const QJsonObject& channelsObj, ChannelMap& channels,
+                                    QStringList *warnings, QString *errorMessage)
+{
+    ChannelMap loadedChannelNodes;
+    QSet<quint32> seenIds;
+    auto warn = [warnings](const QString& message) {
+        if (warnings) warnings->append(message);
+    };
+    auto fail = [errorMessage](const QString& message) {
+        qWarning().noquote() << message;
+        if (errorMessage) *errorMessage = message;
+        return false;
+    };
+
+    const QList<QPair<QString, CurveWidget::ActiveChannel>> expectedChannels = {
+        {"RED", CurveWidget::ActiveChannel::RED},
+        {"GREEN", CurveWidget::ActiveChannel::GREEN},
+        {"BLUE", CurveWidget::ActiveChannel::BLUE}
+    };
+
+    for (auto it = channelsObj.constBegin(); it != channelsObj.constEnd(); ++it) {
+        if (it.key() != "RED" && it.key() != "GREEN" && it.key() != "BLUE") {
+            warn(QString("Unknown channel '%1' ignored").arg(it.key()));
+        }
+    }
+
+    for (const auto& pair : expectedChannels) {
+        const QString& channelStringKey = pair.first;
+        CurveWidget::ActiveChannel channelKey = pair.second;
+
+        if (!channelsObj.contains(channelStringKey) || !channelsObj[channelStringKey].isArray()) {
+            warn(QString("Channel %1 missing or not an array; using a linear curve").arg(channelStringKey));
+            loadedChannelNodes.insert(channelKey, defaultChannelNodes());
+            continue;
+        }
+
+        QJsonArray nodesArray = channelsObj[channelStringKey].toArray();
+        QVector<CurveWidget::CurveNode> nodesVector;
+        nodesVector.reserve(nodesArray.size());
+        int repairedAlignments = 0;
+
+        for (int i = 0; i < nodesArray.size(); ++i) {
+            const QJsonValue nodeVal = nodesArray[i];
+            if (!nodeVal.isObject()) {
+                return fail(QString("Channel %1, node %2: node is not an object").arg(channelStringKey).arg(i));
+            }
+            QJsonObject nodeObj = nodeVal.toObject();
+
+            auto extractPoint = [&](const QString& key, QPointF& point) -> bool {
+                if (!nodeObj.contains(key) || !nodeObj[key].isArray()) return false;
+                QJsonArray arr = nodeObj[key].toArray();
+                if (arr.size() != 2 || !arr[0].isDouble() || !arr[1].isDouble()) return false;
+                point.setX(arr[0].toDouble());
+                point.setY(arr[1].toDouble());
+                return true;
+            };
+
+            QPointF pMain, pIn, pOut;
+            if (!extractPoint("main", pMain) || !extractPoint("in", pIn) || !extractPoint("out", pOut)) {
+                return fail(QString("Channel %1, node %2: invalid point data").arg(channelStringKey).arg(i));
+            }
+
+            int alignInt = nodeObj.value("align").toInt(-1);
+            if (!nodeObj.value("align").isDouble() ||
+                alignInt < static_cast<int>(CurveWidget::HandleAlignment::Free) ||
+                alignInt > static_cast<int>(CurveWidget::HandleAlignment::Mirrored)) {
+                alignInt = static_cast<int>(CurveWidget::HandleAlignment::Free);
+                ++repairedAlignments;
+            }
+
+            CurveWidget::CurveNode node(pMain);
+            node.handleIn = pIn;
+            node.handleOut = pOut;
+            node.alignment = static_cast<CurveWidget::HandleAlignment>(alignInt);
+
+            const qint64 id = nodeObj.value("id").toInteger(0);
+            if (id > 0 && id <= std::numeric_limits<quint32>::max() && !seenIds.contains(static_cast<quint32>(id))) {
+                node.id = static_cast<quint32>(id);
+                seenIds.insert(node.id);
+            }
+            nodesVector.append(node);
+        }
+
+        if (repairedAlignments > 0) {
+            warn(QString("Channel %1: %2 node(s) without a valid alignment set to Free").arg(channelStringKey).arg(repairedAlignments));
+        }
+        loadedChannelNodes.insert(channelKey, nodesVector);
+    }
+
+    channels = loadedChannelNodes;
+    return true;
+}
+
+/**
+ * @brief The curve a new or reset channel starts with: a straight line from (0, 0) to (1, 1).
+ */
+QVector<CurveWidget::CurveNode> CurveProject::defaultChannelNodes()
+{
+    CurveWidget::CurveNode node0(QPointF(0.0, 0.0));
+    CurveWidget::CurveNode node1(QPointF(1.0, 1.0));
+    node0.handleOut = QPointF(1.0/3.0, 0.0);
+    node1.handleIn  = QPointF(2.0/3.0, 1.0);
+    node0.alignment = CurveWidget::HandleAlignment::Free;
+    node1.alignment = CurveWidget::HandleAlignment::Free;
+    return {node0, node1};
+}
+
+/**
+ * @brief Gives every node with id 0 a fresh id above the largest one in use, so a
+ * migrated file has ids on all nodes.
+ */
+void CurveProject::assignMissingIds(ChannelMap& channels)
+{
+    quint32 nextId = 1;
+    for (auto it = channels.cbegin(); it != channels.cend(); ++it) {
+        for (const CurveWidget::CurveNode& node : it.value()) {
+            nextId = std::max(nextId, node.id + 1);
+        }
+    }
+    for (auto it = channels.begin(); it != channels.end(); ++it) {
+        for (CurveWidget::CurveNode& node : it.value()) {
+            if (node.id == 0) node.id = nextId++;
+        }
+    }
+}
+
+/**
+ * @brief Parses a whole project document (version, settings and channels).
+ * @return false if the root has no usable "channels" object or a node is malformed.
+ */
+bool CurveProject::fromJson(const QJsonObject& rootObj, ProjectData& project, QString *errorMessage)
+{
+    ProjectData loaded;
+    loaded.formatVersion = rootObj.value("file_format_version").toString();
+    if (loaded.formatVersion.isEmpty()) {
+        loaded.formatVersion = "1.0";
+        loaded.warnings.append("No file_format_version; assuming 1.0");
+    } else if (compareVersions(loaded.formatVersion, FormatVersion) > 0) {
+        loaded.warnings.append(QString("File format %1 is newer than %2; unknown fields are ignored")
+                                   .arg(loaded.formatVersion, FormatVersion));
+    }
+
+    if (rootObj.value("settings").isObject()) {
+        const QJsonObject settingsObj = rootObj.value("settings").toObject();
+        ProjectSettings& settings = loaded.settings;
+        settings.lutWidth = settingsObj.value("lut_width").toInt(settings.lutWidth);
+        settings.exportBitDepth = settingsObj.value("export_bit_depth").toInt(settings.exportBitDepth);
+        settings.lutContent = settingsObj.value("lut_content").toString(settings.lutContent);
+        settings.previewRgbCombined = settingsObj.value("preview_rgb_combined").toBool(settings.previewRgbCombined);
+        settings.drawInactive = settingsObj.value("draw_inactive").toBool(settings.drawInactive);
+        settings.clampHandles = settingsObj.value("clamp_handles").toBool(settings.clampHandles);
+    } else {
+        loaded.warnings.append("Settings object missing; using defaults");
+    }
+
+    if (!rootObj.value("channels").isObject()) {
+        if (errorMessage) *errorMessage = QStringLiteral("Missing 'channels' object");
+        return false;
+    }
+    if (!channelsFromJson(rootObj.value("channels").toObject(), loaded.channels, &loaded.warnings, errorMessage)) {
+        return false;
+    }
+
+    project = loaded;
+    return true;
+}
+
+/**
+ * @brief Builds a project document in the current format.
+ */
+QJsonObject CurveProject::toJson(const ChannelMap& channels, const ProjectSettings& settings)
+{
+    QJsonObject rootObj;
+    rootObj["file_format_version"] = FormatVersion;
+
+    QJsonObject settingsObj;
+    settingsObj["lut_width"] = settings.lutWidth;
+    settingsObj["export_bit_depth"] = settings.exportBitDepth;
+    settingsObj["lut_content"] = settings.lutContent;
+    settingsObj["preview_rgb_combined"] = settings.previewRgbCombined;
+    settingsObj["draw_inactive"] = settings.drawInactive;
+    settingsObj["clamp_handles"] = settings.clampHandles;
+    rootObj["settings"] = settingsObj;
+
+    rootObj["channels"] = channelsToJson(channels);
+    return rootObj;
+}
+
+/**
+ * @brief Reads and parses a project file. Safe to call from worker threads.
+ * @param errorMessage - If not null, receives a description of the failure.
+ */
+bool CurveProject::readFile(const QString& filePath, ProjectData& project, QString *errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (errorMessage) *errorMessage = doc.isNull() ? parseError.errorString() : QStringLiteral("Root is not a JSON object");
+        return false;
+    }
+    return fromJson(doc.object(), project, errorMessage);
+}
+
+/**
+ * @brief Writes a project file in the current format. The old file is only replaced
+ * once the new one is completely written.
+ */
+bool CurveProject::writeFile(const QString& filePath, const ChannelMap& channels,
+                             const ProjectSettings& settings, QString *errorMessage)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    if (file.write(QJsonDocument(toJson(channels, settings)).toJson(QJsonDocument::Indented)) == -1 || !file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads only the channels of a project file. Safe to call from worker threads.
+ * @param errorMessage - If not null, receives a description of the failure.
+ * @return false if the file can't be read or has no valid "channels" object.
+ */
+bool CurveProject::readChannelsFromFile(const QString& filePath, ChannelMap& channels, QString *errorMessage)
+{
+    ProjectData project;
+    if (!readFile(filePath, project, errorMessage)) return false;
+    channels = project.channels;
+    return true;
+}
+
+/**
+ * @brief Compares "major.minor" version strings numerically.
+ * @return Negative, zero or positive like strcmp.
+ */
+int CurveProject::compareVersions(const QString& a, const QString& b)
+{
+    const QStringList partsA = a.split('.');
+    const QStringList partsB = b.split('.');
+    for (int i = 0; i < std::max(partsA.size(), partsB.size()); ++i) {
+        const int va = (i < partsA.size()) ? partsA[i].toInt() : 0;
+        const int vb = (i < partsB.size()) ? partsB[i].toInt() : 0;
+        if (va != vb) return (va < vb) ? -1 : 1;
+    }
+    return 0;
+}
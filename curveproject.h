@@ -0,0 +1,68 @@
+#ifndef CURVEPROJECT_H
+#define CURVEPROJECT_H
+
+// Qt Includes
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Project Includes
+#include "curvewidget.h" // Required for CurveWidget::ActiveChannel, CurveWidget::CurveNode
+
+/**
+ * @brief Editor settings stored next to the curves in a project file.
+ */
+struct ProjectSettings {
+    int lutWidth = 256;
+    int exportBitDepth = 8;
+    QString lutContent = "values"; // LutExport::contentName(): values, integral or integral_normalized.
+    bool previewRgbCombined = true;
+    bool drawInactive = false;
+    bool clampHandles = true;
+};
+
+/**
+ * @brief Serialization helpers shared by project files and recorded sessions.
+ * Converts the per-channel node map to and from the "channels" JSON object
+ * used by the `.json` project format, and reads/writes whole project files.
+ *
+ * Format history: 1.0 had no version field, 1.1 added it and the settings
+ * object, 1.2 stores node ids. Older files load and are written back as 1.2.
+ */
+class CurveProject
+{
+public:
+    using ChannelMap = QMap<CurveWidget::ActiveChannel, QVector<CurveWidget::CurveNode>>;
+
+    /**
+     * @brief A parsed project file plus what had to be repaired to load it.
+     */
+    struct ProjectData {
+        QString formatVersion;
+        ProjectSettings settings;
+        ChannelMap channels;
+        QStringList warnings;
+    };
+
+    static const char *const FormatVersion;
+
+    static QString channelName(CurveWidget::ActiveChannel channel);
+
+    static QJsonObject channelsToJson(const ChannelMap& channels);
+    static bool channelsFromJson(const QJsonObject& channelsObj, ChannelMap& channels,
+                                 QStringList *warnings = nullptr, QString *errorMessage = nullptr);
+    static QVector<CurveWidget::CurveNode> defaultChannelNodes();
+    static void assignMissingIds(ChannelMap& channels);
+
+    static QJsonObject toJson(const ChannelMap& channels, const ProjectSettings& settings);
+    static bool fromJson(const QJsonObject& rootObj, ProjectData& project, QString *errorMessage = nullptr);
+    static bool readFile(const QString& filePath, ProjectData& project, QString *errorMessage = nullptr);
+    static bool writeFile(const QString& filePath, const ChannelMap& channels,
+                          const ProjectSettings& settings, QString *errorMessage = nullptr);
+    static bool readChannelsFromFile(const QString& filePath, ChannelMap& channels, QString *errorMessage = nullptr);
+    static int compareVersions(const QString& a, const QString& b);
+};
+
+#endif
@@ -0,0 +1,315 @@
+#include "curvesampler.h"
+
+#include <QPointF>
+
+#include <algorithm>
+#include <cmath>
+
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+/**
+ * @brief Derivative of one coordinate of a cubic Bézier w.r.t. t.
+ */
+inline qreal bezierComponentDerivative(qreal p0, qreal p1, qreal p2, qreal p3, qreal t) {
+    qreal mt = 1.0 - t;
+    return 3.0 * mt * mt * (p1 - p0) + 6.0 * mt * t * (p2 - p1) + 3.0 * t * t * (p3 - p2);
+}
+
+inline qreal clamp01(qreal v) {
+    return std::max(0.0, std::min(1.0, v));
+}
+
+// 3-point Gauss-Legendre on [0, 1]; exact for polynomials up to degree 5, such as y(t) x'(t).
+const qreal GAUSS_T[3] = { 0.5 - 0.5 * 0.7745966692414834, 0.5, 0.5 + 0.5 * 0.7745966692414834 };
+const qreal GAUSS_W[3] = { 5.0 / 18.0, 8.0 / 18.0, 5.0 / 18.0 };
+
+}
+
+
+CurveSampler::CurveSampler(const ChannelMap& channels)
+    : m_channels(channels)
+{
+}
+
+/**
+ * @brief Samples one channel at x. Missing or degenerate channels return x (linear).
+ */
+qreal CurveSampler::sample(CurveWidget::ActiveChannel channel, qreal x) const
+{
+    auto it = m_channels.constFind(channel);
+    if (it == m_channels.constEnd() || it.value().size() < 2) {
+        return clamp01(x);
+    }
+    return sampleNodes(it.value(), x);
+}
+
+/**
+ * @brief Samples one channel at an ascending list of x values.
+ * @param xs - Sample positions, sorted ascending.
+ * @param out - Receives count values.
+ */
+void CurveSampler::sampleSorted(CurveWidget::ActiveChannel channel, const qreal *xs, int count, qreal *out, bool clampY) const
+{
+    auto it = m_channels.constFind(channel);
+    if (it == m_channels.constEnd() || it.value().size() < 2) {
+        for (int i = 0; i < count; ++i) out[i] = clamp01(xs[i]);
+        return;
+    }
+    sampleNodesSorted(it.value(), xs, count, out, clampY);
+}
+
+/**
+ * @brief Samples one channel at count evenly spaced positions covering [0, 1]
+ * (the LUT texel positions i / (count - 1)).
+ */
+void CurveSampler::sampleUniform(CurveWidget::ActiveChannel channel, int count, qreal *out, bool clampY) const
+{
+    if (count < 1) return;
+    QVector<qreal> xs(count);
+    for (int i = 0; i < count; ++i) {
+        xs[i] = (count == 1) ? 0.0 : static_cast<qreal>(i) / (count - 1.0);
+    }
+    sampleSorted(channel, xs.constData(), count, out, clampY);
+}
+
+/**
+ * @brief Samples the curve described by nodes at x. Output is clamped to [0, 1].
+ * Nodes are kept sorted by X, so the segment is found by binary search. At a node's
+ * exact X the segment ending there is used, as the old linear scan did.
+ */
+qreal CurveSampler::sampleNodes(const NodeList& nodes, qreal x)
+{
+    x = clamp01(x);
+    if (nodes.size() < 2) return x;
+
+    if (x < nodes.first().mainPoint.x()) return nodes.first().mainPoint.y();
+    if (x > nodes.last().mainPoint.x()) return nodes.last().mainPoint.y();
+
+    auto it = std::lower_bound(nodes.cbegin(), nodes.cend(), x,
+                               [](const CurveWidget::CurveNode& node, qreal value) { return node.mainPoint.x() < value; });
+    const int segment = std::max(0, std::min(static_cast<int>(it - nodes.cbegin()) - 1, static_cast<int>(nodes.size()) - 2));
+    return evaluateSegment(nodes[segment], nodes[segment + 1], x);
+}
+
+/**
+ * @brief Batch version of sampleNodes() for ascending xs: the segment cursor only
+ * moves forward, so a full LUT costs one pass over the segments.
+ * @param clampY - false keeps values that overshoot [0, 1], for float exports.
+ */
+void CurveSampler::sampleNodesSorted(const NodeList& nodes, const qreal *xs, int count, qreal *out, bool clampY)
+{
+    if (nodes.size() < 2) {
+        for (int i = 0; i < count; ++i) out[i] = clamp01(xs[i]);
+        return;
+    }
+
+    const int lastSegment = nodes.size() - 2;
+    const qreal firstX = nodes.first().mainPoint.x();
+    const qreal lastX = nodes.last().mainPoint.x();
+    int segment = 0;
+
+    for (int i = 0; i < count; ++i) {
+        const qreal x = clamp01(xs[i]);
+        if (x < firstX) { out[i] = nodes.first().mainPoint.y(); continue; }
+        if (x > lastX)  { out[i] = nodes.last().mainPoint.y(); continue; }
+
+        while (segment < lastSegment && x > nodes[segment + 1].mainPoint.x()) {
+            ++segment;
+        }
+        out[i] = evaluateSegment(nodes[segment], nodes[segment + 1], x, clampY);
+    }
+}
+
+/**
+ * @brief Solves x(t) = x with Newton-Raphson on one segment and returns y(t), clamped
+ * to [0, 1] unless clampY is false.
+ */
+qreal CurveSampler::evaluateSegment(const CurveWidget::CurveNode& n0, const CurveWidget::CurveNode& n1, qreal x, bool clampY)
+{
+    if (std::abs(n1.mainPoint.x() - n0.mainPoint.x()) <= 1e-9) {
+        return n0.mainPoint.y();
+    }
+    const qreal t = solveSegmentT(n0, n1, x);
+    const qreal y = bezierComponent(n0.mainPoint.y(), n0.handleOut.y(), n1.handleIn.y(), n1.mainPoint.y(), t);
+    return clampY ? clamp01(y) : y;
+}
+
+/**
+ * @brief Finds the Bézier parameter t in [0, 1] at which the segment from n0 to n1 reaches x.
+ */
+qreal CurveSampler::solveSegmentT(const CurveWidget::CurveNode& n0, const CurveWidget::CurveNode& n1, qreal x)
+{
+    const QPointF p0 = n0.mainPoint;
+    const QPointF p1 = n0.handleOut;
+    const QPointF p2 = n1.handleIn;
+    const QPointF p3 = n1.mainPoint;
+
+    const qreal segmentXRange = p3.x() - p0.x();
+    if (std::abs(segmentXRange) <= 1e-9) {
+        return 0.0;
+    }
+
+    const int MAX_ITERATIONS = 15;
+    const qreal TOLERANCE_X = 1e-7;
+    qreal t = clamp01((x - p0.x()) / segmentXRange);
+
+    for (int iter = 0; iter < MAX_ITERATIONS; ++iter) {
+        qreal error = bezierComponent(p0.x(), p1.x(), p2.x(), p3.x(), t) - x;
+        if (std::abs(error) < TOLERANCE_X) break;
+
+        qreal dXdt = bezierComponentDerivative(p0.x(), p1.x(), p2.x(), p3.x(), t);
+        if (std::abs(dXdt) < 1e-7) break;
+
+        t = clamp01(t - error / dXdt);
+    }
+
+    return t;
+}
+
+/**
+ * @brief Finds the parameters in (0, 1) where y(t) of the segment has a local extremum,
+ * i.e. the roots of the quadratic dy/dt. The ends of the segment are not included.
+ * @param ts - Receives up to two parameters in ascending order.
+ * @return Number of parameters written.
+ */
+int CurveSampler::segmentExtremaT(const CurveWidget::CurveNode& n0, const CurveWidget::CurveNode& n1, qreal ts[2])
+{
+    // dy/dt / 3 = a (1-t)^2 + 2 b t (1-t) + c t^2 = A t^2 + B t + C
+    const qreal a = n0.handleOut.y() - n0.mainPoint.y();
+    const qreal b = n1.handleIn.y() - n0.handleOut.y();
+    const qreal c = n1.mainPoint.y() - n1.handleIn.y();
+    const qreal A = a - 2.0 * b + c;
+    const qreal B = 2.0 * (b - a);
+    const qreal C = a;
+    const qreal eps = 1e-12;
+
+    qreal roots[2];
+    int rootCount = 0;
+    if (std::abs(A) <= eps) {
+        if (std::abs(B) > eps) roots[rootCount++] = -C / B;
+    } else {
+        const qreal discriminant = B * B - 4.0 * A * C;
+        if (discriminant >= 0.0) {
+            // Numerically stable form: avoids cancellation when B^2 >> 4AC.
+            const qreal q = -0.5 * (B + std::copysign(std::sqrt(discriminant), B));
+            roots[rootCount++] = q / A;
+            if (std::abs(q) > eps) roots[rootCount++] = C / q;
+        }
+    }
+
+    int count = 0;
+    for (int i = 0; i < rootCount; ++i) {
+        if (roots[i] > 0.0 && roots[i] < 1.0) ts[count++] = roots[i];
+    }
+    if (count == 2 && ts[0] > ts[1]) std::swap(ts[0], ts[1]);
+    return count;
+}
+
+/**
+ * @brief Exact range and area of the unclamped curve y(x) over [0, 1]. Extrema come
+ * from the node points and the roots of each segment's dy/dt; the integral is exact
+ * (see segmentIntegral()).
+ * Outside the first and last node the curve is flat, as in sampleNodes().
+ */
+CurveWidget::ChannelBounds CurveSampler::channelBounds(const NodeList& nodes)
+{
+    CurveWidget::ChannelBounds bounds;
+    if (nodes.size() < 2) return bounds;
+
+    auto consider = [&bounds](qreal x, qreal y) {
+        if (y < bounds.minY) { bounds.minY = y; bounds.minX = x; }
+        if (y > bounds.maxY) { bounds.maxY = y; bounds.maxX = x; }
+    };
+    bounds.minY = bounds.maxY = nodes.first().mainPoint.y();
+    bounds.minX = bounds.maxX = nodes.first().mainPoint.x();
+
+    const qreal firstX = clamp01(nodes.first().mainPoint.x());
+    const qreal lastX = clamp01(nodes.last().mainPoint.x());
+    qreal integral = firstX * nodes.first().mainPoint.y() + (1.0 - lastX) * nodes.last().mainPoint.y();
+
+    for (int i = 0; i + 1 < nodes.size(); ++i) {
+        const CurveWidget::CurveNode& n0 = nodes[i];
+        const CurveWidget::CurveNode& n1 = nodes[i + 1];
+        consider(n1.mainPoint.x(), n1.mainPoint.y());
+        if (std::abs(n1.mainPoint.x() - n0.mainPoint.x()) <= 1e-9) continue;
+
+        const qreal px[4] = { n0.mainPoint.x(), n0.handleOut.x(), n1.handleIn.x(), n1.mainPoint.x() };
+        const qreal py[4] = { n0.mainPoint.y(), n0.handleOut.y(), n1.handleIn.y(), n1.mainPoint.y() };
+
+        qreal ts[2];
+        const int count = segmentExtremaT(n0, n1, ts);
+        for (int k = 0; k < count; ++k) {
+            consider(bezierComponent(px[0], px[1], px[2], px[3], ts[k]),
+                     bezierComponent(py[0], py[1], py[2], py[3], ts[k]));
+        }
+
+        integral += segmentIntegral(n0, n1, 1.0);
+    }
+    bounds.integral = integral;
+    return bounds;
+}
+
+/**
+ * @brief Area under the segment's y(x) from its start up to parameter t, i.e. the
+ * integral of y(s) x'(s) over [0, t]. The integrand is a degree 5 polynomial, so
+ * 3-point Gauss-Legendre gives it exactly. Vertical segments have no area.
+ */
+qreal CurveSampler::segmentIntegral(const CurveWidget::CurveNode& n0, const CurveWidget::CurveNode& n1, qreal t)
+{
+    if (t <= 0.0 || std::abs(n1.mainPoint.x() - n0.mainPoint.x()) <= 1e-9) return 0.0;
+
+    const qreal px[4] = { n0.mainPoint.x(), n0.handleOut.x(), n1.handleIn.x(), n1.mainPoint.x() };
+    const qreal py[4] = { n0.mainPoint.y(), n0.handleOut.y(), n1.handleIn.y(), n1.mainPoint.y() };
+    qreal sum = 0.0;
+    for (int k = 0; k < 3; ++k) {
+        const qreal s = t * GAUSS_T[k];
+        sum += GAUSS_W[k] * bezierComponent(py[0], py[1], py[2], py[3], s)
+               * bezierComponentDerivative(px[0], px[1], px[2], px[3], s);
+    }
+    return sum * t;
+}
+
+/**
+ * @brief Running integral of the unclamped curve: out[i] is the area under y(x) from 0
+ * to xs[i]. Whole segments are summed once up front, so each sample costs one
+ * x -> t solve and a 3-point quadrature of the partial segment.
+ * @param xs - Sample positions, sorted ascending.
+ */
+void CurveSampler::integrateNodesSorted(const NodeList& nodes, const qreal *xs, int count, qreal *out)
+{
+    if (nodes.size() < 2) {
+        // Linear fallback y = x.
+        for (int i = 0; i < count; ++i) {
+            const qreal x = clamp01(xs[i]);
+            out[i] = 0.5 * x * x;
+        }
+        return;
+    }
+
+    const int lastSegment = nodes.size() - 2;
+    const qreal firstX = nodes.first().mainPoint.x();
+    const qreal lastX = nodes.last().mainPoint.x();
+
+    // areaBefore[k] = area from 0 up to the start of segment k.
+    QVector<qreal> areaBefore(lastSegment + 2);
+    areaBefore[0] = std::max(0.0, firstX) * nodes.first().mainPoint.y();
+    for (int k = 0; k <= lastSegment; ++k) {
+        areaBefore[k + 1] = areaBefore[k] + segmentIntegral(nodes[k], nodes[k + 1], 1.0);
+    }
+
+    int segment = 0;
+    for (int i = 0; i < count; ++i) {
+        const qreal x = clamp01(xs[i]);
+        if (x <= firstX) { out[i] = x * nodes.first().mainPoint.y(); continue; }
+        if (x >= lastX)  { out[i] = areaBefore[lastSegment + 1] + (x - lastX) * nodes.last().mainPoint.y(); continue; }
+
+        while (segment < lastSegment && x > nodes[segment + 1].mainPoint.x()) {
+            ++segment;
+        }
+        const CurveWidget::CurveNode& n0 = nodes[segment];
+        const CurveWidget::CurveNode& n1 = nodes[segment + 1];
+        out[i] = areaBefore[segment] + segmentIntegral(n0, n1, solveSegmentT(n0, n1, x));
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef CURVESAMPLER_H
+#define CURVESAMPLER_H
+
+// Qt Includes
+#include <QMap>
+#include <QVector>
+
+// Project Includes
+#include "curvewidget.h" // Required for CurveWidget::ActiveChannel, CurveWidget::CurveNode
+
+/**
+ * @brief Evaluates curve channels y(x) from an immutable snapshot of their nodes.
+ *
+ * A sampler owns its own copy of the node data, so it can be handed to worker
+ * threads while the user keeps editing. The batch entry points walk the segments
+ * once for an ascending run of x values instead of searching per sample.
+ */
+class CurveSampler
+{
+public:
+    using NodeList = QVector<CurveWidget::CurveNode>;
+    using ChannelMap = QMap<CurveWidget::ActiveChannel, NodeList>;
+
+    CurveSampler() = default;
+    explicit CurveSampler(const ChannelMap& channels);
+
+    const ChannelMap& channels() const { return m_channels; }
+
+    qreal sample(CurveWidget::ActiveChannel channel, qreal x) const;
+    void sampleSorted(CurveWidget::ActiveChannel channel, const qreal *xs, int count, qreal *out, bool clampY = true) const;
+    void sampleUniform(CurveWidget::ActiveChannel channel, int count, qreal *out, bool clampY = true) const;
+
+    /**
+     * @brief Evaluates one coordinate of a cubic Bézier at parameter t.
+     */
+    static qreal bezierComponent(qreal p0, qreal p1, qreal p2, qreal p3, qreal t)
+    {
+        const qreal mt = 1.0 - t;
+        return p0 * mt * mt * mt + p1 * 3.0 * mt * mt * t + p2 * 3.0 * mt * t * t + p3 * t * t * t;
+    }
+
+    static qreal sampleNodes(const NodeList& nodes, qreal x);
+    static void sampleNodesSorted(const NodeList& nodes, const qreal *xs, int count, qreal *out, bool clampY = true);
+    static qreal solveSegmentT(const CurveWidget::CurveNode& n0, const CurveWidget::CurveNode& n1, qreal x);
+
+    static void integrateNodesSorted(const NodeList& nodes, const qreal *xs, int count, qreal *out);
+    static int segmentExtremaT(const CurveWidget::CurveNode& n0, const CurveWidget::CurveNode& n1, qreal ts[2]);
+    static CurveWidget::ChannelBounds channelBounds(const NodeList& nodes);
+
+private:
+    static qreal segmentIntegral(const CurveWidget::CurveNode& n0, const CurveWidget::CurveNode& n1, qreal t);
+    static qreal evaluateSegment(const CurveWidget::CurveNode& n0, const CurveWidget::CurveNode& n1, qreal x, bool clampY = true);
+
+    ChannelMap m_channels;
+};
+
+#endif
@@ -1,5 +1,7 @@
 #include "curvewidget.h"
-#include "setcurvestatecommand.h"
+#include "curvedeltacommand.h"
+#include "curvesampler.h"
+#include "nodeclipboard.h"
 
 #include <QPainter>
 #include <QPen>
@@ -10,8 +12,9 @@
 #include <QtCore/qnumeric.h>
 #include <QDebug>
 #include <QList>
-#include <QSet>
+#include <QPair>
 #include <QRect>
+#include <QRectF>
 #include <QVector>
 #include <QMap>
 #include <QUndoStack>
@@ -25,6 +28,7 @@
 #include <limits>
 #include <functional>
 #include <stdexcept>
+#include <utility>
 
 
 // --- Anonymous Namespace for Local File Helpers ---
@@ -79,13 +83,74 @@ QPointF evaluateBezier(const QPointF& p0, const QPointF& p1, const QPointF& p2,
 }
 
 /**
- * @brief Evaluates the X component derivative of a cubic Bézier segment w.r.t. t.
+ * @brief Maps a sorted run of nodes linearly in X so it spans [a, b]. A single node
+ * is centered in the interval. Handles are scaled with their nodes.
  */
-qreal evaluateBezierXDerivative(const QPointF& p0, const QPointF& p1, const QPointF& p2, const QPointF& p3, qreal t) {
-    qreal mt = 1.0 - t;
-    return 3.0 * mt * mt * (p1.x() - p0.x()) +
-           6.0 * mt * t  * (p2.x() - p1.x()) +
-           3.0 * t * t   * (p3.x() - p2.x());
+QVector<CurveWidget::CurveNode> rescaleNodesX(QVector<CurveWidget::CurveNode> nodes, qreal a, qreal b) {
+    if (nodes.isEmpty()) return nodes;
+    const qreal x0 = nodes.first().mainPoint.x();
+    const qreal span = nodes.last().mainPoint.x() - x0;
+    const bool hasSpan = span > 1e-12 && nodes.size() > 1;
+    const qreal scale = hasSpan ? (b - a) / span : 1.0;
+    const qreal start = hasSpan ? a : (a + b) * 0.5;
+
+    for (CurveWidget::CurveNode& node : nodes) {
+        node.mainPoint.setX(start + (node.mainPoint.x() - x0) * scale);
+        node.handleIn.setX(start + (node.handleIn.x() - x0) * scale);
+        node.handleOut.setX(start + (node.handleOut.x() - x0) * scale);
+    }
+    if (hasSpan) nodes.last().mainPoint.setX(b);
+    return nodes;
+}
+
+/**
+ * @brief Builds the splice that replaces every node of a channel whose X lies within the
+ * pasted run's X span by the pasted run. A run reaching a channel end takes over that
+ * end node's exact X; a run that does not reach it leaves the end node in place, so the
+ * channel always keeps its X=0 and X=1 nodes. The splice is empty if it would leave
+ * fewer than two nodes.
+ */
+CurveDeltaCommand::Splice intervalSplice(CurveWidget::ActiveChannel channel,
+                                         const QVector<CurveWidget::CurveNode>& channelNodes,
+                                         QVector<CurveWidget::CurveNode> pasted) {
+    const qreal epsilon = 1e-9;
+    const qreal a = pasted.first().mainPoint.x();
+    const qreal b = pasted.last().mainPoint.x();
+    auto first = std::lower_bound(channelNodes.cbegin(), channelNodes.cend(), a - epsilon,
+                                  [](const CurveWidget::CurveNode& node, qreal x) { return node.mainPoint.x() < x; });
+    auto last = std::upper_bound(first, channelNodes.cend(), b + epsilon,
+                                 [](qreal x, const CurveWidget::CurveNode& node) { return x < node.mainPoint.x(); });
+    int index = static_cast<int>(first - channelNodes.cbegin());
+    int count = static_cast<int>(last - first);
+
+    if (count > 0 && index == 0) {
+        const qreal headX = channelNodes.first().mainPoint.x();
+        if (pasted.first().mainPoint.x() <= headX + epsilon) {
+            pasted.first().mainPoint.setX(headX);
+        } else {
+            ++index;
+            --count;
+        }
+    }
+    if (count > 0 && index + count == channelNodes.size()) {
+        const qreal tailX = channelNodes.last().mainPoint.x();
+        if (pasted.last().mainPoint.x() >= tailX - epsilon) {
+            pasted.last().mainPoint.setX(tailX);
+        } else {
+            --count;
+        }
+    }
+
+    CurveDeltaCommand::Splice splice;
+    splice.channel = channel;
+    if (channelNodes.size() - count + pasted.size() < 2) {
+        splice.index = index;
+        return splice;
+    }
+    splice.index = index;
+    splice.before = channelNodes.mid(index, count);
+    splice.after = pasted;
+    return splice;
 }
 
 }
@@ -97,7 +162,8 @@ CurveWidget::CurveNode::CurveNode(QPointF p)
     : mainPoint(p),
     handleIn(p),
     handleOut(p),
-    alignment(HandleAlignment::Aligned)
+    alignment(HandleAlignment::Aligned),
+    id(0)
 {}
 
 bool CurveWidget::CurveNode::operator==(const CurveNode& other) const {
@@ -112,6 +178,24 @@ bool CurveWidget::CurveNode::operator==(const CurveNode& other) const {
 }
 
 
+// --- NodeTransform Implementation ---
+
+/**
+ * @brief Maps a logical point: scale (with flips) about the pivot, then offset.
+ */
+QPointF CurveWidget::NodeTransform::map(const QPointF& p) const {
+    const qreal sx = flipX ? -scaleX : scaleX;
+    const qreal sy = flipY ? -scaleY : scaleY;
+    return QPointF(pivot.x() + (p.x() - pivot.x()) * sx + offset.x(),
+                   pivot.y() + (p.y() - pivot.y()) * sy + offset.y());
+}
+
+bool CurveWidget::NodeTransform::isIdentity() const {
+    return !flipX && !flipY && qFuzzyCompare(scaleX, 1.0) && qFuzzyCompare(scaleY, 1.0) &&
+           qFuzzyIsNull(offset.x()) && qFuzzyIsNull(offset.y());
+}
+
+
 // --- CurveWidget Constructor ---
 
 CurveWidget::CurveWidget(QWidget *parent)
@@ -124,7 +208,10 @@ CurveWidget::CurveWidget(QWidget *parent)
     m_handleRadius(4.0),
     m_isDarkMode(false),
     m_drawInactiveChannels(false),
-    m_clampHandles(true)
+    m_clampHandles(true),
+    m_revision(0),
+    m_nextNodeId(1),
+    m_channelsLinked(false)
 
 {
     QList<ActiveChannel> channels = {ActiveChannel::RED, ActiveChannel::GREEN, ActiveChannel::BLUE};
@@ -137,6 +224,7 @@ CurveWidget::CurveWidget(QWidget *parent)
         node0.alignment = HandleAlignment::Free;
         node1.alignment = HandleAlignment::Free;
         defaultNodes << node0 << node1;
+        assignNodeIds(defaultNodes);
         m_channelNodes.insert(channel, defaultNodes);
     }
 
@@ -168,74 +256,85 @@ CurveWidget::ActiveChannel CurveWidget::getActiveChannel() const {
  * Uses iterative solving (Newton-Raphson) to find the Bézier parameter t for the given x.
  */
 qreal CurveWidget::sampleCurveChannel(ActiveChannel channel, qreal x) const {
-    x = std::max(0.0, std::min(1.0, x));
-
     auto it = m_channelNodes.find(channel);
     if (it == m_channelNodes.end() || it.value().size() < 2) {
         qWarning() << "CurveWidget::sampleCurveChannel - Channel invalid or < 2 nodes. Returning linear.";
-        return x;
-    }
-    const QVector<CurveNode>& nodes = it.value();
-
-    int segmentIndex = -1;
-    for (int i = 0; i < nodes.size() - 1; ++i) {
-        if (x >= nodes[i].mainPoint.x() && x <= nodes[i+1].mainPoint.x()) {
-            if (qFuzzyCompare(nodes[i].mainPoint.x(), nodes[i+1].mainPoint.x())) {
-                return nodes[i].mainPoint.y();
-            }
-            segmentIndex = i;
-            break;
-        }
+        return std::max(0.0, std::min(1.0, x));
     }
+    return CurveSampler::sampleNodes(it.value(), x);
+}
 
-    if (segmentIndex == -1) {
-        if (x <= nodes.first().mainPoint.x()) {
-            return nodes.first().mainPoint.y();
-        } else {
-            return nodes.last().mainPoint.y();
-        }
-    }
+/**
+ * @brief Gets the edit revision. Incremented every time curveChanged() is emitted,
+ * so caches of derived data can tell whether they are stale.
+ */
+quint64 CurveWidget::revision() const {
+    return m_revision;
+}
 
-    const CurveNode& n0 = nodes[segmentIndex];
-    const CurveNode& n1 = nodes[segmentIndex + 1];
-    const QPointF p0 = n0.mainPoint;
-    const QPointF p1 = n0.handleOut;
-    const QPointF p2 = n1.handleIn;
-    const QPointF p3 = n1.mainPoint;
+/**
+ * @brief Gets the exact unclamped range, overshoot and area of a channel's curve.
+ * Cached per channel until an edit touches that channel.
+ */
+CurveWidget::ChannelBounds CurveWidget::channelBounds(ActiveChannel channel) const {
+    auto cached = m_boundsCache.constFind(channel);
+    if (cached != m_boundsCache.constEnd()) return cached.value();
+    const ChannelBounds bounds = CurveSampler::channelBounds(m_channelNodes.value(channel));
+    m_boundsCache.insert(channel, bounds);
+    return bounds;
+}
 
-    qreal t_guess = 0.5;
-    qreal segmentXRange = p3.x() - p0.x();
+/**
+ * @brief Returns the index of the node with the given id in the active channel, or -1.
+ */
+int CurveWidget::indexOfNodeId(quint32 id) const {
+    return indexOfNodeId(m_activeChannel, id);
+}
 
-    if (std::abs(segmentXRange) > 1e-9) {
-        t_guess = (x - p0.x()) / segmentXRange;
-        t_guess = std::max(0.0, std::min(1.0, t_guess));
-    } else {
-        qWarning("Sampling near vertical segment, result might be inaccurate.");
-        return p0.y();
+/**
+ * @brief Returns the index of the node with the given id in a channel, or -1.
+ * The ID→index map of a channel is built on first use and dropped whenever its nodes move.
+ */
+int CurveWidget::indexOfNodeId(ActiveChannel channel, quint32 id) const {
+    if (id == 0) return -1;
+    auto nodesIt = m_channelNodes.constFind(channel);
+    if (nodesIt == m_channelNodes.constEnd()) return -1;
+
+    auto cacheIt = m_nodeIndexById.find(channel);
+    if (cacheIt == m_nodeIndexById.end()) {
+        const QVector<CurveNode>& nodes = nodesIt.value();
+        QHash<quint32, int> indexById;
+        indexById.reserve(nodes.size());
+        for (int i = 0; i < nodes.size(); ++i) indexById.insert(nodes[i].id, i);
+        cacheIt = m_nodeIndexById.insert(channel, indexById);
     }
+    return cacheIt.value().value(id, -1);
+}
 
-    const int MAX_ITERATIONS = 15;
-    const qreal TOLERANCE_X = 1e-7;
-    qreal t = t_guess;
-
-    for (int iter = 0; iter < MAX_ITERATIONS; ++iter) {
-        qreal currentX = evaluateBezier(p0, p1, p2, p3, t).x();
-        qreal error = currentX - x;
-        if (std::abs(error) < TOLERANCE_X) break;
-
-        qreal dXdt = evaluateBezierXDerivative(p0, p1, p2, p3, t);
-        if (std::abs(dXdt) < 1e-7) {
-            qWarning("Newton's method encountered near-zero derivative during sampling.");
-            break;
-        }
-        t = t - error / dXdt;
-        t = std::max(0.0, std::min(1.0, t));
+/**
+ * @brief Returns the ids of the selected nodes of the active channel, in node order.
+ */
+QVector<quint32> CurveWidget::selectedNodeIds() const {
+    const QVector<CurveNode>& activeNodes = getActiveNodes();
+    QVector<quint32> ids;
+    ids.reserve(m_selectedNodeIndices.size());
+    for (int index : m_selectedNodeIndices.indices()) {
+        if (index >= 0 && index < activeNodes.size()) ids.append(activeNodes[index].id);
     }
-    t = std::max(0.0, std::min(1.0, t));
-
-    qreal resultY = evaluateBezier(p0, p1, p2, p3, t).y();
+    return ids;
+}
 
-    return std::max(0.0, std::min(1.0, resultY));
+/**
+ * @brief Replaces the selection with the active channel's nodes that have the given ids.
+ */
+void CurveWidget::selectNodeIds(const QVector<quint32>& ids) {
+    m_selectedNodeIndices.clear();
+    for (quint32 id : ids) {
+        const int index = indexOfNodeId(id);
+        if (index >= 0) m_selectedNodeIndices.insert(index);
+    }
+    update();
+    emit selectionChanged();
 }
 
 /**
@@ -251,15 +350,10 @@ void CurveWidget::resetCurve() {
     node0.handleOut = QPointF(1.0/3.0, 0.0); node1.handleIn = QPointF(2.0/3.0, 1.0);
     node0.alignment = HandleAlignment::Free; node1.alignment = HandleAlignment::Free;
     activeNodes << node0 << node1;
+    assignNodeIds(activeNodes);
 
-    QMap<ActiveChannel, QVector<CurveNode>> newState = m_channelNodes;
-    bool stateChanged = false;
-    if (m_stateBeforeAction.keys() != newState.keys()) { stateChanged = true; }
-    else { for(auto key : m_stateBeforeAction.keys()) { if (m_stateBeforeAction[key] != newState[key]) { stateChanged = true; break; }}}
-
-    if (stateChanged) {
-        m_undoStack.push(new SetCurveStateCommand(this, m_stateBeforeAction, newState, "Reset Curve"));
-    } else { m_stateBeforeAction.clear(); }
+    pushCurveChange(m_stateBeforeAction, "Reset Curve");
+    m_stateBeforeAction.clear();
 
     m_selectedNodeIndices.clear();
     m_currentDrag = {SelectedPart::NONE, -1};
@@ -268,7 +362,7 @@ void CurveWidget::resetCurve() {
     m_boxSelectionRect = QRect();
 
     update();
-    emit curveChanged();
+    notifyCurveChanged();
     emit selectionChanged();
 }
 
@@ -297,12 +391,104 @@ int CurveWidget::getActiveNodeCount() const {
 }
 
 /**
- * @brief Gets the set of currently selected main node indices.
+ * @brief Gets the currently selected main node indices of the active channel.
+ * The reference stays valid until the selection changes.
  */
-QSet<int> CurveWidget::getSelectedIndices() const {
+const NodeSelection& CurveWidget::getSelectedIndices() const {
     return m_selectedNodeIndices;
 }
 
+/**
+ * @brief Returns the logical bounding box of the selected main points, or a null rect if nothing is selected.
+ */
+QRectF CurveWidget::selectionBounds() const {
+    const QVector<CurveNode>& activeNodes = getActiveNodes();
+    qreal minX = std::numeric_limits<qreal>::max(), minY = minX;
+    qreal maxX = std::numeric_limits<qreal>::lowest(), maxY = maxX;
+    bool any = false;
+    for (int index : m_selectedNodeIndices.indices()) {
+        if (index < 0 || index >= activeNodes.size()) continue;
+        const QPointF& p = activeNodes[index].mainPoint;
+        minX = std::min(minX, p.x()); maxX = std::max(maxX, p.x());
+        minY = std::min(minY, p.y()); maxY = std::max(maxY, p.y());
+        any = true;
+    }
+    return any ? QRectF(QPointF(minX, minY), QPointF(maxX, maxY)) : QRectF();
+}
+
+/**
+ * @brief Applies a transform to every selected node of the active channel as one undoable edit.
+ *
+ * The selection is mapped in a single pass. The end nodes stay pinned at X=0 and X=1
+ * and only take the Y part of the transform; interior nodes are clamped inside (0, 1).
+ * If the pass broke the X order, only the k moved nodes are sorted (O(k log k)) and
+ * merged back into the untouched nodes, which are still in order. The undo entry
+ * stores just the changed run of nodes.
+ * @return true if the curve changed.
+ */
+bool CurveWidget::transformSelection(const NodeTransform& transform) {
+    if (m_selectedNodeIndices.isEmpty() || transform.isIdentity()) return false;
+
+    QVector<CurveNode>& activeNodes = getActiveNodes();
+    const QVector<CurveNode> before = activeNodes;
+    const int lastIndex = activeNodes.size() - 1;
+    const qreal epsilon = 1e-9;
+    // A negative net X scale mirrors the node, so the incoming handle ends up on the right.
+    const bool swapHandles = (transform.flipX != (transform.scaleX < 0.0));
+
+    for (int index : m_selectedNodeIndices.indices()) {
+        if (index < 0 || index > lastIndex) continue;
+        CurveNode& node = activeNodes[index];
+        const bool isEndNode = (index == 0 || index == lastIndex);
+
+        QPointF mappedMain = transform.map(node.mainPoint);
+        QPointF mappedIn = transform.map(node.handleIn);
+        QPointF mappedOut = transform.map(node.handleOut);
+        if (isEndNode) {
+            mappedMain.setX(node.mainPoint.x());
+            mappedIn.setX(node.handleIn.x());
+            mappedOut.setX(node.handleOut.x());
+        }
+
+        const qreal minX = isEndNode ? node.mainPoint.x() : epsilon;
+        const qreal maxX = isEndNode ? node.mainPoint.x() : 1.0 - epsilon;
+        const QPointF clampedMain(std::max(minX, std::min(maxX, mappedMain.x())),
+                                  std::max(0.0, std::min(1.0, mappedMain.y())));
+        const QPointF correction = clampedMain - mappedMain;
+
+        node.mainPoint = clampedMain;
+        node.handleIn = mappedIn + correction;
+        node.handleOut = mappedOut + correction;
+        if (swapHandles && !isEndNode) std::swap(node.handleIn, node.handleOut);
+
+        clampHandlePosition(node.handleIn);
+        clampHandlePosition(node.handleOut);
+        applyAlignmentSnap(index, SelectedPart::HANDLE_OUT);
+    }
+
+    auto byX = [](const CurveNode& a, const CurveNode& b) { return a.mainPoint.x() < b.mainPoint.x(); };
+    if (lastIndex > 1 && !std::is_sorted(activeNodes.cbegin() + 1, activeNodes.cend() - 1, byX)) {
+        QVector<CurveNode> moved;
+        QVector<CurveNode> stationary;
+        moved.reserve(m_selectedNodeIndices.size());
+        stationary.reserve(activeNodes.size());
+        for (int i = 1; i < lastIndex; ++i) {
+            (m_selectedNodeIndices.contains(i) ? moved : stationary).append(activeNodes[i]);
+        }
+        std::stable_sort(moved.begin(), moved.end(), byX);
+        std::merge(stationary.cbegin(), stationary.cend(), moved.cbegin(), moved.cend(), activeNodes.begin() + 1, byX);
+    }
+
+    // The command applies the edit itself on push (keeping the selection by node id),
+    // so hand it the result and put the old nodes back.
+    const CurveDeltaCommand::Splice splice = CurveDeltaCommand::diff(m_activeChannel, before, activeNodes);
+    activeNodes = before;
+    if (CurveDeltaCommand::isEmpty(splice)) return false;
+
+    m_undoStack.push(new CurveDeltaCommand(this, {splice}, "Transform Nodes"));
+    return true;
+}
+
 /**
  * @brief Gets the handle alignment mode for a specific node index in the active channel.
  * Returns Free if index is invalid.
@@ -365,17 +551,11 @@ void CurveWidget::setNodeAlignment(int nodeIndex, HandleAlignment mode) {
         node.alignment = mode;
         applyAlignmentSnap(nodeIndex, SelectedPart::HANDLE_OUT);
 
-        QMap<ActiveChannel, QVector<CurveNode>> newState = m_channelNodes;
-        bool stateChanged = false;
-        if (m_stateBeforeAction.keys() != newState.keys()) { stateChanged = true; }
-        else { for(auto key : m_stateBeforeAction.keys()) { if (m_stateBeforeAction[key] != newState[key]) { stateChanged = true; break; }}}
-
-        if (stateChanged) {
-            m_undoStack.push(new SetCurveStateCommand(this, m_stateBeforeAction, newState, "Change Alignment"));
-        } else { m_stateBeforeAction.clear(); }
+        pushCurveChange(m_stateBeforeAction, "Change Alignment");
+        m_stateBeforeAction.clear();
 
         update();
-        emit curveChanged();
+        notifyCurveChanged();
         emit selectionChanged();
     }
 }
@@ -439,32 +619,20 @@ void CurveWidget::paintEvent(QPaintEvent *event) {
     painter.setPen(QPen(borderColor, 1));
     painter.drawRect(rect().adjusted(0, 0, -1, -1));
 
-    if (m_drawInactiveChannels) {
+    if (m_drawInactiveChannels || m_channelsLinked) {
         painter.save();
         for (auto it = m_channelNodes.constBegin(); it != m_channelNodes.constEnd(); ++it) {
-            if (it.key() == m_activeChannel) continue;
-            const QVector<CurveNode>& nodes = it.value();
-            if (nodes.size() < 2) continue;
-            QPainterPath inactivePath;
-            inactivePath.moveTo(mapToWidget(nodes[0].mainPoint));
-            for (int i = 0; i < nodes.size() - 1; ++i) {
-                inactivePath.cubicTo(mapToWidget(nodes[i].handleOut), mapToWidget(nodes[i+1].handleIn), mapToWidget(nodes[i+1].mainPoint));
-            }
-            painter.setPen(QPen(getInactiveChannelColor(it.key()), 1.2, Qt::DotLine));
-            painter.drawPath(inactivePath);
+            if (it.key() == m_activeChannel || it.value().size() < 2) continue;
+            painter.setPen(QPen(getInactiveChannelColor(it.key()), 1.2, m_channelsLinked ? Qt::DashLine : Qt::DotLine));
+            painter.drawPath(channelPath(it.key()));
         }
         painter.restore();
     }
 
     const QVector<CurveNode>& activeNodes = getActiveNodes();
     if (activeNodes.size() >= 2) {
-        QPainterPath curvePath;
-        curvePath.moveTo(mapToWidget(activeNodes[0].mainPoint));
-        for (int i = 0; i < activeNodes.size() - 1; ++i) {
-            curvePath.cubicTo(mapToWidget(activeNodes[i].handleOut), mapToWidget(activeNodes[i+1].handleIn), mapToWidget(activeNodes[i+1].mainPoint));
-        }
         painter.setPen(QPen(activeCurveColor, 2));
-        painter.drawPath(curvePath);
+        painter.drawPath(channelPath(m_activeChannel));
     }
 
     for (int i = 0; i < activeNodes.size(); ++i) {
@@ -525,15 +693,17 @@ void CurveWidget::mousePressEvent(QMouseEvent *event)
         QVector<CurveNode>& activeNodes = getActiveNodes();
         if (nodeIndex > 0 && nodeIndex < activeNodes.size() - 1) {
             m_stateBeforeAction = m_channelNodes;
+            const qreal removedX = activeNodes[nodeIndex].mainPoint.x();
             activeNodes.remove(nodeIndex);
-            m_undoStack.push(new SetCurveStateCommand(this, m_stateBeforeAction, m_channelNodes, "Delete Node"));
+            removeLinkedNodesAtX({removedX});
+            pushCurveChange(m_stateBeforeAction, "Delete Node");
 
             if(m_selectedNodeIndices.contains(nodeIndex) || !m_selectedNodeIndices.isEmpty()) selectionActuallyChanged = true;
             m_selectedNodeIndices.clear();
             m_currentDrag = {SelectedPart::NONE, -1};
 
             update();
-            emit curveChanged();
+            notifyCurveChanged();
             if(selectionActuallyChanged) emit selectionChanged();
         }
         return;
@@ -583,13 +753,15 @@ void CurveWidget::mousePressEvent(QMouseEvent *event)
                 CurveNode newNode(split.pointOnCurve);
                 newNode.handleIn = split.handle2_Seg1; newNode.handleOut = split.handle1_Seg2;
                 newNode.alignment = HandleAlignment::Aligned;
+                newNode.id = m_nextNodeId++;
                 activeNodes[i].handleOut = split.handle1_Seg1; activeNodes[i+1].handleIn = split.handle2_Seg2;
                 int newNodeIndex = i + 1;
                 activeNodes.insert(newNodeIndex, newNode);
+                for (ActiveChannel channel : linkedChannels()) insertLinkedNodeAtX(channel, newNode.mainPoint.x());
 
                 QMap<ActiveChannel, QVector<CurveNode>> stateAfterAdd = m_channelNodes;
 
-                m_undoStack.push(new SetCurveStateCommand(this, stateBeforeAdd, stateAfterAdd, "Add Node"));
+                pushCurveChange(stateBeforeAdd, "Add Node");
                 qDebug() << "Add Node undo command pushed.";
 
                 if (!m_selectedNodeIndices.isEmpty()) selectionActuallyChanged = true;
@@ -601,7 +773,7 @@ void CurveWidget::mousePressEvent(QMouseEvent *event)
                 m_currentDrag = {SelectedPart::MAIN_POINT, newNodeIndex};
                 m_stateBeforeAction = stateAfterAdd;
 
-                emit curveChanged();
+                notifyCurveChanged();
 
             } else {
                 m_isBoxSelecting = true;
@@ -663,30 +835,47 @@ void CurveWidget::mouseMoveEvent(QMouseEvent *event)
         } else { return; }
 
 
-        bool needsReSort = false;
         if (m_currentDrag.part == SelectedPart::MAIN_POINT && !deltaLogical.isNull()) {
-            for (int index : m_selectedNodeIndices) {
-                if (index < 0 || index >= activeNodes.size()) continue;
-                CurveNode& nodeToMove = activeNodes[index];
-                QPointF oldMainPos = nodeToMove.mainPoint;
-                const qreal handleCoincidenceThresholdSq = 1e-12;
-
-                nodeToMove.mainPoint += deltaLogical;
-                nodeToMove.mainPoint.setY(std::max(0.0, std::min(1.0, nodeToMove.mainPoint.y())));
-
-                if (QPointF::dotProduct(nodeToMove.handleIn - oldMainPos, nodeToMove.handleIn - oldMainPos) > handleCoincidenceThresholdSq) nodeToMove.handleIn += deltaLogical;
-                if (QPointF::dotProduct(nodeToMove.handleOut - oldMainPos, nodeToMove.handleOut - oldMainPos) > handleCoincidenceThresholdSq) nodeToMove.handleOut += deltaLogical;
-
-                clampHandlePosition(nodeToMove.handleIn);
-                clampHandlePosition(nodeToMove.handleOut);
+            // Copied because the order fixups below move selection bits around.
+            const QVector<int> movedIndices = m_selectedNodeIndices.indices();
+
+            // Linked channels move their nodes at the same X; looked up before anything moves.
+            QVector<QPair<ActiveChannel, QVector<int>>> linkedMoves;
+            for (ActiveChannel channel : linkedChannels()) {
+                const QVector<CurveNode>& linkedNodes = m_channelNodes.find(channel).value();
+                QVector<int> linkedIndices;
+                for (int index : movedIndices) {
+                    if (index < 0 || index >= activeNodes.size()) continue;
+                    const int linkedIndex = findNodeAtX(linkedNodes, activeNodes[index].mainPoint.x());
+                    if (linkedIndex >= 0) linkedIndices.append(linkedIndex);
+                }
+                std::sort(linkedIndices.begin(), linkedIndices.end());
+                linkedMoves.append({channel, linkedIndices});
+            }
 
-                applyAlignmentSnap(index, SelectedPart::HANDLE_OUT);
+            for (int index : movedIndices) moveNodeBy(activeNodes, index, deltaLogical);
+            for (const auto& move : linkedMoves) {
+                QVector<CurveNode>& linkedNodes = m_channelNodes.find(move.first).value();
+                for (int index : move.second) moveNodeBy(linkedNodes, index, deltaLogical);
+            }
 
-                if (index > 0 && index < activeNodes.size() - 1) needsReSort = true;
+            if (!qFuzzyIsNull(deltaLogical.x())) {
+                fixNodeOrder(m_activeChannel, movedIndices, deltaLogical.x() > 0.0);
+                for (const auto& move : linkedMoves) fixNodeOrder(move.first, move.second, deltaLogical.x() > 0.0);
             }
-            if (needsReSort) { qDebug() << "Multi-drag might require sorting."; }
 
         } else if ((m_currentDrag.part == SelectedPart::HANDLE_IN || m_currentDrag.part == SelectedPart::HANDLE_OUT) && !deltaLogical.isNull()) {
+            for (ActiveChannel channel : linkedChannels()) {
+                QVector<CurveNode>& linkedNodes = m_channelNodes.find(channel).value();
+                const int linkedIndex = findNodeAtX(linkedNodes, primaryNode.mainPoint.x());
+                if (linkedIndex < 0) continue;
+                CurveNode& linkedNode = linkedNodes[linkedIndex];
+                QPointF* linkedHandle = (m_currentDrag.part == SelectedPart::HANDLE_IN) ? &linkedNode.handleIn : &linkedNode.handleOut;
+                *linkedHandle += deltaLogical;
+                clampHandlePosition(*linkedHandle);
+                if (linkedIndex > 0 && linkedIndex < linkedNodes.size() - 1) snapOppositeHandle(linkedNode, m_currentDrag.part);
+            }
+
             QPointF* handlePtr = (m_currentDrag.part == SelectedPart::HANDLE_IN) ? &primaryNode.handleIn : &primaryNode.handleOut;
             *handlePtr += deltaLogical;
 
@@ -697,7 +886,7 @@ void CurveWidget::mouseMoveEvent(QMouseEvent *event)
 
         if (!deltaLogical.isNull()) {
             update();
-            emit curveChanged();
+            notifyCurveChanged();
         }
 
     } else if (m_isBoxSelecting) {
@@ -710,10 +899,9 @@ void CurveWidget::mouseMoveEvent(QMouseEvent *event)
  */
 void CurveWidget::mouseReleaseEvent(QMouseEvent *event)
 {
-    qDebug() << "<<< Release Start: Selection:" << m_selectedNodeIndices << "Dragging:" << m_dragging << "BoxSelect:" << m_isBoxSelecting;
+    qDebug() << "<<< Release Start: Selected:" << m_selectedNodeIndices.size() << "Dragging:" << m_dragging << "BoxSelect:" << m_isBoxSelecting;
 
     bool wasDragging = m_dragging;
-    QSet<int> selectionToKeepIndices = m_selectedNodeIndices;
     SelectionInfo dragToKeep = m_currentDrag;
 
     if (wasDragging && event->button() == Qt::LeftButton) {
@@ -721,13 +909,7 @@ void CurveWidget::mouseReleaseEvent(QMouseEvent *event)
 
         bool pushedCommand = false;
         if (!m_stateBeforeAction.isEmpty()) {
-            QMap<ActiveChannel, QVector<CurveNode>> currentState = m_channelNodes;
-            bool stateChanged = false;
-            if (m_stateBeforeAction.keys() != currentState.keys()) { stateChanged = true; }
-            else { for(auto key : m_stateBeforeAction.keys()) { if (m_stateBeforeAction[key] != currentState[key]) { stateChanged = true; break; }}}
-
-            if (stateChanged) {
-                m_undoStack.push(new SetCurveStateCommand(this, m_stateBeforeAction, currentState, "Modify Curve"));
+            if (pushCurveChange(m_stateBeforeAction, "Modify Curve")) {
                 pushedCommand = true;
                 qDebug() << "Modify Curve undo command pushed (drag release).";
             } else {
@@ -736,8 +918,6 @@ void CurveWidget::mouseReleaseEvent(QMouseEvent *event)
             m_stateBeforeAction.clear();
         }
 
-        qDebug() << "Re-asserting selection state after drag release.";
-        m_selectedNodeIndices = selectionToKeepIndices;
         m_currentDrag = dragToKeep;
 
         emit selectionChanged();
@@ -748,24 +928,20 @@ void CurveWidget::mouseReleaseEvent(QMouseEvent *event)
         m_isBoxSelecting = false;
         bool selectionActuallyChanged = false;
         bool shiftPressed = event->modifiers() & Qt::ShiftModifier;
-        QSet<int> originalSelection = m_selectedNodeIndices;
+        const int countBefore = m_selectedNodeIndices.size();
 
         if (!shiftPressed) { m_selectedNodeIndices.clear(); }
+        selectNodesInBox(m_boxSelectionRect);
 
-        const QVector<CurveNode>& activeNodes = getActiveNodes();
-        for (int i = 0; i < activeNodes.size(); ++i) {
-            QPoint widgetPoint = mapToWidget(activeNodes[i].mainPoint).toPoint();
-            if (m_boxSelectionRect.contains(widgetPoint)) { m_selectedNodeIndices.insert(i); }
-        }
-
-        if (m_selectedNodeIndices != originalSelection) selectionActuallyChanged = true;
+        // Shift only adds to the selection, so a size change is the only possible change.
+        if ((!shiftPressed && countBefore > 0) || m_selectedNodeIndices.size() != countBefore) selectionActuallyChanged = true;
 
         m_boxSelectionRect = QRect();
         m_currentDrag = {SelectedPart::NONE, -1};
         update();
 
         if (selectionActuallyChanged) {
-            qDebug() << "Box selection completed. Selected indices:" << m_selectedNodeIndices;
+            qDebug() << "Box selection completed. Selected:" << m_selectedNodeIndices.size();
             emit selectionChanged();
         } else {
             qDebug() << "Box selection completed. Selection unchanged.";
@@ -777,7 +953,7 @@ void CurveWidget::mouseReleaseEvent(QMouseEvent *event)
         if (m_dragging) m_dragging = false;
     }
 
-    qDebug() << ">>> Release End: Selection:" << m_selectedNodeIndices;
+    qDebug() << ">>> Release End: Selected:" << m_selectedNodeIndices.size();
 }
 
 /**
@@ -795,10 +971,10 @@ void CurveWidget::keyPressEvent(QKeyEvent *event)
 {
     bool keyHandled = false;
 
-    if (m_selectedNodeIndices.size() == 1 &&
+    if (m_selectedNodeIndices.size() == 1 && !(event->modifiers() & Qt::ControlModifier) &&
         (event->key() == Qt::Key_F || event->key() == Qt::Key_A || event->key() == Qt::Key_M))
     {
-        int nodeIndex = *m_selectedNodeIndices.constBegin();
+        int nodeIndex = m_selectedNodeIndices.first();
         QVector<CurveNode>& activeNodes = getActiveNodes();
         if (nodeIndex >= 0 && nodeIndex < activeNodes.size()) {
             CurveNode& node = activeNodes[nodeIndex];
@@ -821,23 +997,26 @@ void CurveWidget::keyPressEvent(QKeyEvent *event)
         m_stateBeforeAction = m_channelNodes;
         QVector<CurveNode>& activeNodes = getActiveNodes();
         bool nodesWereRemoved = false;
-        QList<int> indicesToRemove = m_selectedNodeIndices.values();
-        std::sort(indicesToRemove.begin(), indicesToRemove.end(), std::greater<int>());
+        const QVector<int>& indicesToRemove = m_selectedNodeIndices.indices();
+        QVector<qreal> removedXs;
 
-        for (int index : indicesToRemove) {
+        for (auto it = indicesToRemove.crbegin(); it != indicesToRemove.crend(); ++it) {
+            int index = *it;
             if (index > 0 && index < activeNodes.size() - 1) {
+                removedXs.append(activeNodes[index].mainPoint.x());
                 activeNodes.remove(index);
                 nodesWereRemoved = true;
             }
         }
+        removeLinkedNodesAtX(removedXs);
 
         if (nodesWereRemoved) {
-            m_undoStack.push(new SetCurveStateCommand(this, m_stateBeforeAction, m_channelNodes, "Delete Node(s)"));
+            pushCurveChange(m_stateBeforeAction, "Delete Node(s)");
             m_selectedNodeIndices.clear();
             m_currentDrag = {SelectedPart::NONE, -1};
             m_dragging = false;
             update();
-            emit curveChanged();
+            notifyCurveChanged();
             emit selectionChanged();
             keyHandled = true;
         } else {
@@ -846,7 +1025,22 @@ void CurveWidget::keyPressEvent(QKeyEvent *event)
     }
 
     if (!keyHandled) {
-        if (event->matches(QKeySequence::Undo)) {
+        if (event->matches(QKeySequence::SelectAll)) {
+            selectAllNodes();
+            keyHandled = true;
+        } else if (event->key() == Qt::Key_I && (event->modifiers() & Qt::ControlModifier)) {
+            invertSelection();
+            keyHandled = true;
+        } else if (event->matches(QKeySequence::Copy)) {
+            copySelection();
+            keyHandled = true;
+        } else if (event->matches(QKeySequence::Paste)) {
+            pasteNodes();
+            keyHandled = true;
+        } else if (event->key() == Qt::Key_D && (event->modifiers() & Qt::ControlModifier)) {
+            duplicateSelectionToOtherChannels();
+            keyHandled = true;
+        } else if (event->matches(QKeySequence::Undo)) {
             m_undoStack.undo();
             keyHandled = true;
         } else if (event->matches(QKeySequence::Redo)) {
@@ -867,14 +1061,62 @@ void CurveWidget::keyPressEvent(QKeyEvent *event)
 
 /**
  * @brief Restores the internal state of all channel nodes (called by Undo command).
+ * Nodes that still exist afterwards stay selected.
  */
 void CurveWidget::restoreAllChannelNodes(const QMap<ActiveChannel, QVector<CurveNode>>& allNodes) {
     if (m_channelNodes == allNodes) {
         qDebug() << "Undo/Redo: State appears unchanged.";
     }
+    const QVector<quint32> selectedIds = selectedNodeIds();
     m_channelNodes = allNodes;
+    m_nodeIndexById.clear();
+
+    finishRestore(selectedIds);
+    qDebug() << "Curve state restored via Undo/Redo.";
+}
+
+/**
+ * @brief Replaces count nodes of a channel starting at index (called by delta undo commands).
+ * Call finishRestore() once all changes of a command are in place.
+ */
+void CurveWidget::replaceNodeRange(ActiveChannel channel, int index, int count, const QVector<CurveNode>& nodes) {
+    auto it = m_channelNodes.find(channel);
+    if (it == m_channelNodes.end() || index < 0 || count < 0 || index + count > it.value().size()) {
+        qWarning() << "replaceNodeRange: Invalid range" << index << count << "for channel" << channel;
+        return;
+    }
+    QVector<CurveNode>& target = it.value();
+    if (count == nodes.size()) {
+        std::copy(nodes.cbegin(), nodes.cend(), target.begin() + index);
+    } else {
+        target = target.mid(0, index) + nodes + target.mid(index + count);
+    }
+    m_nodeIndexById.remove(channel);
+}
 
+/**
+ * @brief Overwrites the node with node.id in a channel (called by delta undo commands).
+ * Call finishRestore() once all changes of a command are in place.
+ */
+void CurveWidget::replaceNodeById(ActiveChannel channel, const CurveNode& node) {
+    const int index = indexOfNodeId(channel, node.id);
+    if (index < 0) {
+        qWarning() << "replaceNodeById: No node with id" << node.id << "in channel" << channel;
+        return;
+    }
+    m_channelNodes[channel][index] = node;
+}
+
+/**
+ * @brief Ends an undo/redo step: drops transient interaction state, reselects the
+ * given nodes where they still exist and notifies listeners.
+ */
+void CurveWidget::finishRestore(const QVector<quint32>& selectedIds) {
     m_selectedNodeIndices.clear();
+    for (quint32 id : selectedIds) {
+        const int index = indexOfNodeId(id);
+        if (index >= 0) m_selectedNodeIndices.insert(index);
+    }
     m_currentDrag = {SelectedPart::NONE, -1};
     m_dragging = false;
     m_isBoxSelecting = false;
@@ -882,12 +1124,10 @@ void CurveWidget::restoreAllChannelNodes(const QMap<ActiveChannel, QVector<Curve
     m_stateBeforeAction.clear();
 
     update();
-    emit curveChanged();
+    notifyCurveChanged();
     emit selectionChanged();
-    qDebug() << "Curve state restored via Undo/Redo.";
 }
 
-
 // --- Private Helper Functions ---
 
 /**
@@ -1041,9 +1281,14 @@ CurveWidget::ClosestSegmentResult CurveWidget::findClosestSegment(const QPoint&
 void CurveWidget::applyAlignmentSnap(int nodeIndex, CurveWidget::SelectedPart movedHandlePart) {
     QVector<CurveNode>& activeNodes = getActiveNodes();
     if (nodeIndex <= 0 || nodeIndex >= activeNodes.size() - 1) return;
-    if (movedHandlePart != SelectedPart::HANDLE_IN && movedHandlePart != SelectedPart::HANDLE_OUT) return;
+    snapOppositeHandle(activeNodes[nodeIndex], movedHandlePart);
+}
 
-    CurveNode& node = activeNodes[nodeIndex];
+/**
+ * @brief Alignment snap for a single interior node of any channel.
+ */
+void CurveWidget::snapOppositeHandle(CurveNode& node, SelectedPart movedHandlePart) {
+    if (movedHandlePart != SelectedPart::HANDLE_IN && movedHandlePart != SelectedPart::HANDLE_OUT) return;
     if (node.alignment == HandleAlignment::Free) return;
 
     const QPointF& mainPt = node.mainPoint;
@@ -1101,6 +1346,473 @@ void CurveWidget::sortActiveNodes() {
     qDebug() << "Warning: sortActiveNodes called - selection indices may be invalid if order changed.";
 }
 
+/**
+ * @brief Replaces the nodes of the given channels as one undoable edit named text, e.g.
+ * with generated curves. Nodes without an id get fresh ones; the selection is cleared.
+ * @return true if the curves changed.
+ */
+bool CurveWidget::replaceChannelNodes(const QMap<ActiveChannel, QVector<CurveNode>>& nodes, const QString& text) {
+    const QMap<ActiveChannel, QVector<CurveNode>> stateBefore = m_channelNodes;
+    for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+        if (it.value().size() < 2) continue;
+        QVector<CurveNode>& channelNodes = m_channelNodes[it.key()];
+        channelNodes = it.value();
+        assignNodeIds(channelNodes);
+        m_nodeIndexById.remove(it.key());
+    }
+    if (!pushCurveChange(stateBefore, text)) {
+        // Same curves, but the copies got fresh ids; keep the old ones.
+        m_channelNodes = stateBefore;
+        m_nodeIndexById.clear();
+        return false;
+    }
+
+    m_selectedNodeIndices.clear();
+    m_currentDrag = {SelectedPart::NONE, -1};
+
+    update();
+    notifyCurveChanged();
+    emit selectionChanged();
+    return true;
+}
+
+/**
+ * @brief Records the change from stateBefore to the current nodes as one compact undo step.
+ * The change is already applied, so pushing does not touch the widget.
+ * @return false if nothing changed.
+ */
+bool CurveWidget::pushCurveChange(const QMap<ActiveChannel, QVector<CurveNode>>& stateBefore, const QString& text) {
+    CurveDeltaCommand *command = CurveDeltaCommand::fromStates(this, stateBefore, m_channelNodes, text);
+    if (!command) return false;
+    command->markApplied();
+    m_undoStack.push(command);
+    return true;
+}
+
+/**
+ * @brief Gives every node without an id a fresh one, and keeps m_nextNodeId above all ids in use.
+ */
+void CurveWidget::assignNodeIds(QVector<CurveNode>& nodes) {
+    for (const CurveNode& node : std::as_const(nodes)) {
+        if (node.id >= m_nextNodeId) m_nextNodeId = node.id + 1;
+    }
+    for (CurveNode& node : nodes) {
+        if (node.id == 0) node.id = m_nextNodeId++;
+    }
+}
+
+/**
+ * @brief Swaps two nodes of a channel. In the active channel their selection state
+ * and the drag target move along.
+ */
+void CurveWidget::swapNodes(ActiveChannel channel, int a, int b) {
+    QVector<CurveNode>& nodes = m_channelNodes.find(channel).value();
+    std::swap(nodes[a], nodes[b]);
+    m_nodeIndexById.remove(channel);
+    if (channel != m_activeChannel) return;
+
+    const bool aSelected = m_selectedNodeIndices.contains(a);
+    const bool bSelected = m_selectedNodeIndices.contains(b);
+    if (aSelected != bSelected) {
+        m_selectedNodeIndices.toggle(a);
+        m_selectedNodeIndices.toggle(b);
+    }
+
+    if (m_currentDrag.nodeIndex == a) m_currentDrag.nodeIndex = b;
+    else if (m_currentDrag.nodeIndex == b) m_currentDrag.nodeIndex = a;
+}
+
+/**
+ * @brief Restores X order after the given interior nodes moved in one direction.
+ *
+ * Each moved node is walked past the neighbours it overtook, like one insertion
+ * sort step. Nodes are visited starting from the side they moved towards, so a
+ * node stops at the already placed moved nodes ahead of it and untouched nodes
+ * keep their relative order. Cost is proportional to the number of nodes crossed.
+ */
+void CurveWidget::fixNodeOrder(ActiveChannel channel, const QVector<int>& movedIndices, bool movedRight) {
+    auto channelIt = m_channelNodes.find(channel);
+    if (channelIt == m_channelNodes.end()) return;
+    QVector<CurveNode>& nodes = channelIt.value();
+    const int lastIndex = nodes.size() - 1;
+    if (lastIndex < 2) return;
+
+    auto visit = [&](int index) {
+        if (index <= 0 || index >= lastIndex) return;
+        if (movedRight) {
+            while (index + 1 < lastIndex && nodes[index + 1].mainPoint.x() < nodes[index].mainPoint.x()) {
+                swapNodes(channel, index, index + 1);
+                ++index;
+            }
+        } else {
+            while (index - 1 > 0 && nodes[index - 1].mainPoint.x() > nodes[index].mainPoint.x()) {
+                swapNodes(channel, index, index - 1);
+                --index;
+            }
+        }
+    };
+
+    if (movedRight) {
+        for (auto it = movedIndices.crbegin(); it != movedIndices.crend(); ++it) visit(*it);
+    } else {
+        for (int index : movedIndices) visit(index);
+    }
+}
+
+/**
+ * @brief Moves one node of a channel by delta along with its handles. End nodes keep
+ * their X, interior nodes stay inside (0, 1) and Y is clamped to [0, 1].
+ */
+void CurveWidget::moveNodeBy(QVector<CurveNode>& nodes, int index, const QPointF& delta) {
+    const int lastIndex = nodes.size() - 1;
+    if (index < 0 || index > lastIndex) return;
+
+    const qreal epsilon = 1e-9;
+    const qreal handleCoincidenceThresholdSq = 1e-12;
+    CurveNode& nodeToMove = nodes[index];
+    QPointF oldMainPos = nodeToMove.mainPoint;
+
+    QPointF newMainPos = oldMainPos + delta;
+    if (index == 0 || index == lastIndex) newMainPos.setX(oldMainPos.x());
+    else newMainPos.setX(std::max(epsilon, std::min(1.0 - epsilon, newMainPos.x())));
+    newMainPos.setY(std::max(0.0, std::min(1.0, newMainPos.y())));
+    const QPointF nodeDelta = newMainPos - oldMainPos;
+    nodeToMove.mainPoint = newMainPos;
+
+    if (QPointF::dotProduct(nodeToMove.handleIn - oldMainPos, nodeToMove.handleIn - oldMainPos) > handleCoincidenceThresholdSq) nodeToMove.handleIn += nodeDelta;
+    if (QPointF::dotProduct(nodeToMove.handleOut - oldMainPos, nodeToMove.handleOut - oldMainPos) > handleCoincidenceThresholdSq) nodeToMove.handleOut += nodeDelta;
+
+    clampHandlePosition(nodeToMove.handleIn);
+    clampHandlePosition(nodeToMove.handleOut);
+
+    if (index > 0 && index < lastIndex) snapOppositeHandle(nodeToMove, SelectedPart::HANDLE_OUT);
+}
+
+/**
+ * @brief Returns the channels that follow edits made on the active channel.
+ */
+QList<CurveWidget::ActiveChannel> CurveWidget::linkedChannels() const {
+    QList<ActiveChannel> channels;
+    if (!m_channelsLinked) return channels;
+    for (auto it = m_channelNodes.constBegin(); it != m_channelNodes.constEnd(); ++it) {
+        if (it.key() != m_activeChannel) channels.append(it.key());
+    }
+    return channels;
+}
+
+/**
+ * @brief Binary-searches X-sorted nodes for one whose main point sits at x. Returns -1 if none does.
+ */
+int CurveWidget::findNodeAtX(const QVector<CurveNode>& nodes, qreal x) {
+    const qreal tolerance = 1e-6;
+    auto it = std::lower_bound(nodes.cbegin(), nodes.cend(), x - tolerance,
+                               [](const CurveNode& node, qreal value) { return node.mainPoint.x() < value; });
+    if (it == nodes.cend() || it->mainPoint.x() > x + tolerance) return -1;
+    return static_cast<int>(it - nodes.cbegin());
+}
+
+/**
+ * @brief Splits a linked channel's segment at x so it gets a node there, unless it already has one.
+ * The curve's shape is unchanged by the split.
+ */
+void CurveWidget::insertLinkedNodeAtX(ActiveChannel channel, qreal x) {
+    QVector<CurveNode>& nodes = m_channelNodes.find(channel).value();
+    if (nodes.size() < 2 || findNodeAtX(nodes, x) >= 0) return;
+    if (x <= nodes.first().mainPoint.x() || x >= nodes.last().mainPoint.x()) return;
+
+    auto it = std::lower_bound(nodes.cbegin(), nodes.cend(), x,
+                               [](const CurveNode& node, qreal value) { return node.mainPoint.x() < value; });
+    const int i = static_cast<int>(it - nodes.cbegin()) - 1;
+    const qreal t = CurveSampler::solveSegmentT(nodes[i], nodes[i+1], x);
+
+    SubdivisionResult split = subdivideBezier(nodes[i].mainPoint, nodes[i].handleOut, nodes[i+1].handleIn, nodes[i+1].mainPoint, t);
+    CurveNode newNode(QPointF(x, split.pointOnCurve.y()));
+    newNode.handleIn = split.handle2_Seg1; newNode.handleOut = split.handle1_Seg2;
+    newNode.alignment = HandleAlignment::Aligned;
+    newNode.id = m_nextNodeId++;
+    nodes[i].handleOut = split.handle1_Seg1; nodes[i+1].handleIn = split.handle2_Seg2;
+    nodes.insert(i + 1, newNode);
+    m_nodeIndexById.remove(channel);
+}
+
+/**
+ * @brief Removes the interior nodes of every linked channel that sit at one of the given X positions.
+ */
+void CurveWidget::removeLinkedNodesAtX(const QVector<qreal>& xs) {
+    for (ActiveChannel channel : linkedChannels()) {
+        QVector<CurveNode>& nodes = m_channelNodes.find(channel).value();
+        QVector<int> indices;
+        for (qreal x : xs) {
+            const int index = findNodeAtX(nodes, x);
+            if (index > 0 && index < nodes.size() - 1) indices.append(index);
+        }
+        std::sort(indices.begin(), indices.end(), std::greater<int>());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        for (int index : indices) nodes.remove(index);
+        if (!indices.isEmpty()) m_nodeIndexById.remove(channel);
+    }
+}
+
+/**
+ * @brief Links or unlinks the channels. While linked, node drags, inserts and deletes on
+ * the active channel are applied to the other channels' nodes at the same X, and all
+ * channels are drawn.
+ */
+void CurveWidget::setChannelsLinked(bool linked) {
+    if (m_channelsLinked == linked) return;
+    m_channelsLinked = linked;
+    update();
+}
+
+bool CurveWidget::channelsLinked() const {
+    return m_channelsLinked;
+}
+
+/**
+ * @brief Drops the cached curve paths and id lookups. Called for documents that are
+ * not shown; everything is rebuilt lazily on the next paint or lookup.
+ */
+void CurveWidget::releaseRenderCaches() {
+    m_pathCache.clear();
+    m_nodeIndexById.clear();
+}
+
+/**
+ * @brief Returns the widget-space path of a channel's curve, rebuilding it only when
+ * the channel's nodes or the widget size changed since the last call.
+ *
+ * The cache keeps a shallow copy of the node list, so any write to the channel
+ * detaches it and the data pointers stop matching.
+ */
+const QPainterPath& CurveWidget::channelPath(ActiveChannel channel) const {
+    const QVector<CurveNode>& nodes = m_channelNodes.find(channel).value();
+    CachedPath& cached = m_pathCache[channel];
+    if (cached.nodes.constData() == nodes.constData() && cached.nodes.size() == nodes.size() &&
+        cached.widgetSize == size() && !cached.path.isEmpty()) {
+        return cached.path;
+    }
+
+    QPainterPath path;
+    if (nodes.size() >= 2) {
+        path.moveTo(mapToWidget(nodes[0].mainPoint));
+        for (int i = 0; i < nodes.size() - 1; ++i) {
+            path.cubicTo(mapToWidget(nodes[i].handleOut), mapToWidget(nodes[i+1].handleIn), mapToWidget(nodes[i+1].mainPoint));
+        }
+    }
+    cached.nodes = nodes;
+    cached.widgetSize = size();
+    cached.path = path;
+    return cached.path;
+}
+
+/**
+ * @brief Adds the active channel's nodes whose main point lies inside a widget-space rectangle.
+ * Nodes are ordered by X, so only the slice whose X falls within the box is tested.
+ */
+void CurveWidget::selectNodesInBox(const QRect& widgetRect) {
+    const QVector<CurveNode>& activeNodes = getActiveNodes();
+    const qreal minX = mapFromWidget(QPoint(widgetRect.left() - 1, widgetRect.top())).x();
+    const qreal maxX = mapFromWidget(QPoint(widgetRect.right() + 1, widgetRect.top())).x();
+
+    auto first = std::lower_bound(activeNodes.cbegin(), activeNodes.cend(), minX,
+                                  [](const CurveNode& node, qreal x) { return node.mainPoint.x() < x; });
+    for (auto it = first; it != activeNodes.cend() && it->mainPoint.x() <= maxX; ++it) {
+        if (widgetRect.contains(mapToWidget(it->mainPoint).toPoint())) {
+            m_selectedNodeIndices.insert(static_cast<int>(it - activeNodes.cbegin()));
+        }
+    }
+}
+
+/**
+ * @brief Returns copies of the selected nodes of the active channel, in X order.
+ */
+QVector<CurveWidget::CurveNode> CurveWidget::selectedNodes() const {
+    const QVector<CurveNode>& activeNodes = getActiveNodes();
+    QVector<CurveNode> nodes;
+    nodes.reserve(m_selectedNodeIndices.size());
+    for (int index : m_selectedNodeIndices.indices()) {
+        if (index >= 0 && index < activeNodes.size()) nodes.append(activeNodes[index]);
+    }
+    return nodes;
+}
+
+/**
+ * @brief Puts the selected nodes on the clipboard.
+ */
+void CurveWidget::copySelection() {
+    const QVector<CurveNode> nodes = selectedNodes();
+    if (nodes.isEmpty()) return;
+    NodeClipboard::copy(nodes);
+    qDebug() << "Copied" << nodes.size() << "node(s) to the clipboard.";
+}
+
+/**
+ * @brief Pastes clipboard nodes into the active channel as one undo step.
+ *
+ * With two or more nodes selected, the pasted run is rescaled in X to span from the
+ * first to the last selected node and replaces that range. Otherwise it keeps its
+ * own X span and replaces whatever lies within it. The pasted nodes end up selected.
+ */
+void CurveWidget::pasteNodes() {
+    QVector<CurveNode> nodes;
+    if (!NodeClipboard::paste(nodes) || nodes.isEmpty()) {
+        qDebug() << "Paste: the clipboard holds no curve nodes.";
+        return;
+    }
+    std::stable_sort(nodes.begin(), nodes.end(),
+                     [](const CurveNode& a, const CurveNode& b) { return a.mainPoint.x() < b.mainPoint.x(); });
+
+    qreal a = std::max(0.0, std::min(1.0, nodes.first().mainPoint.x()));
+    qreal b = std::max(a, std::min(1.0, nodes.last().mainPoint.x()));
+    if (m_selectedNodeIndices.size() >= 2) {
+        const QVector<CurveNode>& activeNodes = getActiveNodes();
+        a = activeNodes[m_selectedNodeIndices.indices().first()].mainPoint.x();
+        b = activeNodes[m_selectedNodeIndices.indices().last()].mainPoint.x();
+    }
+
+    nodes = rescaleNodesX(nodes, a, b);
+    for (CurveNode& node : nodes) {
+        node.mainPoint.setY(std::max(0.0, std::min(1.0, node.mainPoint.y())));
+        clampHandlePosition(node.handleIn);
+        clampHandlePosition(node.handleOut);
+    }
+    assignNodeIds(nodes);
+
+    const CurveDeltaCommand::Splice splice = intervalSplice(m_activeChannel, getActiveNodes(), nodes);
+    if (CurveDeltaCommand::isEmpty(splice)) return;
+    QVector<quint32> pastedIds;
+    for (const CurveNode& node : splice.after) pastedIds.append(node.id);
+
+    m_undoStack.push(new CurveDeltaCommand(this, {splice}, "Paste Nodes"));
+    selectNodeIds(pastedIds);
+}
+
+/**
+ * @brief Copies the selected run of nodes into the same X range of the two other
+ * channels, replacing what was there, as one undo step.
+ */
+void CurveWidget::duplicateSelectionToOtherChannels() {
+    const QVector<CurveNode> nodes = selectedNodes();
+    if (nodes.isEmpty()) return;
+
+    QVector<CurveDeltaCommand::Splice> splices;
+    for (auto it = m_channelNodes.cbegin(); it != m_channelNodes.cend(); ++it) {
+        if (it.key() == m_activeChannel) continue;
+        QVector<CurveNode> copies = nodes;
+        for (CurveNode& node : copies) node.id = 0;
+        assignNodeIds(copies);
+        const CurveDeltaCommand::Splice splice = intervalSplice(it.key(), it.value(), copies);
+        if (!CurveDeltaCommand::isEmpty(splice)) splices.append(splice);
+    }
+    if (splices.isEmpty()) return;
+
+    m_undoStack.push(new CurveDeltaCommand(this, splices, "Duplicate to Other Channels"));
+}
+
+/**
+ * @brief Selects every node of the active channel.
+ */
+void CurveWidget::selectAllNodes() {
+    selectNodeRange(0, getActiveNodes().size() - 1);
+}
+
+/**
+ * @brief Adds the nodes with indices in [first, last] to the selection.
+ */
+void CurveWidget::selectNodeRange(int first, int last) {
+    const int nodeCount = getActiveNodes().size();
+    first = std::max(0, first);
+    last = std::min(nodeCount - 1, last);
+    if (first > last) return;
+
+    const int countBefore = m_selectedNodeIndices.size();
+    m_selectedNodeIndices.selectRange(first, last);
+    if (m_selectedNodeIndices.size() != countBefore) {
+        update();
+        emit selectionChanged();
+    }
+}
+
+/**
+ * @brief Selects every unselected node of the active channel and deselects the rest.
+ */
+void CurveWidget::invertSelection() {
+    m_selectedNodeIndices.invert(getActiveNodes().size());
+    update();
+    emit selectionChanged();
+}
+
+/**
+ * @brief Bumps the revision and emits curveEdited() and curveChanged(). The changes are
+ * found by comparing against the nodes of the previous notification; channels that were
+ * not written to still share their data with that snapshot and are skipped unread.
+ */
+void CurveWidget::notifyCurveChanged() {
+    m_nodeIndexById.clear();
+    ++m_revision;
+
+    QVector<CurveChange> changes;
+    for (auto it = m_channelNodes.constBegin(); it != m_channelNodes.constEnd(); ++it) {
+        const QVector<CurveNode> before = m_notifiedNodes.value(it.key());
+        if (before.constData() == it.value().constData() && before.size() == it.value().size()) continue;
+
+        CurveChange change;
+        change.channel = it.key();
+        change.revision = m_revision;
+        if (describeChange(before, it.value(), change)) {
+            m_boundsCache.remove(change.channel);
+            changes.append(change);
+        }
+    }
+    m_notifiedNodes = m_channelNodes;
+
+    if (!changes.isEmpty()) {
+        emit curveEdited(changes);
+    }
+    emit curveChanged();
+}
+
+/**
+ * @brief Fills in the x range and kind of the edit that turned before into after.
+ * Only the segments touching a changed node move, so the range runs from the last
+ * unchanged node in front of the edit to the first unchanged node behind it.
+ * @return false if the two lists are identical.
+ */
+bool CurveWidget::describeChange(const QVector<CurveNode>& before, const QVector<CurveNode>& after, CurveChange& change) {
+    auto same = [](const CurveNode& a, const CurveNode& b) { return a == b && a.id == b.id; };
+    const int shorter = std::min(before.size(), after.size());
+
+    int prefix = 0;
+    while (prefix < shorter && same(before[prefix], after[prefix])) ++prefix;
+    if (prefix == before.size() && prefix == after.size()) return false;
+
+    int suffix = 0;
+    while (suffix < shorter - prefix &&
+           same(before[before.size() - 1 - suffix], after[after.size() - 1 - suffix])) {
+        ++suffix;
+    }
+
+    // Outside the first and last node the curve is extended flat, so an edit at
+    // either end reaches the border of the unit range.
+    qreal xMin = (prefix > 0) ? after[prefix - 1].mainPoint.x() : 0.0;
+    qreal xMax = (suffix > 0) ? after[after.size() - suffix].mainPoint.x() : 1.0;
+    bool structural = before.size() != after.size();
+    for (int i = prefix; i < before.size() - suffix; ++i) {
+        xMin = std::min(xMin, before[i].mainPoint.x());
+        xMax = std::max(xMax, before[i].mainPoint.x());
+    }
+    for (int i = prefix; i < after.size() - suffix; ++i) {
+        xMin = std::min(xMin, after[i].mainPoint.x());
+        xMax = std::max(xMax, after[i].mainPoint.x());
+        if (!structural && before[i].id != after[i].id) structural = true;
+    }
+
+    change.xMin = std::max(0.0, xMin);
+    change.xMax = std::min(1.0, xMax);
+    change.structural = structural;
+    return true;
+}
+
 void CurveWidget::setHandlesClamping(bool clamp) {
     if (m_clampHandles != clamp) {
         m_clampHandles = clamp;
@@ -1123,6 +1835,16 @@ void CurveWidget::clampHandlePosition(QPointF& handlePos) {
 void CurveWidget::setAllChannelNodes(const QMap<ActiveChannel, QVector<CurveNode>>& allNodes) {
 
     m_channelNodes = allNodes;
+    // Ids read from a file must not be handed out again to nodes of another channel.
+    for (auto it = m_channelNodes.cbegin(); it != m_channelNodes.cend(); ++it) {
+        for (const CurveNode& node : it.value()) {
+            if (node.id >= m_nextNodeId) m_nextNodeId = node.id + 1;
+        }
+    }
+    for (auto it = m_channelNodes.begin(); it != m_channelNodes.end(); ++it) {
+        assignNodeIds(it.value());
+    }
+    m_nodeIndexById.clear();
 
     m_selectedNodeIndices.clear();
     m_currentDrag = {SelectedPart::NONE, -1};
@@ -1139,6 +1861,6 @@ void CurveWidget::setAllChannelNodes(const QMap<ActiveChannel, QVector<CurveNode
     }
 
     update();
-    emit curveChanged();
+    notifyCurveChanged();
     emit selectionChanged();
 }
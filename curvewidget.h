@@ -6,20 +6,27 @@
 #include <QVector>
 #include <QPointF>
 #include <QMap>
+#include <QHash>
+#include <QList>
+#include <QPainterPath>
+#include <QSize>
 #include <QColor>
 #include <QUndoStack>
-#include <QSet>
 #include <QRect>
+#include <QRectF>
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QPaintEvent>
 #include <QResizeEvent>
 
+// Project Includes
+#include "nodeselection.h"
+
 // Standard Library Includes
 #include <limits> // Required for ClosestSegmentResult initialization
 
 // Forward Declarations
-class SetCurveStateCommand;
+class CurveDeltaCommand;
 
 /**
  * @brief A widget for interactively editing Bézier curves,
@@ -60,12 +67,59 @@ public:
         QPointF handleIn;
         QPointF handleOut;
         HandleAlignment alignment;
+        quint32 id; // Stable identity within a widget, 0 = unassigned. Ignored by operator==.
 
         CurveNode(QPointF p = QPointF());
         bool operator==(const CurveNode& other) const;
         bool operator!=(const CurveNode& other) const { return !(*this == other); }
     };
 
+    /**
+     * @brief An affine edit applied to selected nodes: scale (and optionally flip)
+     * about a pivot, then offset. Handles move with their nodes.
+     */
+    struct NodeTransform {
+        QPointF pivot;
+        qreal scaleX = 1.0;
+        qreal scaleY = 1.0;
+        QPointF offset;
+        bool flipX = false;
+        bool flipY = false;
+
+        QPointF map(const QPointF& p) const;
+        bool isIdentity() const;
+    };
+
+    /**
+     * @brief What one notification changed in one channel. Outside [xMin, xMax] the
+     * channel's y(x) is the same as before. structural is true when nodes were added,
+     * removed or reordered, false when existing nodes only moved or changed alignment.
+     */
+    struct CurveChange {
+        ActiveChannel channel = ActiveChannel::RED;
+        qreal xMin = 0.0;
+        qreal xMax = 1.0;
+        bool structural = false;
+        quint64 revision = 0;
+    };
+
+    /**
+     * @brief Range and area of one channel's curve before any clamping to [0, 1].
+     * minX/maxX are where the extremes are reached; integral is the area under
+     * y(x) over [0, 1], i.e. the mean output value.
+     */
+    struct ChannelBounds {
+        qreal minY = 0.0;
+        qreal minX = 0.0;
+        qreal maxY = 1.0;
+        qreal maxX = 1.0;
+        qreal integral = 0.5;
+
+        qreal overshootBelow() const { return minY < 0.0 ? -minY : 0.0; }
+        qreal overshootAbove() const { return maxY > 1.0 ? maxY - 1.0 : 0.0; }
+        bool overshoots() const { return minY < 0.0 || maxY > 1.0; }
+    };
+
     // --- Constructor ---
     explicit CurveWidget(QWidget *parent = nullptr);
 
@@ -77,8 +131,19 @@ public:
     ActiveChannel getActiveChannel() const;
     QUndoStack* undoStack();
     int getActiveNodeCount() const;
-    QSet<int> getSelectedIndices() const;
+    const NodeSelection& getSelectedIndices() const;
     HandleAlignment getAlignment(int nodeIndex) const;
+    quint64 revision() const;
+    ChannelBounds channelBounds(ActiveChannel channel) const;
+    int indexOfNodeId(quint32 id) const;
+    int indexOfNodeId(ActiveChannel channel, quint32 id) const;
+    QVector<quint32> selectedNodeIds() const;
+    QVector<CurveNode> selectedNodes() const;
+    bool channelsLinked() const;
+    QRectF selectionBounds() const;
+    bool transformSelection(const NodeTransform& transform);
+    bool replaceChannelNodes(const QMap<ActiveChannel, QVector<CurveNode>>& nodes, const QString& text);
+    void releaseRenderCaches();
 
 public slots:
     // --- Public Slots ---
@@ -87,6 +152,14 @@ public slots:
     void setDrawInactiveChannels(bool draw);
     void setHandlesClamping(bool clamp);
     void setAllChannelNodes(const QMap<ActiveChannel, QVector<CurveNode>>& allNodes);
+    void selectAllNodes();
+    void selectNodeRange(int first, int last);
+    void invertSelection();
+    void selectNodeIds(const QVector<quint32>& ids);
+    void copySelection();
+    void pasteNodes();
+    void duplicateSelectionToOtherChannels();
+    void setChannelsLinked(bool linked);
 
 signals:
     // --- Signals ---
@@ -95,6 +168,13 @@ signals:
      */
     void curveChanged();
 
+    /**
+     * @brief Emitted right before curveChanged() with one entry per channel that
+     * actually changed, so listeners can skip other channels and redo only the
+     * affected x range. Not emitted when a notification changed nothing.
+     */
+    void curveEdited(const QVector<CurveWidget::CurveChange>& changes);
+
     /**
      * @brief Emitted when the set of selected main points changes,
      * or when a handle is selected/deselected.
@@ -112,6 +192,9 @@ protected:
 
     // --- Protected Methods for Undo/Redo ---
     void restoreAllChannelNodes(const QMap<ActiveChannel, QVector<CurveNode>>& allNodes);
+    void replaceNodeRange(ActiveChannel channel, int index, int count, const QVector<CurveNode>& nodes);
+    void replaceNodeById(ActiveChannel channel, const CurveNode& node);
+    void finishRestore(const QVector<quint32>& selectedIds);
 
 private:
     // --- Private Helper Enums/Structs ---
@@ -134,6 +217,15 @@ private:
         int nodeIndex = -1;
     };
 
+    /**
+     * @brief A channel's curve in widget coordinates plus what it was built from.
+     */
+    struct CachedPath {
+        QVector<CurveNode> nodes;
+        QSize widgetSize;
+        QPainterPath path;
+    };
+
     /**
      * @brief Stores results when finding the closest point on a curve segment.
      */
@@ -153,6 +245,20 @@ private:
     QVector<CurveNode>& getActiveNodes();
     const QVector<CurveNode>& getActiveNodes() const;
     void clampHandlePosition(QPointF& handlePos);
+    void notifyCurveChanged();
+    static bool describeChange(const QVector<CurveNode>& before, const QVector<CurveNode>& after, CurveChange& change);
+    void selectNodesInBox(const QRect& widgetRect);
+    void assignNodeIds(QVector<CurveNode>& nodes);
+    bool pushCurveChange(const QMap<ActiveChannel, QVector<CurveNode>>& stateBefore, const QString& text);
+    void swapNodes(ActiveChannel channel, int a, int b);
+    void fixNodeOrder(ActiveChannel channel, const QVector<int>& movedIndices, bool movedRight);
+    void moveNodeBy(QVector<CurveNode>& nodes, int index, const QPointF& delta);
+    void snapOppositeHandle(CurveNode& node, SelectedPart movedHandlePart);
+    QList<ActiveChannel> linkedChannels() const;
+    static int findNodeAtX(const QVector<CurveNode>& nodes, qreal x);
+    void insertLinkedNodeAtX(ActiveChannel channel, qreal x);
+    void removeLinkedNodesAtX(const QVector<qreal>& xs);
+    const QPainterPath& channelPath(ActiveChannel channel) const;
 
     // --- Private Member Variables ---
     QMap<ActiveChannel, QVector<CurveNode>> m_channelNodes;
@@ -160,7 +266,7 @@ private:
     QUndoStack m_undoStack;
     QMap<ActiveChannel, QVector<CurveNode>> m_stateBeforeAction;
     bool m_dragging;
-    QSet<int> m_selectedNodeIndices;
+    NodeSelection m_selectedNodeIndices;
     SelectionInfo m_currentDrag;
     bool m_isBoxSelecting;
     QPoint m_boxSelectionStartPoint;
@@ -170,9 +276,16 @@ private:
     bool m_isDarkMode;
     bool m_drawInactiveChannels;
     bool m_clampHandles;
+    quint64 m_revision;
+    quint32 m_nextNodeId;
+    mutable QMap<ActiveChannel, QHash<quint32, int>> m_nodeIndexById;
+    bool m_channelsLinked;
+    mutable QMap<ActiveChannel, CachedPath> m_pathCache;
+    QMap<ActiveChannel, QVector<CurveNode>> m_notifiedNodes; // Shallow copy taken at the last notification.
+    mutable QMap<ActiveChannel, ChannelBounds> m_boundsCache;
 
     // --- Friend Declaration ---
-    friend class SetCurveStateCommand;
+    friend class CurveDeltaCommand;
 };
 
 #endif
@@ -0,0 +1,90 @@
+#include "framebakedialog.h"
+
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+FrameBakeDialog::FrameBakeDialog(const FrameTiming& initial, QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Bake Frames"));
+
+    m_duration = new QDoubleSpinBox(this);
+    m_duration->setDecimals(3);
+    m_duration->setRange(0.001, 3600.0);
+    m_duration->setSuffix(tr(" s"));
+    m_duration->setValue(initial.duration);
+
+    m_fps = new QDoubleSpinBox(this);
+    m_fps->setDecimals(3);
+    m_fps->setRange(0.001, 1000.0);
+    m_fps->setValue(initial.fps);
+
+    m_supersamples = new QSpinBox(this);
+    m_supersamples->setRange(1, 256);
+    m_supersamples->setValue(initial.supersamples);
+    m_supersamples->setToolTip(tr("Samples averaged over each frame's interval.\n1 samples exactly at the frame time."));
+
+    m_loop = new QCheckBox(tr("Loop (leave out the frame at the end)"), this);
+    m_loop->setChecked(initial.loop);
+
+    m_frameCountLabel = new QLabel(this);
+    m_frameCountLabel->setWordWrap(true);
+
+    QFormLayout *form = new QFormLayout;
+    form->addRow(tr("Duration:"), m_duration);
+    form->addRow(tr("Frames per second:"), m_fps);
+    form->addRow(tr("Samples per frame:"), m_supersamples);
+    form->addRow(m_loop);
+    form->addRow(tr("Frames:"), m_frameCountLabel);
+
+    m_buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    QDialogButtonBox *buttons = m_buttons;
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(form);
+    layout->addWidget(buttons);
+
+    connect(m_duration, &QDoubleSpinBox::valueChanged, this, &FrameBakeDialog::updateFrameCount);
+    connect(m_fps, &QDoubleSpinBox::valueChanged, this, &FrameBakeDialog::updateFrameCount);
+    connect(m_supersamples, &QSpinBox::valueChanged, this, &FrameBakeDialog::updateFrameCount);
+    connect(m_loop, &QCheckBox::toggled, this, &FrameBakeDialog::updateFrameCount);
+    updateFrameCount();
+}
+
+/**
+ * @brief Returns the timing described by the current field values.
+ */
+FrameTiming FrameBakeDialog::timing() const
+{
+    FrameTiming result;
+    result.duration = m_duration->value();
+    result.fps = m_fps->value();
+    result.supersamples = m_supersamples->value();
+    result.loop = m_loop->isChecked();
+    return result;
+}
+
+/**
+ * @brief Shows the frame count, or the sample limit when frames x samples per frame
+ * exceed it (OK is disabled then).
+ */
+void FrameBakeDialog::updateFrameCount()
+{
+    const FrameTiming current = timing();
+    const bool valid = current.isValid();
+    if (valid) {
+        m_frameCountLabel->setText(QString::number(current.frameCount()));
+    } else {
+        m_frameCountLabel->setText(tr("%1 samples, more than the limit of %2; lower the duration, rate or samples per frame")
+                                   .arg(current.sampleCount()).arg(FrameTiming::MaxSamples));
+    }
+    m_buttons->button(QDialogButtonBox::Ok)->setEnabled(valid);
+}
@@ -0,0 +1,42 @@
+#ifndef FRAMEBAKEDIALOG_H
+#define FRAMEBAKEDIALOG_H
+
+// Qt Includes
+#include <QDialog>
+
+// Project Includes
+#include "lutexport.h" // Required for FrameTiming
+
+// Forward Declarations
+class QCheckBox;
+class QDialogButtonBox;
+class QDoubleSpinBox;
+class QLabel;
+class QSpinBox;
+
+/**
+ * @brief Asks for the duration, frame rate, supersampling and looping of a
+ * frame-exact bake, and shows how many frames that makes.
+ */
+class FrameBakeDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit FrameBakeDialog(const FrameTiming& initial, QWidget *parent = nullptr);
+
+    FrameTiming timing() const;
+
+private slots:
+    void updateFrameCount();
+
+private:
+    QDoubleSpinBox *m_duration;
+    QDoubleSpinBox *m_fps;
+    QSpinBox *m_supersamples;
+    QCheckBox *m_loop;
+    QLabel *m_frameCountLabel;
+    QDialogButtonBox *m_buttons;
+};
+
+#endif
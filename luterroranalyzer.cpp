@@ -0,0 +1,161 @@
+#include "luterroranalyzer.h"
+#include "bakeservice.h"
+
+#include <QMetaObject>
+
+#include <algorithm>
+#include <cmath>
+
+LutErrorAnalyzer::LutErrorAnalyzer(QObject *parent)
+    : QObject(parent),
+    m_cache(16),
+    m_busy(false),
+    m_idle(1)
+{
+}
+
+/**
+ * @brief Waits for this analyzer's running job, if any, so it never touches a deleted
+ * object. Its queued result is dropped along with the analyzer; other work on the
+ * shared pool is not waited for.
+ */
+LutErrorAnalyzer::~LutErrorAnalyzer()
+{
+    m_idle.acquire();
+}
+
+/**
+ * @brief Asks for the analysis of the given curves. Emits analysisReady() right away
+ * on a cache hit, otherwise once the worker finishes (unless superseded).
+ */
+void LutErrorAnalyzer::request(const CurveSampler& sampler, const QByteArray& contentKey, int width, int bitDepth)
+{
+    if (width < 1 || (bitDepth != 8 && bitDepth != 16)) {
+        // Nothing to analyze (e.g. 32-bit float); replace the previous result and drop
+        // any pending one so a finishing job cannot show it again.
+        m_latestKey.clear();
+        LutErrorAnalysis none;
+        none.bitDepth = bitDepth;
+        emit analysisReady(none);
+        return;
+    }
+
+    const QByteArray key = cacheKey(contentKey, width, bitDepth);
+    m_latestKey = key;
+
+    if (const LutErrorAnalysis *cached = m_cache.object(key)) {
+        emit analysisReady(*cached);
+        return;
+    }
+
+    m_latest = {sampler, contentKey, width, bitDepth};
+    if (!m_busy) {
+        startJob(m_latest);
+    }
+}
+
+QByteArray LutErrorAnalyzer::cacheKey(const QByteArray& contentKey, int width, int bitDepth)
+{
+    return contentKey + ':' + QByteArray::number(width) + ':' + QByteArray::number(bitDepth);
+}
+
+void LutErrorAnalyzer::startJob(const PendingRequest& job)
+{
+    m_busy = true;
+    m_idle.acquire();
+    const QByteArray key = cacheKey(job.contentKey, job.width, job.bitDepth);
+    BakeService::instance().pool()->start([this, job, key]() {
+        LutErrorAnalysis analysis = analyze(job.sampler, job.contentKey, job.width, job.bitDepth);
+        QMetaObject::invokeMethod(this, [this, key, analysis]() {
+            finishJob(key, analysis);
+        }, Qt::QueuedConnection);
+        m_idle.release();
+    });
+}
+
+void LutErrorAnalyzer::finishJob(const QByteArray& key, const LutErrorAnalysis& analysis)
+{
+    m_busy = false;
+    m_cache.insert(key, new LutErrorAnalysis(analysis));
+
+    if (key == m_latestKey) {
+        emit analysisReady(analysis);
+    } else if (!m_latestKey.isEmpty() && !m_cache.contains(m_latestKey)) {
+        startJob(m_latest);
+    }
+}
+
+/**
+ * @brief Bakes each channel at the given width/bit depth and compares it with the exact curve.
+ * Each texel interval is subdivided so the error of linear filtering between texels is
+ * measured as well as the rounding error at the texels themselves.
+ */
+LutErrorAnalysis LutErrorAnalyzer::analyze(const CurveSampler& sampler, const QByteArray& contentKey, int width, int bitDepth)
+{
+    LutErrorAnalysis analysis;
+    analysis.contentKey = contentKey;
+    analysis.width = width;
+    analysis.bitDepth = bitDepth;
+    if (width < 1) return analysis;
+
+    const int subdivisions = (width > 1) ? 8 : 1;
+    const int denseCount = (width > 1) ? (width - 1) * subdivisions + 1 : 1;
+    const qreal levels = (bitDepth == 16) ? 65535.0 : 255.0;
+    analysis.subdivisions = subdivisions;
+
+    QVector<qreal> xs(denseCount);
+    for (int k = 0; k < denseCount; ++k) {
+        xs[k] = (denseCount == 1) ? 0.0 : static_cast<qreal>(k) / (denseCount - 1);
+    }
+    QVector<qreal> exact(denseCount);
+
+    const CurveWidget::ActiveChannel channels[] = {
+        CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN, CurveWidget::ActiveChannel::BLUE
+    };
+
+    for (CurveWidget::ActiveChannel channel : channels) {
+        sampler.sampleSorted(channel, xs.constData(), denseCount, exact.data());
+
+        LutChannelError result;
+        result.exact.resize(denseCount);
+        result.baked.resize(width);
+        result.texelError.fill(0.0f, width);
+        for (int k = 0; k < denseCount; ++k) result.exact[k] = static_cast<float>(exact[k]);
+
+        for (int i = 0; i < width; ++i) {
+            const qreal value = exact[i * subdivisions];
+            const qreal baked = std::round(value * levels) / levels;
+            result.baked[i] = static_cast<float>(baked);
+            result.texelError[i] = static_cast<float>(std::abs(baked - value));
+        }
+
+        qreal sumSq = 0.0;
+        for (int k = 0; k < denseCount; ++k) {
+            const int texel = std::min(k / subdivisions, width - 1);
+            const int step = k - texel * subdivisions;
+            qreal reconstructed = result.baked[texel];
+            if (step > 0 && texel + 1 < width) {
+                const qreal f = static_cast<qreal>(step) / subdivisions;
+                reconstructed = result.baked[texel] * (1.0 - f) + result.baked[texel + 1] * f;
+            }
+            const float error = static_cast<float>(std::abs(reconstructed - exact[k]));
+            sumSq += static_cast<qreal>(error) * error;
+
+            if (step > 0) {
+                result.texelError[texel] = std::max(result.texelError[texel], error);
+                if (texel + 1 < width) result.texelError[texel + 1] = std::max(result.texelError[texel + 1], error);
+            }
+        }
+
+        for (int i = 0; i < width; ++i) {
+            if (result.texelError[i] > result.maxError) {
+                result.maxError = result.texelError[i];
+                result.worstTexel = i;
+            }
+        }
+        result.rmsError = static_cast<float>(std::sqrt(sumSq / denseCount));
+        analysis.channels.append(result);
+    }
+
+    return analysis;
+}
@@ -0,0 +1,82 @@
+#ifndef LUTERRORANALYZER_H
+#define LUTERRORANALYZER_H
+
+// Qt Includes
+#include <QObject>
+#include <QByteArray>
+#include <QCache>
+#include <QSemaphore>
+#include <QVector>
+
+// Project Includes
+#include "curvesampler.h"
+
+/**
+ * @brief Baked-vs-exact comparison of one channel of a 1D LUT.
+ */
+struct LutChannelError {
+    QVector<float> exact;       // Exact curve at subdivided positions, (width - 1) * subdivisions + 1 values.
+    QVector<float> baked;       // Quantized texel values, one per texel.
+    QVector<float> texelError;  // Worst of quantization and interpolation error touching each texel.
+    float maxError = 0.0f;
+    float rmsError = 0.0f;
+    int worstTexel = -1;
+};
+
+/**
+ * @brief Result of LutErrorAnalyzer::analyze() for the R, G and B channels (in that order).
+ */
+struct LutErrorAnalysis {
+    QByteArray contentKey;
+    int width = 0;
+    int bitDepth = 8;
+    int subdivisions = 1;
+    QVector<LutChannelError> channels;
+
+    bool isValid() const { return width > 0 && !channels.isEmpty(); }
+};
+
+/**
+ * @brief Measures how far a baked LUT (given width and bit depth, linearly
+ * interpolated between texels) deviates from the exact curves.
+ *
+ * Analyses run on the shared BakeService pool using the batch sampler and are
+ * cached per (curve content, width, bit depth), so switching documents reuses
+ * them. Requests made while a job is running are coalesced so only the newest
+ * one is computed next.
+ */
+class LutErrorAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LutErrorAnalyzer(QObject *parent = nullptr);
+    ~LutErrorAnalyzer();
+
+    void request(const CurveSampler& sampler, const QByteArray& contentKey, int width, int bitDepth);
+
+    static LutErrorAnalysis analyze(const CurveSampler& sampler, const QByteArray& contentKey, int width, int bitDepth);
+
+signals:
+    void analysisReady(const LutErrorAnalysis& analysis);
+
+private:
+    struct PendingRequest {
+        CurveSampler sampler;
+        QByteArray contentKey;
+        int width = 0;
+        int bitDepth = 8;
+    };
+
+    static QByteArray cacheKey(const QByteArray& contentKey, int width, int bitDepth);
+    void startJob(const PendingRequest& job);
+    void finishJob(const QByteArray& key, const LutErrorAnalysis& analysis);
+
+    QCache<QByteArray, LutErrorAnalysis> m_cache;
+    PendingRequest m_latest;
+    QByteArray m_latestKey;
+    bool m_busy;
+    QSemaphore m_idle;  // Held by the running job, if any.
+};
+
+#endif
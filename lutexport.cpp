@@ -0,0 +1,520 @@
+#include "lutexport.h"
+#include "bakeservice.h"
+
+#include <QColor>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+/**
+ * @brief FrameTiming::frameCount() without the sample cap, so oversized timing can be
+ * reported; 0 if duration or fps is not positive.
+ */
+qint64 uncappedFrameCount(const FrameTiming& timing)
+{
+    if (!(timing.duration > 0.0 && timing.fps > 0.0)) return 0;
+    // Clamped before the cast so absurd inputs cannot overflow.
+    const qreal frames = std::min(timing.duration * timing.fps, 1e12);
+    const qint64 count = timing.loop ? static_cast<qint64>(std::ceil(frames - 1e-9))
+                                     : static_cast<qint64>(std::floor(frames + 1e-9)) + 1;
+    return std::max<qint64>(1, count);
+}
+
+}
+
+/**
+ * @brief true for positive timing whose samples stay within MaxSamples.
+ */
+bool FrameTiming::isValid() const
+{
+    return duration > 0.0 && fps > 0.0 && supersamples >= 1 && sampleCount() <= MaxSamples;
+}
+
+/**
+ * @brief Number of frames: every frame time up to and including duration, or before
+ * duration when looping (the frame at duration would repeat frame 0).
+ */
+int FrameTiming::frameCount() const
+{
+    return isValid() ? static_cast<int>(uncappedFrameCount(*this)) : 0;
+}
+
+/**
+ * @brief Frames times supersamples, also for timing over the limit (so it can be
+ * reported); 0 if duration, fps or supersamples are not positive.
+ */
+qint64 FrameTiming::sampleCount() const
+{
+    return (supersamples >= 1) ? uncappedFrameCount(*this) * supersamples : 0;
+}
+
+/**
+ * @brief Curve x of a frame time.
+ */
+qreal FrameTiming::frameX(int frame) const
+{
+    return frame / (duration * fps);
+}
+
+QString LutExport::contentName(Content content)
+{
+    switch (content) {
+    case Content::Values:             return QStringLiteral("values");
+    case Content::Integral:           return QStringLiteral("integral");
+    case Content::NormalizedIntegral: return QStringLiteral("integral_normalized");
+    }
+    return QString();
+}
+
+/**
+ * @brief Inverse of contentName(). Unknown names give Content::Values.
+ */
+LutExport::Content LutExport::contentFromName(const QString& name)
+{
+    if (name == contentName(Content::Integral)) return Content::Integral;
+    if (name == contentName(Content::NormalizedIntegral)) return Content::NormalizedIntegral;
+    return Content::Values;
+}
+
+/**
+ * @brief Bakes each channel's running integral at the texel positions i / (width - 1),
+ * integrating the exact (unclamped) curve segment by segment. normalized divides by the
+ * channel's total area so the last texel is 1; a channel with no area is left as is.
+ * Returns width interleaved R, G, B values.
+ */
+QVector<float> LutExport::bakeIntegralRgb(const CurveSampler::ChannelMap& channels, int width, bool normalized)
+{
+    if (width < 1) return QVector<float>();
+
+    const CurveWidget::ActiveChannel order[] = {
+        CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN, CurveWidget::ActiveChannel::BLUE
+    };
+    QVector<qreal> xs(width);
+    for (int i = 0; i < width; ++i) {
+        xs[i] = (width == 1) ? 0.0 : static_cast<qreal>(i) / (width - 1.0);
+    }
+
+    QVector<qreal> column(width);
+    QVector<float> rgb(width * 3);
+    for (int c = 0; c < 3; ++c) {
+        const CurveSampler::NodeList nodes = channels.value(order[c]);
+        CurveSampler::integrateNodesSorted(nodes, xs.constData(), width, column.data());
+
+        qreal scale = 1.0;
+        if (normalized) {
+            const qreal one = 1.0;
+            qreal total = 0.0;
+            CurveSampler::integrateNodesSorted(nodes, &one, 1, &total);
+            if (std::abs(total) > 1e-12) scale = 1.0 / total;
+        }
+        for (int i = 0; i < width; ++i) {
+            rgb[i * 3 + c] = static_cast<float>(column[i] * scale);
+        }
+    }
+    return rgb;
+}
+
+/**
+ * @brief Converts a baked RGB row (as from BakeService::bakeRgb()) into a width x 1
+ * RGB888 (8-bit) or RGBA64 (16-bit) image, clamping to [0, 1].
+ * @return A null image for invalid parameters.
+ */
+QImage LutExport::rgbLutImage(const QVector<float>& rgb, int width, int bitDepth)
+{
+    if (width < 1 || rgb.size() < width * 3 || (bitDepth != 8 && bitDepth != 16)) {
+        qWarning() << "LutExport::rgbLutImage: Invalid parameters.";
+        return QImage();
+    }
+
+    QImage::Format format = (bitDepth == 16) ? QImage::Format_RGBA64 : QImage::Format_RGB888;
+
+    QImage image(width, 1, format);
+    if (image.isNull()) {
+        qWarning() << "Failed to create QImage for" << bitDepth << "-bit LUT (width:" << width << ")";
+        return QImage();
+    }
+
+    for (int i = 0; i < width; ++i) {
+        const float yR_norm = std::max(0.0f, std::min(1.0f, rgb[i * 3 + 0]));
+        const float yG_norm = std::max(0.0f, std::min(1.0f, rgb[i * 3 + 1]));
+        const float yB_norm = std::max(0.0f, std::min(1.0f, rgb[i * 3 + 2]));
+
+        QColor pixelColor = QColor::fromRgbF(yR_norm, yG_norm, yB_norm, 1.0f);
+
+        image.setPixelColor(i, 0, pixelColor);
+    }
+
+    return image;
+}
+
+/**
+ * @brief The smallest range holding [0, 1] and every channel's unclamped extremes.
+ */
+FloatRange LutExport::normalizationRange(const QVector<CurveWidget::ChannelBounds>& bounds)
+{
+    FloatRange range;
+    for (const CurveWidget::ChannelBounds& channel : bounds) {
+        range.min = std::min(range.min, channel.minY);
+        range.max = std::max(range.max, channel.maxY);
+    }
+    return range;
+}
+
+FloatRange LutExport::normalizationRange(const CurveSampler::ChannelMap& channels)
+{
+    QVector<CurveWidget::ChannelBounds> bounds;
+    for (CurveWidget::ActiveChannel channel : { CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN,
+                                                CurveWidget::ActiveChannel::BLUE }) {
+        bounds.append(CurveSampler::channelBounds(channels.value(channel)));
+    }
+    return normalizationRange(bounds);
+}
+
+/**
+ * @brief Samples the unclamped curves at the texel positions i / (width - 1) and
+ * maps them through range. Returns width interleaved R, G, B values.
+ */
+QVector<float> LutExport::bakeFloatRgb(const CurveSampler::ChannelMap& channels, int width, const FloatRange& range)
+{
+    if (width < 1) return QVector<float>();
+
+    const CurveSampler sampler(channels);
+    const CurveWidget::ActiveChannel order[] = {
+        CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN, CurveWidget::ActiveChannel::BLUE
+    };
+    QVector<qreal> column(width);
+    QVector<float> rgb(width * 3);
+    for (int c = 0; c < 3; ++c) {
+        sampler.sampleUniform(order[c], width, column.data(), false);
+        for (int i = 0; i < width; ++i) {
+            rgb[i * 3 + c] = static_cast<float>(range.normalize(column[i]));
+        }
+    }
+    return rgb;
+}
+
+/**
+ * @brief Samples every channel (curve values or running integrals, per content) at the
+ * frame times of timing. Values are clamped to [0, 1] like bakeRgb() unless clampY is
+ * false; integrals are never clamped. With supersampling, each frame averages evenly spaced samples over its
+ * interval [frame, frame + 1) (a full open shutter), which gives motion-blur-style
+ * values. All positions go through the sorted batch sampler in one pass per channel.
+ * Returns frameCount() interleaved R, G, B values.
+ */
+QVector<float> LutExport::bakeFrameRgb(const CurveSampler::ChannelMap& channels, const FrameTiming& timing,
+                                       Content content, bool clampY)
+{
+    const int frames = timing.frameCount();
+    if (frames < 1) return QVector<float>();
+
+    const int perFrame = timing.supersamples;
+    const qreal frameSpan = 1.0 / (timing.duration * timing.fps);
+    QVector<qreal> xs(frames * perFrame);
+    for (int k = 0; k < frames; ++k) {
+        for (int j = 0; j < perFrame; ++j) {
+            const qreal offset = (perFrame == 1) ? 0.0 : (j + 0.5) / perFrame * frameSpan;
+            qreal x = timing.frameX(k) + offset;
+            if (timing.loop && x >= 1.0) x -= 1.0;
+            xs[k * perFrame + j] = x;
+        }
+    }
+
+    // Positions only go down where a loop wraps, so they form at most two sorted runs.
+    int split = 1;
+    while (split < xs.size() && xs[split] >= xs[split - 1]) ++split;
+
+    const CurveWidget::ActiveChannel order[] = {
+        CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN, CurveWidget::ActiveChannel::BLUE
+    };
+    QVector<qreal> ys(xs.size());
+    QVector<float> rgb(frames * 3);
+    for (int c = 0; c < 3; ++c) {
+        const CurveSampler::NodeList nodes = channels.value(order[c]);
+        qreal scale = 1.0;
+        if (content == Content::Values) {
+            CurveSampler::sampleNodesSorted(nodes, xs.constData(), split, ys.data(), clampY);
+            if (split < xs.size()) {
+                CurveSampler::sampleNodesSorted(nodes, xs.constData() + split, xs.size() - split, ys.data() + split, clampY);
+            }
+        } else {
+            CurveSampler::integrateNodesSorted(nodes, xs.constData(), split, ys.data());
+            if (split < xs.size()) {
+                CurveSampler::integrateNodesSorted(nodes, xs.constData() + split, xs.size() - split, ys.data() + split);
+            }
+            if (content == Content::NormalizedIntegral) {
+                const qreal one = 1.0;
+                qreal total = 0.0;
+                CurveSampler::integrateNodesSorted(nodes, &one, 1, &total);
+                if (std::abs(total) > 1e-12) scale = 1.0 / total;
+            }
+        }
+        for (int k = 0; k < frames; ++k) {
+            qreal sum = 0.0;
+            for (int j = 0; j < perFrame; ++j) sum += ys[k * perFrame + j];
+            rgb[k * 3 + c] = static_cast<float>(sum / perFrame * scale);
+        }
+    }
+    return rgb;
+}
+
+/**
+ * @brief Writes one CSV row per frame: frame index, time in seconds, curve x and R, G, B.
+ */
+bool LutExport::writeFrameTable(const QString& filePath, const QVector<float>& rgb, const FrameTiming& timing,
+                                QString *errorMessage)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out.setRealNumberPrecision(9);
+    out << "frame,time,x,r,g,b\n";
+    const int frames = std::min(timing.frameCount(), static_cast<int>(rgb.size() / 3));
+    for (int k = 0; k < frames; ++k) {
+        out << k << ',' << k / timing.fps << ',' << timing.frameX(k) << ','
+            << rgb[k * 3 + 0] << ',' << rgb[k * 3 + 1] << ',' << rgb[k * 3 + 2] << '\n';
+    }
+    out.flush();
+
+    if (out.status() != QTextStream::Ok || !file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Bakes one interleaved RGB row per width in a single walk: the texel positions
+ * of all widths are merged into one sorted list without duplicates, each channel is
+ * evaluated once along it, and the values are scattered back to the rows. Curve values
+ * are left unclamped (float targets need them; image targets clamp on conversion).
+ */
+QVector<QVector<float>> LutExport::bakeRgbRows(const CurveSampler::ChannelMap& channels, const QVector<int>& widths,
+                                               Content content)
+{
+    struct Position {
+        qreal x;
+        int row;
+        int texel;
+    };
+    QVector<Position> positions;
+    QVector<QVector<float>> rows(widths.size());
+    for (int r = 0; r < widths.size(); ++r) {
+        const int width = std::max(0, widths[r]);
+        rows[r].resize(width * 3);
+        for (int i = 0; i < width; ++i) {
+            positions.append({ (width == 1) ? 0.0 : static_cast<qreal>(i) / (width - 1.0), r, i });
+        }
+    }
+    std::sort(positions.begin(), positions.end(), [](const Position& l, const Position& r) { return l.x < r.x; });
+
+    QVector<qreal> xs;
+    QVector<int> sampleOf(positions.size());
+    xs.reserve(positions.size());
+    for (int p = 0; p < positions.size(); ++p) {
+        if (xs.isEmpty() || positions[p].x != xs.last()) xs.append(positions[p].x);
+        sampleOf[p] = xs.size() - 1;
+    }
+
+    const CurveWidget::ActiveChannel order[] = {
+        CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN, CurveWidget::ActiveChannel::BLUE
+    };
+    QVector<qreal> ys(xs.size());
+    for (int c = 0; c < 3; ++c) {
+        const CurveSampler::NodeList nodes = channels.value(order[c]);
+        qreal scale = 1.0;
+        if (content == Content::Values) {
+            CurveSampler::sampleNodesSorted(nodes, xs.constData(), xs.size(), ys.data(), false);
+        } else {
+            CurveSampler::integrateNodesSorted(nodes, xs.constData(), xs.size(), ys.data());
+            if (content == Content::NormalizedIntegral) {
+                const qreal one = 1.0;
+                qreal total = 0.0;
+                CurveSampler::integrateNodesSorted(nodes, &one, 1, &total);
+                if (std::abs(total) > 1e-12) scale = 1.0 / total;
+            }
+        }
+        for (int p = 0; p < positions.size(); ++p) {
+            rows[positions[p].row][positions[p].texel * 3 + c] = static_cast<float>(ys[sampleOf[p]] * scale);
+        }
+    }
+    return rows;
+}
+
+/**
+ * @brief Parses a list like "64, 256:16, 1024:32" of widths with optional bit depths.
+ * Targets come back without file paths; repeated width and depth pairs are dropped.
+ * @param ok - If not null, set to false when an entry is malformed.
+ */
+QVector<LutTarget> LutExport::parseTargets(const QString& text, int defaultBitDepth, bool *ok)
+{
+    QVector<LutTarget> targets;
+    bool allValid = true;
+    const QStringList parts = text.split(QRegularExpression("[,;\\s]+"), Qt::SkipEmptyParts);
+    for (const QString& part : parts) {
+        const QStringList fields = part.split(':');
+        LutTarget target;
+        bool widthValid = false;
+        bool depthValid = true;
+        target.width = fields[0].toInt(&widthValid);
+        target.bitDepth = (fields.size() > 1) ? fields[1].toInt(&depthValid) : defaultBitDepth;
+        if (fields.size() > 2 || !widthValid || !depthValid || target.width < 2
+            || (target.bitDepth != 8 && target.bitDepth != 16 && target.bitDepth != 32)) {
+            allValid = false;
+            continue;
+        }
+        const bool duplicate = std::any_of(targets.cbegin(), targets.cend(), [&target](const LutTarget& other) {
+            return other.width == target.width && other.bitDepth == target.bitDepth;
+        });
+        if (!duplicate) targets.append(target);
+    }
+    if (ok) *ok = allValid;
+    return targets;
+}
+
+/**
+ * @brief "dir/name.png" -> "dir/name_256.png", "dir/name_256_16bit.png" or "dir/name_256.pfm".
+ */
+QString LutExport::targetPath(const QString& basePath, const LutTarget& target)
+{
+    const QFileInfo info(basePath);
+    QString name = info.completeBaseName() + '_' + QString::number(target.width);
+    if (target.bitDepth == 16) name += QStringLiteral("_16bit");
+    name += (target.bitDepth == 32) ? QStringLiteral(".pfm") : QStringLiteral(".png");
+    return info.dir().filePath(name);
+}
+
+/**
+ * @brief Bakes all targets from one merged walk (bakeRgbRows()) and writes them. With a
+ * pool, the files are encoded and written concurrently; without one (e.g. when already
+ * running on a pool thread), one after the other.
+ * @return One message per target that failed; empty on success.
+ */
+QStringList LutExport::exportTargets(const CurveSampler::ChannelMap& channels, const QVector<LutTarget>& targets,
+                                     Content content, QThreadPool *pool)
+{
+    QVector<int> widths;
+    for (const LutTarget& target : targets) {
+        if (!widths.contains(target.width)) widths.append(target.width);
+    }
+    const QVector<QVector<float>> rows = bakeRgbRows(channels, widths, content);
+    // Integrals are written as they are; only curve values get the overshoot range.
+    const FloatRange range = (content == Content::Values) ? normalizationRange(channels) : FloatRange();
+
+    QVector<QString> errors(targets.size());
+    auto write = [&](int t) {
+        const LutTarget& target = targets[t];
+        QVector<float> rgb = rows[widths.indexOf(target.width)];
+        if (target.bitDepth == 32) {
+            for (float& value : rgb) value = static_cast<float>(range.normalize(value));
+            QString errorMessage;
+            if (!writePfm(target.filePath, rgb.constData(), target.width, 1, &errorMessage)
+                || !writeRangeSidecar(target.filePath, range, &errorMessage)) {
+                errors[t] = target.filePath + ": " + errorMessage;
+            }
+        } else if (!rgbLutImage(rgb, target.width, target.bitDepth).save(target.filePath, "PNG")) {
+            errors[t] = target.filePath + ": failed to write";
+        }
+    };
+
+    // Two jobs for one file would write it at the same time, so each path is written once.
+    QVector<int> unique;
+    QSet<QString> paths;
+    for (int t = 0; t < targets.size(); ++t) {
+        if (!paths.contains(targets[t].filePath)) {
+            paths.insert(targets[t].filePath);
+            unique.append(t);
+        }
+    }
+    BakeService::parallelFor(unique.size(), 1, [&write, &unique](int first, int last) {
+        for (int i = first; i < last; ++i) write(unique[i]);
+    }, pool);
+
+    QStringList failures;
+    for (const QString& error : std::as_const(errors)) {
+        if (!error.isEmpty()) failures.append(error);
+    }
+    return failures;
+}
+
+/**
+ * @brief Writes a little-endian RGB Portable Float Map. Rows are given top to bottom
+ * and stored bottom to top, as the format requires.
+ */
+bool LutExport::writePfm(const QString& filePath, const float *rgb, int width, int height, QString *errorMessage)
+{
+    if (!rgb || width < 1 || height < 1) {
+        if (errorMessage) *errorMessage = QStringLiteral("Invalid image size");
+        return false;
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+
+    // A negative scale marks little-endian data.
+    const QByteArray header = "PF\n" + QByteArray::number(width) + ' ' + QByteArray::number(height) + "\n-1.0\n";
+    bool ok = file.write(header) == header.size();
+
+    QVector<float> row(width * 3);
+    for (int y = height - 1; ok && y >= 0; --y) {
+        const float *source = rgb + static_cast<qsizetype>(y) * width * 3;
+        for (int i = 0; i < width * 3; ++i) {
+            row[i] = qToLittleEndian(source[i]);
+        }
+        const qint64 bytes = static_cast<qint64>(row.size() * sizeof(float));
+        ok = file.write(reinterpret_cast<const char*>(row.constData()), bytes) == bytes;
+    }
+
+    if (!ok || !file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QString LutExport::rangeSidecarPath(const QString& imagePath)
+{
+    return imagePath + QStringLiteral(".range.json");
+}
+
+/**
+ * @brief Stores the range a float LUT was normalized from next to the image.
+ */
+bool LutExport::writeRangeSidecar(const QString& imagePath, const FloatRange& range, QString *errorMessage)
+{
+    QJsonObject root;
+    root["min"] = range.min;
+    root["max"] = range.max;
+    root["decode"] = QStringLiteral("value = min + texel * (max - min)");
+
+    QSaveFile file(rangeSidecarPath(imagePath));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    if (file.write(QJsonDocument(root).toJson(QJsonDocument::Indented)) == -1 || !file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+#ifndef LUTEXPORT_H
+#define LUTEXPORT_H
+
+// Qt Includes
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Project Includes
+#include "curvesampler.h"
+
+// Forward Declarations
+class QThreadPool;
+
+/**
+ * @brief The value range a float LUT is normalized from. Texel values t map back
+ * to curve values as min + t * (max - min).
+ */
+struct FloatRange {
+    qreal min = 0.0;
+    qreal max = 1.0;
+
+    bool isUnit() const { return min == 0.0 && max == 1.0; }
+    qreal normalize(qreal value) const { return (value - min) / (max - min); }
+};
+
+/**
+ * @brief Frame times for frame-exact bakes. The curve's x axis spans duration seconds
+ * and frame k is shown at k / fps seconds.
+ */
+struct FrameTiming {
+    qreal duration = 1.0;
+    qreal fps = 30.0;
+    int supersamples = 1;   // Samples averaged over each frame's interval; 1 = the exact frame time.
+    bool loop = false;      // true: frames cover [0, duration) and the interval after the last wraps to the start.
+
+    // Bakes hold every sample position in memory, so frames x supersamples is capped (128 MB).
+    static const qint64 MaxSamples = qint64(1) << 24;
+
+    bool isValid() const;
+    int frameCount() const;
+    qint64 sampleCount() const;
+    qreal frameX(int frame) const;
+};
+
+/**
+ * @brief One output of a multi-resolution export.
+ */
+struct LutTarget {
+    int width = 256;
+    int bitDepth = 8;       // 8 or 16 for PNG, 32 for PFM.
+    QString filePath;
+};
+
+/**
+ * @brief LUT image export shared by the editor and the batch baker.
+ *
+ * 8/16-bit images clamp to [0, 1]. Float LUTs do not clamp curves that overshoot:
+ * the range is widened to the exact extremes of the curves and stored next to the
+ * image, so nothing is lost. Besides the curve values, a LUT can hold each channel's
+ * running integral, e.g. to turn a velocity curve into displacement with one fetch.
+ * Frame bakes sample at the frame times of a given duration and frame rate instead
+ * of at evenly spaced texels, so flipbooks line up with the curve exactly.
+ * Several widths and bit depths can be exported from a single walk over the
+ * segments (exportTargets()).
+ */
+class LutExport
+{
+public:
+    /**
+     * @brief What the texels hold: the curve values, or the running integral of each
+     * channel (area under y from 0 to x), raw or divided by the channel's total area.
+     */
+    enum class Content {
+        Values,
+        Integral,
+        NormalizedIntegral
+    };
+
+    static QString contentName(Content content);
+    static Content contentFromName(const QString& name);
+
+    static QImage rgbLutImage(const QVector<float>& rgb, int width, int bitDepth);
+
+    static FloatRange normalizationRange(const QVector<CurveWidget::ChannelBounds>& bounds);
+    static FloatRange normalizationRange(const CurveSampler::ChannelMap& channels);
+    static QVector<float> bakeIntegralRgb(const CurveSampler::ChannelMap& channels, int width, bool normalized);
+    static QVector<float> bakeFloatRgb(const CurveSampler::ChannelMap& channels, int width, const FloatRange& range);
+    static QVector<float> bakeFrameRgb(const CurveSampler::ChannelMap& channels, const FrameTiming& timing,
+                                       Content content = Content::Values, bool clampY = true);
+    static bool writeFrameTable(const QString& filePath, const QVector<float>& rgb, const FrameTiming& timing,
+                                QString *errorMessage = nullptr);
+    static QVector<QVector<float>> bakeRgbRows(const CurveSampler::ChannelMap& channels, const QVector<int>& widths,
+                                              Content content);
+    static QVector<LutTarget> parseTargets(const QString& text, int defaultBitDepth, bool *ok = nullptr);
+    static QString targetPath(const QString& basePath, const LutTarget& target);
+    static QStringList exportTargets(const CurveSampler::ChannelMap& channels, const QVector<LutTarget>& targets,
+                                     Content content, QThreadPool *pool = nullptr);
+
+    static bool writePfm(const QString& filePath, const float *rgb, int width, int height, QString *errorMessage = nullptr);
+    static bool writeRangeSidecar(const QString& imagePath, const FloatRange& range, QString *errorMessage = nullptr);
+    static QString rangeSidecarPath(const QString& imagePath);
+};
+
+#endif
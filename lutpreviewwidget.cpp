@@ -0,0 +1,196 @@
+#include "lutpreviewwidget.h"
+
+#include <QPaintEvent>
+#include <QPainter>
+#include <QPalette>
+#include <QPen>
+#include <QRectF>
+
+#include <algorithm>
+
+LutPreviewWidget::LutPreviewWidget(QWidget *parent)
+    : QFrame(parent),
+    m_smoothFiltering(true),
+    m_displayMode(DisplayMode::Gradient)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    // A plain frame is drawn in the foreground role; Mid matches the other widget borders.
+    setForegroundRole(QPalette::Mid);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+/**
+ * @brief Resizes the texel buffer. Does nothing if the count is unchanged,
+ * so the existing allocation is reused across refreshes.
+ */
+void LutPreviewWidget::setTexelCount(int count)
+{
+    if (count < 1) count = 1;
+    if (m_texels.width() == count) return;
+
+    m_texels = QImage(count, 1, QImage::Format_RGB888);
+    m_texels.fill(Qt::black);
+}
+
+int LutPreviewWidget::texelCount() const
+{
+    return m_texels.width();
+}
+
+/**
+ * @brief Returns the writable RGB888 texel row (3 bytes per texel).
+ * Call commitTexels() after writing to schedule a repaint.
+ */
+uchar* LutPreviewWidget::texelData()
+{
+    return m_texels.isNull() ? nullptr : m_texels.scanLine(0);
+}
+
+void LutPreviewWidget::commitTexels()
+{
+    m_errorText.clear();
+    update();
+}
+
+/**
+ * @brief Chooses linear (true) or nearest (false) filtering when stretching texels.
+ */
+void LutPreviewWidget::setSmoothFiltering(bool smooth)
+{
+    if (m_smoothFiltering != smooth) {
+        m_smoothFiltering = smooth;
+        update();
+    }
+}
+
+/**
+ * @brief Replaces the texels with an error message until the next commitTexels().
+ */
+void LutPreviewWidget::setErrorText(const QString& text)
+{
+    m_errorText = text;
+    update();
+}
+
+void LutPreviewWidget::setDisplayMode(DisplayMode mode)
+{
+    if (m_displayMode != mode) {
+        m_displayMode = mode;
+        update();
+    }
+}
+
+LutPreviewWidget::DisplayMode LutPreviewWidget::displayMode() const
+{
+    return m_displayMode;
+}
+
+/**
+ * @brief Stores the analysis drawn in ValueGraph mode.
+ */
+void LutPreviewWidget::setErrorAnalysis(const LutErrorAnalysis& analysis)
+{
+    m_analysis = analysis;
+    if (m_displayMode == DisplayMode::ValueGraph) update();
+}
+
+QSize LutPreviewWidget::sizeHint() const
+{
+    return QSize(256, 30);
+}
+
+void LutPreviewWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    const QRect target = contentsRect();
+
+    if (m_displayMode == DisplayMode::ValueGraph) {
+        paintValueGraph(painter, target);
+    } else if (!m_errorText.isEmpty() || m_texels.isNull()) {
+        painter.fillRect(target, palette().color(QPalette::Dark));
+        painter.setPen(palette().color(QPalette::BrightText));
+        painter.drawText(target, Qt::AlignCenter, m_errorText);
+    } else {
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, m_smoothFiltering);
+        painter.drawImage(target, m_texels);
+    }
+    painter.end();
+
+    QFrame::paintEvent(event);
+}
+
+/**
+ * @brief Plots exact (solid) and baked (dotted) values per channel over the full height,
+ * with per-texel error bars in the bottom third scaled to the largest error shown.
+ */
+void LutPreviewWidget::paintValueGraph(QPainter& painter, const QRect& target)
+{
+    painter.fillRect(target, palette().color(QPalette::Base));
+    if (!m_analysis.isValid() || target.width() < 2 || target.height() < 2) {
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(target, Qt::AlignCenter, (m_analysis.bitDepth == 32) ? tr("32-bit float: no quantization error")
+                                                                              : tr("Analyzing..."));
+        return;
+    }
+
+    const QColor channelColors[] = { QColor(230, 40, 40), QColor(40, 190, 40), QColor(50, 90, 255) };
+    const QString channelNames[] = { QStringLiteral("R"), QStringLiteral("G"), QStringLiteral("B") };
+    const int width = m_analysis.width;
+    const qreal left = target.left();
+    const qreal top = target.top();
+    const qreal w = target.width() - 1;
+    const qreal h = target.height() - 1;
+    const qreal barBand = h / 3.0;
+    const qreal lsb = 1.0 / ((m_analysis.bitDepth == 16) ? 65535.0 : 255.0);
+
+    float largestError = 0.0f;
+    for (const LutChannelError& channel : m_analysis.channels) {
+        largestError = std::max(largestError, channel.maxError);
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    if (largestError > 0.0f) {
+        const qreal texelWidth = w / width;
+        for (int c = 0; c < m_analysis.channels.size(); ++c) {
+            QColor barColor = channelColors[c % 3];
+            barColor.setAlpha(110);
+            const LutChannelError& channel = m_analysis.channels[c];
+            for (int i = 0; i < width; ++i) {
+                const qreal barHeight = barBand * channel.texelError[i] / largestError;
+                if (barHeight < 0.5) continue;
+                painter.fillRect(QRectF(left + i * texelWidth, top + h - barHeight,
+                                        std::max(1.0, texelWidth), barHeight), barColor);
+            }
+        }
+    }
+
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    for (int c = 0; c < m_analysis.channels.size(); ++c) {
+        const LutChannelError& channel = m_analysis.channels[c];
+
+        const int denseCount = channel.exact.size();
+        m_polyline.resize(denseCount);
+        for (int k = 0; k < denseCount; ++k) {
+            const qreal x = (denseCount == 1) ? 0.0 : static_cast<qreal>(k) / (denseCount - 1);
+            m_polyline[k] = QPointF(left + x * w, top + (1.0 - channel.exact[k]) * h);
+        }
+        painter.setPen(QPen(channelColors[c % 3], 1.0));
+        painter.drawPolyline(m_polyline.constData(), m_polyline.size());
+
+        m_polyline.resize(width);
+        for (int i = 0; i < width; ++i) {
+            const qreal x = (width == 1) ? 0.0 : static_cast<qreal>(i) / (width - 1);
+            m_polyline[i] = QPointF(left + x * w, top + (1.0 - channel.baked[i]) * h);
+        }
+        painter.setPen(QPen(channelColors[c % 3].darker(150), 1.0, Qt::DotLine));
+        painter.drawPolyline(m_polyline.constData(), m_polyline.size());
+    }
+
+    QString legend = tr("%1 px, %2-bit  max error:").arg(width).arg(m_analysis.bitDepth);
+    for (int c = 0; c < m_analysis.channels.size(); ++c) {
+        legend += QString("  %1 %2 LSB").arg(channelNames[c % 3])
+                      .arg(m_analysis.channels[c].maxError / lsb, 0, 'f', 2);
+    }
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawText(target.adjusted(4, 2, -4, -2), Qt::AlignTop | Qt::AlignLeft, legend);
+}
@@ -0,0 +1,72 @@
+#ifndef LUTPREVIEWWIDGET_H
+#define LUTPREVIEWWIDGET_H
+
+// Qt Includes
+#include <QFrame>
+#include <QImage>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+// Project Includes
+#include "luterroranalyzer.h"
+
+// Forward Declarations
+class QPainter;
+
+/**
+ * @brief Displays a 1D LUT by stretching its texels over the widget.
+ *
+ * The widget owns a texelCount x 1 RGB888 buffer that callers fill in place
+ * through texelData() and then commitTexels(). The buffer is only reallocated
+ * when the texel count changes and is painted with a single drawImage() call,
+ * so refreshing the preview does not allocate.
+ *
+ * In ValueGraph mode it instead plots a LutErrorAnalysis: the exact curve and
+ * the baked texel values per channel, with per-texel error bars along the bottom.
+ */
+class LutPreviewWidget : public QFrame
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief What the preview shows.
+     */
+    enum class DisplayMode {
+        Gradient,
+        ValueGraph
+    };
+    Q_ENUM(DisplayMode)
+
+    explicit LutPreviewWidget(QWidget *parent = nullptr);
+
+    void setTexelCount(int count);
+    int texelCount() const;
+    uchar* texelData();
+    void commitTexels();
+
+    void setSmoothFiltering(bool smooth);
+    void setErrorText(const QString& text);
+
+    void setDisplayMode(DisplayMode mode);
+    DisplayMode displayMode() const;
+    void setErrorAnalysis(const LutErrorAnalysis& analysis);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void paintValueGraph(QPainter& painter, const QRect& target);
+
+    QImage m_texels;
+    QString m_errorText;
+    bool m_smoothFiltering;
+    DisplayMode m_displayMode;
+    LutErrorAnalysis m_analysis;
+    QVector<QPointF> m_polyline;
+};
+
+#endif
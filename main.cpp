@@ -1,14 +1,365 @@
 #include "mainwindow.h"
+#include "bakeservice.h"
+#include "batchbaker.h"
+#include "crossingsolver.h"
+#include "curvediff.h"
+#include "lutexport.h"
+#include "objmesh.h"
+#include "projectvalidator.h"
+#include "sessionrecorder.h"
+#include "sessionreplayer.h"
+#include "startupprofiler.h"
+#include "themestyle.h"
+#include "vatbaker.h"
+#include "vertexweights.h"
 
 #include <QApplication>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QIcon>
+#include <QJsonDocument>
+#include <QLoggingCategory>
+#include <QStyleFactory>
+#include <QTextStream>
+#include <QTimer>
 
 int main(int argc, char *argv[])
 {
+    StartupProfiler::start();
+
+    // Replays and batch tools run headless unless a platform was chosen explicitly.
+    for (int i = 1; i < argc; ++i) {
+        const bool headless = qstrcmp(argv[i], "--replay") == 0 || qstrcmp(argv[i], "--validate") == 0
+                              || qstrcmp(argv[i], "--migrate") == 0 || qstrcmp(argv[i], "--diff") == 0
+                              || qstrcmp(argv[i], "--merge") == 0 || qstrcmp(argv[i], "--bake") == 0
+                              || qstrcmp(argv[i], "--vat") == 0 || qstrcmp(argv[i], "--vertex-weights") == 0;
+        if (headless && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
     QApplication a(argc, argv);
+    // Set the style before any widget exists so nothing has to be repolished.
+    a.setStyle(new ThemeStyle(QStyleFactory::create("Fusion")));
     a.setWindowIcon(QIcon(":/icons/app_icon"));
+    StartupProfiler::mark("application created");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption recordOption("record", "Record curve editor input to <file> (written on exit).", "file");
+    QCommandLineOption replayOption("replay", "Replay a recorded session at full speed and report timings.", "file");
+    QCommandLineOption reportOption("report", "Write the replay or validation report to <file> instead of stdout.", "file");
+    QCommandLineOption validateOption("validate", "Check the project <path> (file or folder, repeatable) and report problems.", "path");
+    QCommandLineOption migrateOption("migrate", "Like --validate, and rewrite readable projects in an older format in the current one.", "path");
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(reportOption);
+    QCommandLineOption diffOption("diff", "Compare the projects <old> <new> given as arguments.");
+    QCommandLineOption mergeOption("merge", "Three-way merge of the projects <base> <ours> <theirs> given as arguments.");
+    QCommandLineOption outputOption("output", "Write the merged project to <file> instead of over <ours>, or the --vat or --vertex-weights output to <file>.", "file");
+    parser.addOption(validateOption);
+    parser.addOption(migrateOption);
+    parser.addOption(diffOption);
+    parser.addOption(mergeOption);
+    parser.addOption(outputOption);
+    QCommandLineOption bakeOption("bake", "Bake the LUT of the project <path> (file or folder, repeatable) with its saved settings.", "path");
+    QCommandLineOption thresholdsOption("thresholds", "With --bake, also export where curves cross these values, e.g. \"0.25,0.5\".", "values");
+    QCommandLineOption outputDirOption("output-dir", "With --bake, write LUTs to <dir> instead of next to each project.", "dir");
+    QCommandLineOption fpsOption("fps", "Frames per second. With --bake, also bake a frame strip and table; with --vat, sets the texture's frame rate (default 30).", "fps");
+    QCommandLineOption durationOption("duration", "Seconds the curves span for --fps and --vat (default 1).", "seconds", "1");
+    QCommandLineOption supersampleOption("supersample", "Samples averaged per frame for --fps (default 1).", "count", "1");
+    QCommandLineOption loopOption("loop", "With --fps or --vat, leave out the frame at the end so the animation loops.");
+    QCommandLineOption variantsOption("variants", "With --bake, also write these widths[:bit depth] from one pass, e.g. \"64,256,1024:16\".", "list");
+    parser.addOption(bakeOption);
+    parser.addOption(variantsOption);
+    parser.addOption(thresholdsOption);
+    parser.addOption(outputDirOption);
+    parser.addOption(fpsOption);
+    parser.addOption(durationOption);
+    parser.addOption(supersampleOption);
+    parser.addOption(loopOption);
+    QCommandLineOption vatOption("vat", "Bake a vertex animation texture of the OBJ <mesh> from the project given as argument.", "mesh");
+    QCommandLineOption amplitudeOption("amplitude", "With --vat, offset scale per axis, \"a\" or \"x,y,z\" (default 1).", "scale", "1");
+    QCommandLineOption phaseOption("phase", "With --vat, per-vertex phase from none, position or color (default none).", "source", "none");
+    QCommandLineOption phaseAxisOption("phase-axis", "With --phase position, the axis \"x,y,z\" the phase grows along (default 0,1,0).", "axis", "0,1,0");
+    QCommandLineOption phaseScaleOption("phase-scale", "With --phase, the largest phase in curve x units (default 1).", "scale", "1");
+    QCommandLineOption halfOption("half", "With --vat, write half floats (needs a .dds --output).");
+    parser.addOption(vatOption);
+    parser.addOption(amplitudeOption);
+    parser.addOption(phaseOption);
+    parser.addOption(phaseAxisOption);
+    parser.addOption(phaseScaleOption);
+    parser.addOption(halfOption);
+    QCommandLineOption weightsOption("vertex-weights", "Write per-vertex height, pivot distance and piece random of the OBJ <mesh>; with --bake, next to each LUT.", "mesh");
+    QCommandLineOption upOption("up", "With --vertex-weights, the up axis \"x,y,z\" (default 0,1,0).", "axis", "0,1,0");
+    QCommandLineOption pivotOption("pivot", "With --vertex-weights, measure distances from \"x,y,z\" instead of each piece's base.", "point");
+    QCommandLineOption seedOption("seed", "With --vertex-weights, seed of the per-piece random values (default 0).", "seed", "0");
+    QCommandLineOption wholeMeshOption("whole-mesh", "With --vertex-weights, treat the mesh as one piece.");
+    parser.addOption(weightsOption);
+    parser.addOption(upOption);
+    parser.addOption(pivotOption);
+    parser.addOption(seedOption);
+    parser.addOption(wholeMeshOption);
+    parser.addPositionalArgument("projects", "Project files for --diff, --merge or --vat.", "[projects...]");
+    parser.process(a);
+
+    auto writeReport = [&parser, &reportOption](const QJsonObject& report) {
+        QByteArray reportJson = QJsonDocument(report).toJson(QJsonDocument::Indented);
+        if (parser.isSet(reportOption)) {
+            QFile reportFile(parser.value(reportOption));
+            if (!reportFile.open(QIODevice::WriteOnly) || reportFile.write(reportJson) == -1) {
+                qCritical() << "Failed to write report:" << reportFile.fileName();
+                return false;
+            }
+        } else {
+            QTextStream(stdout) << reportJson;
+        }
+        return true;
+    };
+
+    // "a" sets all three components alike, "x,y,z" each one.
+    auto parseVector = [](const QString& text, QVector3D& vector) {
+        const QStringList parts = text.split(',');
+        if (parts.size() != 1 && parts.size() != 3) return false;
+        float values[3];
+        for (int i = 0; i < 3; ++i) {
+            bool ok = false;
+            values[i] = parts[parts.size() == 1 ? 0 : i].trimmed().toFloat(&ok);
+            if (!ok) return false;
+        }
+        vector = QVector3D(values[0], values[1], values[2]);
+        return true;
+    };
+
+    // Weights are computed once; with --bake they are written next to every LUT.
+    ObjMesh weightsMesh;
+    QVector<float> vertexWeights;
+    if (parser.isSet(weightsOption)) {
+        QLoggingCategory::setFilterRules("default.debug=false");
+
+        VertexWeightSettings settings;
+        bool seedValid = false;
+        settings.seed = parser.value(seedOption).toUInt(&seedValid);
+        settings.perPiece = !parser.isSet(wholeMeshOption);
+        settings.fixedPivot = parser.isSet(pivotOption);
+        if (!seedValid || !parseVector(parser.value(upOption), settings.axis)
+            || (settings.fixedPivot && !parseVector(parser.value(pivotOption), settings.pivot))) {
+            qCritical().noquote() << "--up and --pivot must be \"x,y,z\" and --seed a non-negative integer.";
+            return 2;
+        }
+
+        QString errorMessage;
+        if (!ObjMesh::load(parser.value(weightsOption), weightsMesh, &errorMessage)) {
+            qCritical().noquote() << "Failed to read" << parser.value(weightsOption) << "-" << errorMessage;
+            return 2;
+        }
+        int pieces = 0;
+        vertexWeights = VertexWeights::compute(weightsMesh, settings, BakeService::instance().pool(), &pieces);
+
+        if (!parser.isSet(bakeOption)) {
+            const QString outputPath = parser.isSet(outputOption) ? parser.value(outputOption)
+                                                                  : VertexWeights::weightsPath(weightsMesh.filePath(), 16);
+            if (!VertexWeights::write(outputPath, weightsMesh, vertexWeights, 16, &errorMessage)) {
+                qCritical().noquote() << "Failed to write" << outputPath << "-" << errorMessage;
+                return 1;
+            }
+            QJsonObject report;
+            report["mesh"] = weightsMesh.filePath();
+            report["vertices"] = weightsMesh.vertexCount();
+            report["pieces"] = pieces;
+            report["output"] = outputPath;
+            return writeReport(report) ? 0 : 1;
+        }
+    }
+
+    if (parser.isSet(validateOption) || parser.isSet(migrateOption)) {
+        QLoggingCategory::setFilterRules("default.debug=false\ndefault.warning=false");
+
+        const bool migrate = parser.isSet(migrateOption);
+        const QStringList files = ProjectValidator::collectProjectFiles(
+            parser.values(validateOption) + parser.values(migrateOption));
+        const QVector<ProjectReport> reports = ProjectValidator::processFiles(files, migrate);
+        const QJsonObject summary = ProjectValidator::summaryJson(reports);
+        if (!writeReport(summary)) return 1;
+        return summary.value("errors").toInt() > 0 ? 1 : 0;
+    }
+
+    if (parser.isSet(bakeOption)) {
+        QLoggingCategory::setFilterRules("default.debug=false");
+
+        BakeOptions options;
+        bool thresholdsValid = true;
+        options.thresholds = CrossingSolver::parseThresholds(parser.value(thresholdsOption), &thresholdsValid);
+        if (!thresholdsValid) {
+            qCritical().noquote() << "--thresholds must be a list of numbers.";
+            return 2;
+        }
+        if (parser.isSet(fpsOption)) {
+            options.bakeFrames = true;
+            options.frames.fps = parser.value(fpsOption).toDouble();
+            options.frames.duration = parser.value(durationOption).toDouble();
+            options.frames.supersamples = parser.value(supersampleOption).toInt();
+            options.frames.loop = parser.isSet(loopOption);
+            if (!options.frames.isValid()) {
+                qCritical().noquote() << QString("--fps and --duration must be positive, --supersample at least 1, and frames x samples "
+                                                 "at most %1.").arg(FrameTiming::MaxSamples);
+                return 2;
+            }
+        }
+        if (parser.isSet(variantsOption)) {
+            bool variantsValid = false;
+            LutExport::parseTargets(parser.value(variantsOption), 8, &variantsValid);
+            if (!variantsValid) {
+                qCritical().noquote() << "--variants must list widths of at least 2, each optionally followed by :8, :16 or :32.";
+                return 2;
+            }
+            options.variants = parser.value(variantsOption);
+        }
+        options.weightsMesh = weightsMesh;
+        options.vertexWeights = vertexWeights;
+        options.outputDirectory = parser.value(outputDirOption);
+        if (!options.outputDirectory.isEmpty() && !QDir().mkpath(options.outputDirectory)) {
+            qCritical().noquote() << "Failed to create" << options.outputDirectory;
+            return 2;
+        }
+
+        const QStringList files = ProjectValidator::collectProjectFiles(parser.values(bakeOption));
+        const QVector<BakeResult> results = BatchBaker::bakeFiles(files, options);
+        const QJsonObject summary = BatchBaker::summaryJson(results);
+        if (!writeReport(summary)) return 1;
+        return summary.value("failed").toInt() > 0 ? 1 : 0;
+    }
+
+    if (parser.isSet(vatOption)) {
+        QLoggingCategory::setFilterRules("default.debug=false");
+
+        const QStringList paths = parser.positionalArguments();
+        if (paths.size() != 1) {
+            qCritical().noquote() << "--vat needs the project as argument.";
+            return 2;
+        }
+
+        VatSettings settings;
+        settings.timing.fps = parser.isSet(fpsOption) ? parser.value(fpsOption).toDouble() : settings.timing.fps;
+        settings.timing.duration = parser.value(durationOption).toDouble();
+        settings.timing.loop = parser.isSet(loopOption);
+        settings.format = parser.isSet(halfOption) ? VatSettings::Format::Half : VatSettings::Format::Float32;
+        bool phaseScaleValid = false;
+        settings.phaseScale = parser.value(phaseScaleOption).toDouble(&phaseScaleValid);
+        const QString phase = parser.value(phaseOption);
+        if (phase == "position") {
+            settings.phaseSource = VatSettings::PhaseSource::Position;
+        } else if (phase == "color") {
+            settings.phaseSource = VatSettings::PhaseSource::VertexColor;
+        } else if (phase != "none") {
+            qCritical().noquote() << "--phase must be none, position or color.";
+            return 2;
+        }
+        if (!settings.timing.isValid() || !phaseScaleValid || !parseVector(parser.value(amplitudeOption), settings.amplitude)
+            || !parseVector(parser.value(phaseAxisOption), settings.phaseAxis)) {
+            qCritical().noquote() << "--fps and --duration must be positive; --amplitude, --phase-axis and --phase-scale must be numbers.";
+            return 2;
+        }
+
+        CurveProject::ProjectData project;
+        ObjMesh mesh;
+        QString errorMessage;
+        if (!CurveProject::readFile(paths[0], project, &errorMessage)) {
+            qCritical().noquote() << "Failed to read" << paths[0] << "-" << errorMessage;
+            return 2;
+        }
+        if (!ObjMesh::load(parser.value(vatOption), mesh, &errorMessage)) {
+            qCritical().noquote() << "Failed to read" << parser.value(vatOption) << "-" << errorMessage;
+            return 2;
+        }
+
+        const QString defaultSuffix = (settings.format == VatSettings::Format::Half) ? ".dds" : ".pfm";
+        const QString outputPath = parser.isSet(outputOption)
+            ? parser.value(outputOption)
+            : QFileInfo(paths[0]).absolutePath() + '/' + QFileInfo(paths[0]).completeBaseName() + "_vat" + defaultSuffix;
+        QJsonObject report;
+        if (!VatBaker::bake(mesh, project.channels, settings, outputPath, &errorMessage, &report,
+                            BakeService::instance().pool())) {
+            qCritical().noquote() << "Failed to bake" << outputPath << "-" << errorMessage;
+            return 1;
+        }
+        return writeReport(report) ? 0 : 1;
+    }
+
+    if (parser.isSet(diffOption) || parser.isSet(mergeOption)) {
+        QLoggingCategory::setFilterRules("default.debug=false");
+
+        const QStringList paths = parser.positionalArguments();
+        const int expected = parser.isSet(diffOption) ? 2 : 3;
+        if (paths.size() != expected) {
+            qCritical().noquote() << (parser.isSet(diffOption) ? "--diff needs <old> <new>." : "--merge needs <base> <ours> <theirs>.");
+            return 2;
+        }
+
+        QVector<CurveProject::ProjectData> projects(expected);
+        for (int i = 0; i < expected; ++i) {
+            QString errorMessage;
+            if (!CurveProject::readFile(paths[i], projects[i], &errorMessage)) {
+                qCritical().noquote() << "Failed to read" << paths[i] << "-" << errorMessage;
+                return 2;
+            }
+        }
+
+        if (parser.isSet(diffOption)) {
+            const QJsonObject diff = CurveDiff::diffJson(projects[0], projects[1]);
+            if (!writeReport(diff)) return 2;
+            return diff.value("identical").toBool() ? 0 : 1;
+        }
+
+        // Exit codes follow git merge drivers: 0 clean, 1 conflicts, 2 failure.
+        const CurveDiff::MergeResult merged = CurveDiff::merge(projects[0], projects[1], projects[2]);
+        const QString outputPath = parser.isSet(outputOption) ? parser.value(outputOption) : paths[1];
+        QString errorMessage;
+        if (!CurveProject::writeFile(outputPath, merged.channels, merged.settings, &errorMessage)) {
+            qCritical().noquote() << "Failed to write" << outputPath << "-" << errorMessage;
+            return 2;
+        }
+        if (!writeReport(CurveDiff::mergeJson(merged))) return 2;
+        return merged.conflicts.isEmpty() ? 0 : 1;
+    }
 
     MainWindow w;
     w.show();
-    return a.exec();
+    StartupProfiler::mark("window shown");
+    if (StartupProfiler::isEnabled()) {
+        QTimer::singleShot(0, &w, [] { StartupProfiler::mark("first event loop pass"); });
+    }
+
+    if (parser.isSet(replayOption)) {
+        QLoggingCategory::setFilterRules("default.debug=false");
+
+        SessionReplayer replayer(w.curveWidget());
+        QObject::connect(&w, &MainWindow::previewBaked, &replayer, &SessionReplayer::recordPreviewBake);
+
+        QString errorMessage;
+        if (!replayer.load(parser.value(replayOption), &errorMessage)) {
+            qCritical().noquote() << errorMessage;
+            return 1;
+        }
+        replayer.run();
+
+        return writeReport(replayer.report()) ? 0 : 1;
+    }
+
+    SessionRecorder recorder(w.curveWidget());
+    if (parser.isSet(recordOption)) {
+        recorder.start();
+    }
+
+    int result = a.exec();
+
+    if (recorder.isRecording()) {
+        recorder.stop();
+        if (!recorder.save(parser.value(recordOption))) result = 1;
+    }
+    return result;
 }
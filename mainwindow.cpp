@@ -1,39 +1,140 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h" 
 #include "curvewidget.h"
+#include "curveproject.h"
+#include "curvelibrarydock.h"
+#include "lutpreviewwidget.h"
+#include "luterroranalyzer.h"
+#include "curvesampler.h"
+#include "bakeservice.h"
+#include "startupprofiler.h"
+#include "transformselectiondialog.h"
+#include "lutexport.h"
+#include "crossingsolver.h"
+#include "framebakedialog.h"
+#include "objmesh.h"
+#include "vatbakedialog.h"
+#include "vertexweights.h"
+#include "autocurves.h"
 
 #include <QAbstractButton>
 #include <QAction>
 #include <QApplication>
 #include <QButtonGroup>
+#include <QComboBox>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QIODevice>
 #include <QImage>
+#include <QInputDialog>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QKeySequence>
+#include <QLabel>
+#include <QLineEdit>
 #include <QList>
 #include <QMapIterator>
 #include <QMenu>
 #include <QMessageBox>
-#include <QPainter>
 #include <QPalette>
-#include <QPixmap>
 #include <QRadioButton>
 #include <QSettings>
+#include <QSignalBlocker>
+#include <QStackedWidget>
 #include <QStandardPaths>
-#include <QStyleFactory>
-#include <QTextStream>
+#include <QTabBar>
+#include <QTimer>
+#include <QUndoGroup>
 #include <QUndoStack>
 #include <QVariant>
+#include <QVBoxLayout>
 
 #include <algorithm> 
 #include <cmath>     
+#include <cstring>
+
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+/**
+ * @brief Builds a Fusion palette for the given theme.
+ */
+QPalette buildThemePalette(bool dark)
+{
+    QPalette pal;
+    if (dark) {
+        const QColor window(0x35, 0x35, 0x35);
+        const QColor text(0xE0, 0xE0, 0xE0);
+        const QColor disabledText(0x70, 0x70, 0x70);
+        pal.setColor(QPalette::Window, window);
+        pal.setColor(QPalette::WindowText, text);
+        pal.setColor(QPalette::Base, QColor(0x23, 0x23, 0x23));
+        pal.setColor(QPalette::AlternateBase, QColor(0x46, 0x46, 0x46));
+        pal.setColor(QPalette::ToolTipBase, QColor(0x46, 0x46, 0x46));
+        pal.setColor(QPalette::ToolTipText, text);
+        pal.setColor(QPalette::PlaceholderText, disabledText);
+        pal.setColor(QPalette::Text, text);
+        pal.setColor(QPalette::Button, QColor(0x5A, 0x5A, 0x5A));
+        pal.setColor(QPalette::ButtonText, text);
+        pal.setColor(QPalette::BrightText, Qt::white);
+        pal.setColor(QPalette::Light, QColor(0x6A, 0x6A, 0x6A));
+        pal.setColor(QPalette::Midlight, QColor(0x5A, 0x5A, 0x5A));
+        pal.setColor(QPalette::Mid, QColor(0x55, 0x55, 0x55));
+        pal.setColor(QPalette::Dark, QColor(0x23, 0x23, 0x23));
+        pal.setColor(QPalette::Shadow, Qt::black);
+        pal.setColor(QPalette::Highlight, QColor(0x00, 0x78, 0xD7));
+        pal.setColor(QPalette::HighlightedText, Qt::white);
+        pal.setColor(QPalette::Link, QColor(0x4A, 0xA8, 0xFF));
+        pal.setColor(QPalette::Disabled, QPalette::WindowText, disabledText);
+        pal.setColor(QPalette::Disabled, QPalette::Text, disabledText);
+        pal.setColor(QPalette::Disabled, QPalette::ButtonText, disabledText);
+        pal.setColor(QPalette::Disabled, QPalette::Button, QColor(0x45, 0x45, 0x45));
+    } else {
+        const QColor disabledText(0xA0, 0xA0, 0xA0);
+        pal.setColor(QPalette::Window, QColor(0xB5, 0xB3, 0xB3));
+        pal.setColor(QPalette::WindowText, Qt::black);
+        pal.setColor(QPalette::Base, Qt::white);
+        pal.setColor(QPalette::AlternateBase, QColor(0xF0, 0xF0, 0xF0));
+        pal.setColor(QPalette::ToolTipBase, Qt::white);
+        pal.setColor(QPalette::ToolTipText, Qt::black);
+        pal.setColor(QPalette::PlaceholderText, disabledText);
+        pal.setColor(QPalette::Text, Qt::black);
+        pal.setColor(QPalette::Button, QColor(0xE8, 0xE8, 0xE8));
+        pal.setColor(QPalette::ButtonText, Qt::black);
+        pal.setColor(QPalette::BrightText, Qt::red);
+        pal.setColor(QPalette::Light, Qt::white);
+        pal.setColor(QPalette::Midlight, QColor(0xF6, 0xF6, 0xF6));
+        pal.setColor(QPalette::Mid, QColor(0xBE, 0xBE, 0xBE));
+        pal.setColor(QPalette::Dark, QColor(0xAD, 0xAD, 0xAD));
+        pal.setColor(QPalette::Shadow, QColor(0x70, 0x70, 0x70));
+        pal.setColor(QPalette::Highlight, QColor(0x00, 0x78, 0xD7));
+        pal.setColor(QPalette::HighlightedText, Qt::white);
+        pal.setColor(QPalette::Link, QColor(0x00, 0x66, 0xCC));
+        pal.setColor(QPalette::Disabled, QPalette::WindowText, disabledText);
+        pal.setColor(QPalette::Disabled, QPalette::Text, disabledText);
+        pal.setColor(QPalette::Disabled, QPalette::ButtonText, disabledText);
+        pal.setColor(QPalette::Disabled, QPalette::Button, QColor(0xF0, 0xF0, 0xF0));
+    }
+    return pal;
+}
+
+/**
+ * @brief Returns the cached palette for a theme, building it on first use.
+ */
+const QPalette& themePalette(bool dark)
+{
+    static const QPalette lightPalette = buildThemePalette(false);
+    static const QPalette darkPalette = buildThemePalette(true);
+    return dark ? darkPalette : lightPalette;
+}
+
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -41,22 +142,24 @@ MainWindow::MainWindow(QWidget *parent)
     , m_selectedNodeIndex(-1)
     , m_channelGroup(nullptr)
     , m_isPreviewRgbCombined(true)
+    , m_previewErrorAction(nullptr)
+    , m_transformSelectionAction(nullptr)
+    , m_linkChannelsAction(nullptr)
+    , m_errorAnalyzer(new LutErrorAnalyzer(this))
+    , m_curveWidget(nullptr)
+    , m_documentTabs(nullptr)
+    , m_documentStack(nullptr)
+    , m_undoGroup(new QUndoGroup(this))
+    , m_libraryDock(nullptr)
+    , m_boundsLabel(nullptr)
+    , m_previewRowRevision(0)
+    , m_gradientPreviewHeight(0)
+    , m_lutFrameMaxHeight(0)
+    , m_imageCurvesIdle(1)
 {
     ui->setupUi(this);
-
-    if (ui->curveWidget && ui->animationPreviewWidget) {
-        ui->animationPreviewWidget->setCurveWidget(ui->curveWidget);
-    }
-
-    if (ui->curveWidget && ui->animationPreviewWidget) {
-        connect(ui->curveWidget, &CurveWidget::curveChanged,
-                ui->animationPreviewWidget, QOverload<>::of(&QWidget::update));
-
-        if (m_channelGroup) { 
-            connect(m_channelGroup, &QButtonGroup::buttonClicked,
-                    ui->animationPreviewWidget, QOverload<>::of(&QWidget::update));
-        }
-    }
+    StartupProfiler::mark("ui setup");
+    setupDocumentArea();
 
     Qt::WindowFlags flags = this->windowFlags();
     flags &= ~Qt::WindowMaximizeButtonHint;
@@ -66,33 +169,92 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->actionSaveCurves, &QAction::triggered, this, &MainWindow::onSaveCurvesActionTriggered);
     connect(ui->actionLoadCurves, &QAction::triggered, this, &MainWindow::onLoadCurvesActionTriggered);
 
+    QAction *newDocumentAction = new QAction(tr("&New Document"), this);
+    newDocumentAction->setShortcut(QKeySequence::New);
+    connect(newDocumentAction, &QAction::triggered, this, &MainWindow::onNewDocumentTriggered);
+    QAction *closeDocumentAction = new QAction(tr("&Close Document"), this);
+    closeDocumentAction->setShortcut(QKeySequence::Close);
+    connect(closeDocumentAction, &QAction::triggered, this, [this]() {
+        closeDocument(m_documentTabs->currentIndex());
+    });
+    ui->menuFile->insertAction(ui->actionSaveCurves, newDocumentAction);
+    ui->menuFile->insertAction(ui->actionSaveCurves, closeDocumentAction);
+    ui->menuFile->insertSeparator(ui->actionSaveCurves);
+    QAction *exportEventsAction = new QAction(tr("Export Threshold &Events..."), this);
+    connect(exportEventsAction, &QAction::triggered, this, &MainWindow::onExportEventsTriggered);
+    ui->menuFile->addAction(exportEventsAction);
+    QAction *bakeFramesAction = new QAction(tr("Bake &Frames..."), this);
+    connect(bakeFramesAction, &QAction::triggered, this, &MainWindow::onBakeFramesTriggered);
+    ui->menuFile->addAction(bakeFramesAction);
+    QAction *exportVariantsAction = new QAction(tr("Export LUT &Variants..."), this);
+    connect(exportVariantsAction, &QAction::triggered, this, &MainWindow::onExportVariantsTriggered);
+    ui->menuFile->addAction(exportVariantsAction);
+    QAction *bakeVatAction = new QAction(tr("Bake Vertex &Animation..."), this);
+    connect(bakeVatAction, &QAction::triggered, this, &MainWindow::onBakeVatTriggered);
+    ui->menuFile->addAction(bakeVatAction);
+    QAction *exportWeightsAction = new QAction(tr("Export Vertex &Weights..."), this);
+    connect(exportWeightsAction, &QAction::triggered, this, &MainWindow::onExportWeightsTriggered);
+    ui->menuFile->addAction(exportWeightsAction);
+
     ui->exportBitDepthComboBox->addItem("8-bit per channel", QVariant(8));
     ui->exportBitDepthComboBox->addItem("16-bit per channel", QVariant(16));
+    ui->exportBitDepthComboBox->addItem("32-bit float (PFM)", QVariant(32));
     ui->exportBitDepthComboBox->setCurrentIndex(0);
 
+    ui->lutContentComboBox->addItem("Curve values", LutExport::contentName(LutExport::Content::Values));
+    ui->lutContentComboBox->addItem("Running integral", LutExport::contentName(LutExport::Content::Integral));
+    ui->lutContentComboBox->addItem("Running integral, normalized", LutExport::contentName(LutExport::Content::NormalizedIntegral));
+    ui->lutContentComboBox->setCurrentIndex(0);
+
+    m_boundsLabel = new QLabel(this);
+    m_boundsLabel->setToolTip(tr("Exact range and mean of the active channel before clamping to [0, 1].\n"
+                                 "8/16-bit exports clamp overshoot; float exports keep it."));
+    ui->statusbar->addPermanentWidget(m_boundsLabel);
+
     m_isPreviewRgbCombined = ui->actionPreviewRgb->isChecked();
 
-    qApp->setStyle(QStyleFactory::create("Fusion"));
     QSettings settings("MyCompany", "CurveMaker");
     bool useDarkMode = settings.value("Appearance/DarkMode", false).toBool();
-    ui->actionToggleDarkMode->setChecked(useDarkMode);
+    {
+        // Sync the toggles silently so the theme is applied exactly once below.
+        const QSignalBlocker actionBlocker(ui->actionToggleDarkMode);
+        const QSignalBlocker buttonBlocker(ui->modeBtn);
+        ui->actionToggleDarkMode->setChecked(useDarkMode);
+        ui->modeBtn->setChecked(useDarkMode);
+    }
     applyTheme(useDarkMode);
-
-    if (ui->curveWidget && ui->curveWidget->undoStack()) {
-        QUndoStack *undoStack = ui->curveWidget->undoStack();
-        QAction *undoAction = undoStack->createUndoAction(this, tr("&Undo"));
-        undoAction->setShortcut(QKeySequence::Undo);
-        QAction *redoAction = undoStack->createRedoAction(this, tr("&Redo"));
-        redoAction->setShortcut(QKeySequence::Redo);
-
-        if(ui->menuEdit) {
-            ui->menuEdit->addAction(undoAction);
-            ui->menuEdit->addAction(redoAction);
-        } else {
-            qWarning() << "Could not find menu 'menuEdit'. Add it in the UI Designer.";
-        }
+    StartupProfiler::mark("theme applied");
+
+    m_transformSelectionAction = new QAction(tr("&Transform Selection..."), this);
+    m_transformSelectionAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_T));
+    m_transformSelectionAction->setEnabled(false);
+    connect(m_transformSelectionAction, &QAction::triggered, this, &MainWindow::onTransformSelectionTriggered);
+
+    // The group follows the current document, so Undo/Redo always act on the visible tab.
+    QAction *undoAction = m_undoGroup->createUndoAction(this, tr("&Undo"));
+    undoAction->setShortcut(QKeySequence::Undo);
+    QAction *redoAction = m_undoGroup->createRedoAction(this, tr("&Redo"));
+    redoAction->setShortcut(QKeySequence::Redo);
+
+    if(ui->menuEdit) {
+        ui->menuEdit->addAction(undoAction);
+        ui->menuEdit->addAction(redoAction);
+        ui->menuEdit->addSeparator();
+        // No shortcuts here: Ctrl+C/V/D are handled by the curve widget so text fields keep theirs.
+        ui->menuEdit->addAction(tr("Copy Nodes"), this, [this]() { m_curveWidget->copySelection(); });
+        ui->menuEdit->addAction(tr("Paste Nodes"), this, [this]() { m_curveWidget->pasteNodes(); });
+        ui->menuEdit->addAction(tr("Duplicate to Other Channels"), this, [this]() { m_curveWidget->duplicateSelectionToOtherChannels(); });
+        m_linkChannelsAction = ui->menuEdit->addAction(tr("Link Channels"));
+        m_linkChannelsAction->setCheckable(true);
+        connect(m_linkChannelsAction, &QAction::toggled, this, [this](bool linked) {
+            m_curveWidget->setChannelsLinked(linked);
+        });
+        ui->menuEdit->addSeparator();
+        ui->menuEdit->addAction(m_transformSelectionAction);
+        ui->menuEdit->addAction(tr("Auto Curves from Image..."), this, &MainWindow::onAutoCurvesTriggered);
+        ui->menuEdit->addAction(tr("Match Image Colors..."), this, &MainWindow::onMatchColorsTriggered);
     } else {
-        qCritical() << "CurveWidget instance or its UndoStack is null!";
+        qWarning() << "Could not find menu 'menuEdit'. Add it in the UI Designer.";
     }
 
     m_channelGroup = new QButtonGroup(this);
@@ -105,6 +267,10 @@ MainWindow::MainWindow(QWidget *parent)
     } else {
         if (ui->channelRedButton) ui->channelRedButton->setChecked(true);
         connect(m_channelGroup, &QButtonGroup::buttonClicked, this, &MainWindow::onChannelButtonClicked);
+        if (ui->animationPreviewWidget) {
+            connect(m_channelGroup, &QButtonGroup::buttonClicked,
+                    ui->animationPreviewWidget, QOverload<>::of(&QWidget::update));
+        }
     }
 
     QList<int> lutWidths = {16, 32, 64, 128, 256, 512};
@@ -125,28 +291,254 @@ MainWindow::MainWindow(QWidget *parent)
     }
     ui->filePathLineEdit->setText(defaultFullPath);
 
-    if (ui->curveWidget) {
-        connect(ui->curveWidget, &CurveWidget::curveChanged,
-                this, &MainWindow::updateLUTPreview);
-
-        connect(ui->curveWidget, &CurveWidget::selectionChanged,
-                this, &MainWindow::onCurveSelectionChanged);
-
-        ui->curveWidget->setDrawInactiveChannels(ui->actionInactiveChannels->isChecked());
-        ui->curveWidget->setHandlesClamping(ui->clampHandlesCheckbox->isChecked());
+    if (m_curveWidget) {
+        m_curveWidget->setDrawInactiveChannels(ui->actionInactiveChannels->isChecked());
+        m_curveWidget->setHandlesClamping(ui->clampHandlesCheckbox->isChecked());
+        bindDocument(m_curveWidget);
     }
 
-    updateLUTPreview();
+    m_gradientPreviewHeight = ui->lutPreviewLabel->maximumHeight();
+    m_lutFrameMaxHeight = ui->frame->maximumHeight();
+    m_previewErrorAction = new QAction(tr("Preview Quantization Error"), this);
+    m_previewErrorAction->setCheckable(true);
+    ui->menuView->addAction(m_previewErrorAction);
+    connect(m_previewErrorAction, &QAction::toggled, this, &MainWindow::onPreviewQuantizationErrorToggled);
+
+    m_libraryDock = new CurveLibraryDock(this);
+    addDockWidget(Qt::RightDockWidgetArea, m_libraryDock);
+    m_libraryDock->hide();
+    m_libraryDock->setDirectory(settings.value("Library/Directory").toString());
+    ui->menuView->addAction(m_libraryDock->toggleViewAction());
+    connect(m_libraryDock, &CurveLibraryDock::projectActivated, this, &MainWindow::loadProjectFile);
+    connect(m_libraryDock, &CurveLibraryDock::directoryChanged, this, [](const QString& directory) {
+        QSettings("MyCompany", "CurveMaker").setValue("Library/Directory", directory);
+    });
+    connect(m_errorAnalyzer, &LutErrorAnalyzer::analysisReady, this, &MainWindow::onErrorAnalysisReady);
+    connect(ui->lutSizeComboBox, &QComboBox::currentIndexChanged, this, &MainWindow::requestErrorAnalysis);
+    connect(ui->exportBitDepthComboBox, &QComboBox::currentIndexChanged, this, &MainWindow::requestErrorAnalysis);
+
+    // The first bake waits for the event loop so the preview labels have their laid-out size.
+    QTimer::singleShot(0, this, [this]() {
+        updateLUTPreview();
+        updateBoundsLabel();
+    });
     ui->freeBtn->setEnabled(false);
     ui->alignedBtn->setEnabled(false);
     ui->mirroredBtn->setEnabled(false);
+    StartupProfiler::mark("main window constructed");
 }
 
 MainWindow::~MainWindow()
 {
+    // A running image-curves job posts to this window; its result is dropped with it.
+    m_imageCurvesIdle.acquire();
     delete ui;
 }
 
+/**
+ * @brief Returns the curve widget of the current document.
+ */
+CurveWidget* MainWindow::curveWidget() const
+{
+    return m_curveWidget;
+}
+
+/**
+ * @brief Wraps the designer's curve widget in a tab bar plus stacked widget, so it
+ * becomes the first of any number of documents. The tab bar hides itself while
+ * only one document is open.
+ */
+void MainWindow::setupDocumentArea()
+{
+    CurveWidget *firstWidget = ui->curveWidget;
+
+    QWidget *documentArea = new QWidget(this);
+    documentArea->setSizePolicy(firstWidget->sizePolicy());
+    QVBoxLayout *areaLayout = new QVBoxLayout(documentArea);
+    areaLayout->setContentsMargins(0, 0, 0, 0);
+    areaLayout->setSpacing(0);
+
+    m_documentTabs = new QTabBar(documentArea);
+    m_documentTabs->setTabsClosable(true);
+    m_documentTabs->setMovable(false);
+    m_documentTabs->setAutoHide(true);
+    m_documentTabs->setDocumentMode(true);
+    m_documentTabs->setExpanding(false);
+
+    m_documentStack = new QStackedWidget(documentArea);
+    m_documentStack->setMaximumSize(firstWidget->maximumSize());
+    areaLayout->addWidget(m_documentTabs);
+    areaLayout->addWidget(m_documentStack);
+
+    ui->horizontalLayout_5->replaceWidget(firstWidget, documentArea);
+    m_documentStack->addWidget(firstWidget);
+
+    m_curveWidget = firstWidget;
+    addDocument(firstWidget);
+
+    connect(m_documentTabs, &QTabBar::currentChanged, this, &MainWindow::onDocumentTabChanged);
+    connect(m_documentTabs, &QTabBar::tabCloseRequested, this, &MainWindow::closeDocument);
+}
+
+/**
+ * @brief Registers a curve widget as a document: its undo stack joins the group and
+ * it gets a tab whose title tracks the stack's clean state.
+ * @return The new document's index.
+ */
+int MainWindow::addDocument(CurveWidget *widget)
+{
+    m_documents.append({widget, QString()});
+    m_undoGroup->addStack(widget->undoStack());
+    connect(widget->undoStack(), &QUndoStack::cleanChanged, this, [this, widget]() {
+        for (int i = 0; i < m_documents.size(); ++i) {
+            if (m_documents[i].widget == widget) updateDocumentTitle(i);
+        }
+    });
+
+    const int index = m_documentTabs->addTab(QString());
+    updateDocumentTitle(index);
+    return index;
+}
+
+/**
+ * @brief Creates an empty document with the window's current display settings and
+ * makes it current.
+ */
+void MainWindow::onNewDocumentTriggered()
+{
+    CurveWidget *templateWidget = m_curveWidget;
+    CurveWidget *widget = new CurveWidget(m_documentStack);
+    widget->setSizePolicy(templateWidget->sizePolicy());
+    widget->setMaximumSize(templateWidget->maximumSize());
+    widget->setFocusPolicy(templateWidget->focusPolicy());
+    widget->setToolTip(templateWidget->toolTip());
+    widget->setDarkMode(ui->actionToggleDarkMode->isChecked());
+    widget->setDrawInactiveChannels(ui->actionInactiveChannels->isChecked());
+    widget->setHandlesClamping(ui->clampHandlesCheckbox->isChecked());
+    widget->setActiveChannel(templateWidget->getActiveChannel());
+    m_documentStack->addWidget(widget);
+
+    m_documentTabs->setCurrentIndex(addDocument(widget));
+}
+
+/**
+ * @brief Closes a document, asking first if it has unsaved edits. Closing the last
+ * document leaves a fresh empty one behind.
+ */
+void MainWindow::closeDocument(int index)
+{
+    if (index < 0 || index >= m_documents.size()) return;
+
+    CurveWidget *widget = m_documents[index].widget;
+    if (!widget->undoStack()->isClean()) {
+        const QMessageBox::StandardButton answer = QMessageBox::question(
+            this, tr("Close Document"),
+            tr("Discard unsaved changes to \"%1\"?").arg(documentName(index)),
+            QMessageBox::Discard | QMessageBox::Cancel, QMessageBox::Cancel);
+        if (answer != QMessageBox::Discard) return;
+    }
+
+    if (m_documents.size() == 1) {
+        onNewDocumentTriggered();
+    }
+
+    // Drop the entry before the tab so the tab change handler sees consistent indices.
+    m_documents.removeAt(index);
+    m_documentTabs->removeTab(index);
+    m_documentStack->removeWidget(widget);
+    widget->deleteLater();
+}
+
+/**
+ * @brief Makes the document at index current. The one being left releases its
+ * render caches; its curves and undo history stay in memory.
+ */
+void MainWindow::onDocumentTabChanged(int index)
+{
+    if (index < 0 || index >= m_documents.size()) return;
+
+    CurveWidget *widget = m_documents[index].widget;
+    if (widget == m_curveWidget) return;
+
+    if (m_curveWidget) {
+        m_curveWidget->releaseRenderCaches();
+    }
+    m_curveWidget = widget;
+    m_documentStack->setCurrentWidget(widget);
+    bindDocument(widget);
+
+    updateLUTPreview();
+    updateBoundsLabel();
+    onCurveSelectionChanged();
+    requestErrorAnalysis();
+}
+
+/**
+ * @brief Points the window's signals, actions and previews at widget. Connections
+ * made for the previous document are dropped first.
+ */
+void MainWindow::bindDocument(CurveWidget *widget)
+{
+    for (const QMetaObject::Connection& connection : std::as_const(m_documentConnections)) {
+        disconnect(connection);
+    }
+    m_documentConnections.clear();
+
+    m_documentConnections
+        << connect(widget, &CurveWidget::curveEdited, this, &MainWindow::onCurveEdited)
+        << connect(widget, &CurveWidget::selectionChanged, this, &MainWindow::onCurveSelectionChanged)
+        << connect(widget, &CurveWidget::curveChanged, this, &MainWindow::requestErrorAnalysis);
+
+    if (ui->animationPreviewWidget) {
+        ui->animationPreviewWidget->setCurveWidget(widget);
+        // The animation follows the active channel only, so edits elsewhere need no repaint.
+        AnimationPreviewWidget *animationPreview = ui->animationPreviewWidget;
+        m_documentConnections << connect(widget, &CurveWidget::curveEdited, animationPreview,
+                                         [widget, animationPreview](const QVector<CurveWidget::CurveChange>& changes) {
+            for (const CurveWidget::CurveChange& change : changes) {
+                if (change.channel == widget->getActiveChannel()) {
+                    animationPreview->update();
+                    return;
+                }
+            }
+        });
+    }
+
+    m_undoGroup->setActiveStack(widget->undoStack());
+
+    if (m_linkChannelsAction) {
+        const QSignalBlocker blocker(m_linkChannelsAction);
+        m_linkChannelsAction->setChecked(widget->channelsLinked());
+    }
+
+    QAbstractButton *channelButton = nullptr;
+    switch (widget->getActiveChannel()) {
+    case CurveWidget::ActiveChannel::RED:   channelButton = ui->channelRedButton;   break;
+    case CurveWidget::ActiveChannel::GREEN: channelButton = ui->channelGreenButton; break;
+    case CurveWidget::ActiveChannel::BLUE:  channelButton = ui->channelBlueButton;  break;
+    }
+    if (channelButton) channelButton->setChecked(true);
+}
+
+QString MainWindow::documentName(int index) const
+{
+    const QString& filePath = m_documents[index].filePath;
+    return filePath.isEmpty() ? tr("Untitled") : QFileInfo(filePath).fileName();
+}
+
+/**
+ * @brief Refreshes a tab's title and tooltip; unsaved documents get a trailing '*'.
+ */
+void MainWindow::updateDocumentTitle(int index)
+{
+    if (index < 0 || index >= m_documents.size()) return;
+
+    QString title = documentName(index);
+    if (!m_documents[index].widget->undoStack()->isClean()) title += '*';
+    m_documentTabs->setTabText(index, title);
+    m_documentTabs->setTabToolTip(index, m_documents[index].filePath);
+}
+
 void MainWindow::on_actionToggleDarkMode_toggled(bool checked)
 {
     applyTheme(checked);
@@ -155,29 +547,24 @@ void MainWindow::on_actionToggleDarkMode_toggled(bool checked)
     ui->modeBtn->setChecked(checked);
 }
 
+/**
+ * @brief Applies the light or dark theme by swapping the application palette.
+ * The palettes are built once and cached; no stylesheet is parsed, so widgets are
+ * only repainted rather than repolished, and curve data is left untouched. Checked
+ * buttons and borders follow the palette through ThemeStyle.
+ */
 void MainWindow::applyTheme(bool dark)
 {
-    QString styleSheetPath = dark ? ":/themes/dark.qss" : ":/themes/light.qss";
-    QFile f(styleSheetPath);
-    QString styleSheet = "";
-    if (f.open(QFile::ReadOnly | QFile::Text)) {
-        QTextStream ts(&f);
-        styleSheet = ts.readAll();
-        f.close();
-    } else {
-        qWarning() << "Could not load theme file:" << styleSheetPath;
-    }
-    qApp->setStyleSheet(styleSheet);
+    qApp->setPalette(themePalette(dark));
 
-    if (ui->curveWidget) {
-        ui->curveWidget->setDarkMode(dark);
+    for (const Document& document : std::as_const(m_documents)) {
+        document.widget->setDarkMode(dark);
     }
-    updateLUTPreview();
 }
 
 void MainWindow::onChannelButtonClicked(QAbstractButton *button)
 {
-    if (!ui->curveWidget) {
+    if (!m_curveWidget) {
         qWarning("onChannelButtonClicked: curveWidget is null!");
         return;
     }
@@ -194,7 +581,8 @@ void MainWindow::onChannelButtonClicked(QAbstractButton *button)
         return;
     }
 
-    ui->curveWidget->setActiveChannel(channel);
+    m_curveWidget->setActiveChannel(channel);
+    updateBoundsLabel();
 
     if (!m_isPreviewRgbCombined) {
         qDebug() << "Active channel changed, updating preview (single channel mode active).";
@@ -213,7 +601,7 @@ void MainWindow::on_actionPreviewRgb_toggled(bool checked)
 
 void MainWindow::onCurveSelectionChanged()
 {
-    if (!ui->curveWidget) {
+    if (!m_curveWidget) {
         qWarning("onCurveSelectionChanged: curveWidget is null!");
         ui->freeBtn->setEnabled(false);
         ui->alignedBtn->setEnabled(false);
@@ -225,18 +613,19 @@ void MainWindow::onCurveSelectionChanged()
         return;
     }
 
-    QSet<int> selectedIndices = ui->curveWidget->getSelectedIndices();
+    const NodeSelection& selectedIndices = m_curveWidget->getSelectedIndices();
+    m_transformSelectionAction->setEnabled(!selectedIndices.isEmpty());
     bool singleNodeSelected = (selectedIndices.size() == 1);
     bool enableAlignmentButtons = false;
     CurveWidget::HandleAlignment currentAlignment = CurveWidget::HandleAlignment::Free;
 
     if (singleNodeSelected) {
-        m_selectedNodeIndex = *selectedIndices.constBegin();
+        m_selectedNodeIndex = selectedIndices.first();
 
-        int nodeCount = ui->curveWidget->getActiveNodeCount();
+        int nodeCount = m_curveWidget->getActiveNodeCount();
         if (m_selectedNodeIndex > 0 && m_selectedNodeIndex < nodeCount - 1) {
             enableAlignmentButtons = true;
-            currentAlignment = ui->curveWidget->getAlignment(m_selectedNodeIndex);
+            currentAlignment = m_curveWidget->getAlignment(m_selectedNodeIndex);
         } else {
             m_selectedNodeIndex = -1;
             enableAlignmentButtons = false;
@@ -275,6 +664,10 @@ void MainWindow::on_browseButton_clicked()
     int currentDepth = ui->exportBitDepthComboBox->currentData().toInt();
     QString filter = tr("PNG Image (*.png)");
     QString defaultSuffix = ".png";
+    if (currentDepth == 32) {
+        filter = tr("Portable Float Map (*.pfm)");
+        defaultSuffix = ".pfm";
+    }
 
     QString fileName = QFileDialog::getSaveFileName(this,
                                                     tr("Save Combined RGB LUT Image"),
@@ -293,82 +686,166 @@ void MainWindow::on_browseButton_clicked()
 }
 
 /**
- * @brief Slot to update the LUT preview display. Generates a 1D combined RGB LUT image.
+ * @brief Slot to update the LUT preview displays. Samples the curves straight into
+ * the preview widgets' texel buffers (combined RGB, or the active channel as grayscale).
  */
 void MainWindow::updateLUTPreview()
 {
     const int previewWidth = 256;
-    QImage rgbLutImage;
-    QImage secondaryLutImage;
+    QElapsedTimer bakeTimer;
+    bakeTimer.start();
 
-    if (!ui->curveWidget) {
-        qWarning("updateLUTPreview: curveWidget is null!");
-        QPixmap errorPixmap;
-        if(ui->lutPreviewLabel) errorPixmap = QPixmap(ui->lutPreviewLabel->size());
-        else errorPixmap = QPixmap(100, 20);
-        errorPixmap.fill(Qt::darkGray);
-        QPainter painter(&errorPixmap);
-        painter.setPen(Qt::white);
-        painter.drawText(errorPixmap.rect(), Qt::AlignCenter, "Error: No Curve Widget");
-        painter.end();
-
-        if(ui->lutPreviewLabel) ui->lutPreviewLabel->setPixmap(errorPixmap);
-        if(ui->lutPreviewLabel_3) ui->lutPreviewLabel_3->setPixmap(errorPixmap.scaled(ui->lutPreviewLabel_3->size(), Qt::KeepAspectRatio));
+    LutPreviewWidget *rgbPreview = ui->lutPreviewLabel;
+    LutPreviewWidget *curvePreview = ui->lutPreviewLabel_3;
 
+    if (!m_curveWidget) {
+        qWarning("updateLUTPreview: curveWidget is null!");
+        rgbPreview->setErrorText(tr("Error: No Curve Widget"));
+        curvePreview->setErrorText(tr("Error: No Curve Widget"));
         return;
     }
 
-    rgbLutImage = generateCombinedRgbLut1D(previewWidth);
+    // onCurveEdited() keeps the row current while editing; anything else (tab switch,
+    // first show) takes it from the shared cache or bakes it in full.
+    if (m_previewRowWidget != m_curveWidget || m_previewRowRevision != m_curveWidget->revision()
+        || m_previewRow.size() != previewWidth * 3) {
+        m_previewRow = BakeService::instance().bakeRgb(m_curveWidget->getAllChannelNodes(), previewWidth);
+        m_previewRowWidget = m_curveWidget;
+        m_previewRowRevision = m_curveWidget->revision();
+    }
+
+    rgbPreview->setTexelCount(previewWidth);
+    curvePreview->setTexelCount(previewWidth);
+
+    fillPreviewTexels(rgbPreview->texelData(), m_previewRow, previewWidth, true);
+    rgbPreview->commitTexels();
 
-    if (!rgbLutImage.isNull()) {
-        QPixmap rgbPixmap = QPixmap::fromImage(rgbLutImage);
-        ui->lutPreviewLabel->setPixmap(rgbPixmap.scaled(ui->lutPreviewLabel->size(),
-                                                        Qt::IgnoreAspectRatio,
-                                                        Qt::SmoothTransformation));
+    if (m_isPreviewRgbCombined) {
+        std::memcpy(curvePreview->texelData(), rgbPreview->texelData(), static_cast<size_t>(previewWidth) * 3);
     } else {
-        qWarning("updateLUTPreview: Failed to generate Combined RGB LUT image.");
-        ui->lutPreviewLabel->clear();
-        QPixmap errorPixmap(ui->lutPreviewLabel->size());
-        errorPixmap.fill(Qt::red);
-        QPainter painter(&errorPixmap);
-        painter.drawText(errorPixmap.rect(), Qt::AlignCenter, "RGB Gen Error");
-        painter.end();
-        ui->lutPreviewLabel->setPixmap(errorPixmap);
-    }
-
-    if (ui->lutPreviewLabel_3) {
-        if (m_isPreviewRgbCombined) {
-            if (!rgbLutImage.isNull()) {
-                QPixmap rgbPixmap = QPixmap::fromImage(rgbLutImage);
-                ui->lutPreviewLabel_3->setPixmap(rgbPixmap.scaled(ui->lutPreviewLabel_3->size(),
-                                                                  Qt::IgnoreAspectRatio,
-                                                                  Qt::SmoothTransformation));
-            } else {
-                ui->lutPreviewLabel_3->clear();
-            }
+        fillPreviewTexels(curvePreview->texelData(), m_previewRow, previewWidth, false);
+    }
+    curvePreview->commitTexels();
+
+    emit previewBaked(bakeTimer.nsecsElapsed());
+}
+
+/**
+ * @brief Slot for CurveWidget::curveEdited(). If the preview row is that of the state
+ * right before this edit, only the texels inside the changed x ranges are resampled;
+ * otherwise updateLUTPreview() bakes the row in full.
+ */
+void MainWindow::onCurveEdited(const QVector<CurveWidget::CurveChange>& changes)
+{
+    const int previewWidth = 256;
+    if (m_curveWidget && !changes.isEmpty() && m_previewRowWidget == m_curveWidget
+        && m_previewRowRevision + 1 == changes.first().revision && m_previewRow.size() == previewWidth * 3) {
+        m_previewRow = BakeService::instance().rebakeRgb(m_previewRow, m_curveWidget->getAllChannelNodes(),
+                                                         previewWidth, changes);
+        m_previewRowRevision = changes.first().revision;
+    }
+    updateLUTPreview();
+
+    for (const CurveWidget::CurveChange& change : changes) {
+        if (m_curveWidget && change.channel == m_curveWidget->getActiveChannel()) {
+            updateBoundsLabel();
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Shows the active channel's unclamped range, overshoot and mean in the status bar.
+ */
+void MainWindow::updateBoundsLabel()
+{
+    if (!m_boundsLabel || !m_curveWidget) return;
+
+    const CurveWidget::ChannelBounds bounds = m_curveWidget->channelBounds(m_curveWidget->getActiveChannel());
+    QString text = tr("Range %1 to %2, mean %3").arg(bounds.minY, 0, 'f', 3).arg(bounds.maxY, 0, 'f', 3)
+                   .arg(bounds.integral, 0, 'f', 3);
+    if (bounds.overshootAbove() > 0.0) {
+        text += tr(", overshoot +%1 at x = %2").arg(bounds.overshootAbove(), 0, 'f', 3).arg(bounds.maxX, 0, 'f', 3);
+    }
+    if (bounds.overshootBelow() > 0.0) {
+        text += tr(", undershoot -%1 at x = %2").arg(bounds.overshootBelow(), 0, 'f', 3).arg(bounds.minX, 0, 'f', 3);
+    }
+    m_boundsLabel->setText(text);
+    m_boundsLabel->setStyleSheet(bounds.overshoots() ? QStringLiteral("color: #d08020;") : QString());
+}
+
+/**
+ * @brief Converts a baked RGB row into RGB888 texels.
+ * @param texels - Destination buffer of at least width * 3 bytes.
+ * @param rgb - Interleaved R, G, B values of width texels, as from BakeService::bakeRgb().
+ * @param width - Number of texels.
+ * @param combined - true for R/G/B channels, false for the active channel as gray.
+ */
+void MainWindow::fillPreviewTexels(uchar *texels, const QVector<float>& rgb, int width, bool combined) const
+{
+    if (!texels || width < 1 || rgb.size() < width * 3) return;
+
+    int grayChannel = 0;
+    switch (m_curveWidget->getActiveChannel()) {
+    case CurveWidget::ActiveChannel::RED:   grayChannel = 0; break;
+    case CurveWidget::ActiveChannel::GREEN: grayChannel = 1; break;
+    case CurveWidget::ActiveChannel::BLUE:  grayChannel = 2; break;
+    }
+    auto toByte = [](float v) {
+        return static_cast<uchar>(std::lround(std::max(0.0f, std::min(1.0f, v)) * 255.0f));
+    };
+
+    for (int i = 0; i < width; ++i) {
+        const float *source = rgb.constData() + i * 3;
+        uchar *texel = texels + i * 3;
+        if (combined) {
+            texel[0] = toByte(source[0]);
+            texel[1] = toByte(source[1]);
+            texel[2] = toByte(source[2]);
         } else {
-            CurveWidget::ActiveChannel activeChannel = ui->curveWidget->getActiveChannel();
-            secondaryLutImage = generateSingleChannelLut1D(activeChannel, previewWidth);
-
-            if (!secondaryLutImage.isNull()) {
-                QPixmap secondaryPixmap = QPixmap::fromImage(secondaryLutImage);
-                ui->lutPreviewLabel_3->setPixmap(secondaryPixmap.scaled(ui->lutPreviewLabel_3->size(),
-                                                                        Qt::IgnoreAspectRatio,
-                                                                        Qt::SmoothTransformation));
-            } else {
-                qWarning("updateLUTPreview: Failed to generate Single Channel LUT image.");
-                ui->lutPreviewLabel_3->clear();
-                QPixmap errorPixmap(ui->lutPreviewLabel_3->size());
-                errorPixmap.fill(Qt::red);
-                QPainter painter(&errorPixmap);
-                painter.drawText(errorPixmap.rect(), Qt::AlignCenter, "Grayscale Gen Error");
-                painter.end();
-                ui->lutPreviewLabel_3->setPixmap(errorPixmap);
-            }
+            texel[0] = texel[1] = texel[2] = toByte(source[grayChannel]);
         }
     }
 }
 
+/**
+ * @brief Switches the LUT tab preview between the gradient and the value/error graph.
+ * The graph needs more height than the gradient strip, so the preview grows while it is shown.
+ */
+void MainWindow::onPreviewQuantizationErrorToggled(bool checked)
+{
+    LutPreviewWidget *preview = ui->lutPreviewLabel;
+    if (checked) {
+        preview->setDisplayMode(LutPreviewWidget::DisplayMode::ValueGraph);
+        preview->setFixedHeight(160);
+        ui->frame->setMaximumHeight(QWIDGETSIZE_MAX);
+        requestErrorAnalysis();
+    } else {
+        preview->setDisplayMode(LutPreviewWidget::DisplayMode::Gradient);
+        preview->setFixedHeight(m_gradientPreviewHeight);
+        ui->frame->setMaximumHeight(m_lutFrameMaxHeight);
+    }
+}
+
+/**
+ * @brief Requests the quantization error analysis for the current curves and export settings.
+ * Does nothing unless the error preview is visible.
+ */
+void MainWindow::requestErrorAnalysis()
+{
+    if (!m_curveWidget || !m_previewErrorAction || !m_previewErrorAction->isChecked()) return;
+
+    int lutWidth = ui->lutSizeComboBox->currentData().toInt();
+    int bitDepth = ui->exportBitDepthComboBox->currentData().toInt();
+    const CurveSampler::ChannelMap channels = m_curveWidget->getAllChannelNodes();
+    m_errorAnalyzer->request(CurveSampler(channels), BakeService::contentKey(channels), lutWidth, bitDepth);
+}
+
+void MainWindow::onErrorAnalysisReady(const LutErrorAnalysis& analysis)
+{
+    ui->lutPreviewLabel->setErrorAnalysis(analysis);
+}
+
 /**
  * @brief Slot called when the export button is clicked. Generates and saves the 1D Combined RGB LUT.
  */
@@ -387,6 +864,10 @@ void MainWindow::on_exportButton_clicked()
         return;
     }
 
+    if (bitDepth == 32) {
+        exportFloatLut(filePath, lutWidth);
+        return;
+    }
     if (bitDepth != 8 && bitDepth != 16) {
         QMessageBox::critical(this, tr("Export Error"), tr("Invalid bit depth selected."));
         return;
@@ -416,64 +897,215 @@ void MainWindow::on_exportButton_clicked()
  */
 QImage MainWindow::generateCombinedRgbLut1D(int width, int bitDepth)
 {
-    if (width < 1 || !ui->curveWidget || (bitDepth != 8 && bitDepth != 16)) {
+    if (width < 1 || !m_curveWidget || (bitDepth != 8 && bitDepth != 16)) {
         qWarning() << "generateCombinedRgbLut1D: Invalid parameters.";
         return QImage();
     }
 
-    QImage::Format format = (bitDepth == 16) ? QImage::Format_RGBA64 : QImage::Format_RGB888;
+    const LutExport::Content content = LutExport::contentFromName(ui->lutContentComboBox->currentData().toString());
+    const QVector<float> rgb = (content == LutExport::Content::Values)
+        ? BakeService::instance().bakeRgb(m_curveWidget->getAllChannelNodes(), width)
+        : LutExport::bakeIntegralRgb(m_curveWidget->getAllChannelNodes(), width,
+                                     content == LutExport::Content::NormalizedIntegral);
+    return LutExport::rgbLutImage(rgb, width, bitDepth);
+}
 
-    QImage image(width, 1, format);
-    if (image.isNull()) {
-        qWarning() << "Failed to create QImage for" << bitDepth << "-bit LUT (width:" << width << ")";
-        return QImage();
+/**
+ * @brief Writes the combined RGB LUT as a float PFM without clamping. If a curve
+ * overshoots [0, 1], values are normalized from the exact curve extremes instead,
+ * and the range is written next to the image so it can be undone.
+ */
+bool MainWindow::exportFloatLut(const QString& filePath, int width)
+{
+    QVector<CurveWidget::ChannelBounds> bounds;
+    for (CurveWidget::ActiveChannel channel : { CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN,
+                                                CurveWidget::ActiveChannel::BLUE }) {
+        bounds.append(m_curveWidget->channelBounds(channel));
+    }
+    // Integrals are written as they are; only curve values get the overshoot range.
+    const LutExport::Content content = LutExport::contentFromName(ui->lutContentComboBox->currentData().toString());
+    const FloatRange range = (content == LutExport::Content::Values) ? LutExport::normalizationRange(bounds) : FloatRange();
+    const QVector<float> rgb = (content == LutExport::Content::Values)
+        ? LutExport::bakeFloatRgb(m_curveWidget->getAllChannelNodes(), width, range)
+        : LutExport::bakeIntegralRgb(m_curveWidget->getAllChannelNodes(), width,
+                                     content == LutExport::Content::NormalizedIntegral);
+
+    QString errorMessage;
+    if (!LutExport::writePfm(filePath, rgb.constData(), width, 1, &errorMessage)
+        || !LutExport::writeRangeSidecar(filePath, range, &errorMessage)) {
+        QMessageBox::critical(this, tr("Export Error"), tr("Failed to save float LUT to:\n%1\n%2").arg(filePath, errorMessage));
+        return false;
     }
 
-    for (int i = 0; i < width; ++i) {
-        qreal t = (width == 1) ? 0.0 : static_cast<qreal>(i) / (width - 1.0);
+    QString message = tr("32-bit float Combined RGB LUT saved to:\n%1").arg(filePath);
+    if (!range.isUnit()) {
+        message += tr("\n\nThe curves overshoot [0, 1], so values were normalized from [%1, %2]. "
+                      "The range is stored in %3.")
+                   .arg(range.min, 0, 'f', 4).arg(range.max, 0, 'f', 4).arg(QFileInfo(LutExport::rangeSidecarPath(filePath)).fileName());
+    }
+    QMessageBox::information(this, tr("Export Successful"), message);
+    return true;
+}
 
-        qreal yR_norm = ui->curveWidget->sampleCurveChannel(CurveWidget::ActiveChannel::RED, t);
-        qreal yG_norm = ui->curveWidget->sampleCurveChannel(CurveWidget::ActiveChannel::GREEN, t);
-        qreal yB_norm = ui->curveWidget->sampleCurveChannel(CurveWidget::ActiveChannel::BLUE, t);
+/**
+ * @brief Asks for threshold values and writes where the current curves cross them as a
+ * sorted event table, by default next to the LUT export path.
+ */
+void MainWindow::onExportEventsTriggered()
+{
+    if (!m_curveWidget) return;
 
-        yR_norm = std::max(0.0, std::min(1.0, yR_norm));
-        yG_norm = std::max(0.0, std::min(1.0, yG_norm));
-        yB_norm = std::max(0.0, std::min(1.0, yB_norm));
+    QSettings settings("MyCompany", "CurveMaker");
+    bool accepted = false;
+    const QString text = QInputDialog::getText(this, tr("Export Threshold Events"),
+                                               tr("Thresholds (comma separated):"), QLineEdit::Normal,
+                                               settings.value("Export/Thresholds", "0.5").toString(), &accepted);
+    if (!accepted) return;
+
+    bool valid = false;
+    const QVector<qreal> thresholds = CrossingSolver::parseThresholds(text, &valid);
+    if (!valid || thresholds.isEmpty()) {
+        QMessageBox::warning(this, tr("Export Error"), tr("Please enter one or more numbers, e.g. 0.25, 0.5."));
+        return;
+    }
+    settings.setValue("Export/Thresholds", text);
+
+    const QString lutPath = ui->filePathLineEdit->text();
+    const QString suggestion = lutPath.isEmpty() ? QString("events.json") : CrossingSolver::eventTablePath(lutPath);
+    const QString filePath = QFileDialog::getSaveFileName(this, tr("Save Threshold Events"), suggestion,
+                                                          tr("JSON Files (*.json)"));
+    if (filePath.isEmpty()) return;
+
+    const QVector<CrossingEvent> events = CrossingSolver::crossings(m_curveWidget->getAllChannelNodes(), thresholds);
+    QString errorMessage;
+    if (CrossingSolver::writeEventTable(filePath, events, thresholds, &errorMessage)) {
+        QMessageBox::information(this, tr("Export Successful"), tr("%1 events saved to:\n%2").arg(events.size()).arg(filePath));
+    } else {
+        QMessageBox::critical(this, tr("Export Error"), tr("Failed to save events to:\n%1\n%2").arg(filePath, errorMessage));
+    }
+}
 
-        QColor pixelColor = QColor::fromRgbF(yR_norm, yG_norm, yB_norm, 1.0);
+/**
+ * @brief Bakes the current curves at the frame times of a duration and frame rate and
+ * saves them as a frame-indexed strip (one texel per frame, PNG or PFM) or a CSV table.
+ */
+void MainWindow::onBakeFramesTriggered()
+{
+    if (!m_curveWidget) return;
 
-        image.setPixelColor(i, 0, pixelColor);
+    QSettings settings("MyCompany", "CurveMaker");
+    FrameTiming initial;
+    initial.duration = settings.value("FrameBake/Duration", initial.duration).toDouble();
+    initial.fps = settings.value("FrameBake/Fps", initial.fps).toDouble();
+    initial.supersamples = settings.value("FrameBake/Supersamples", initial.supersamples).toInt();
+    initial.loop = settings.value("FrameBake/Loop", initial.loop).toBool();
+
+    FrameBakeDialog dialog(initial, this);
+    if (dialog.exec() != QDialog::Accepted) return;
+    const FrameTiming timing = dialog.timing();
+    settings.setValue("FrameBake/Duration", timing.duration);
+    settings.setValue("FrameBake/Fps", timing.fps);
+    settings.setValue("FrameBake/Supersamples", timing.supersamples);
+    settings.setValue("FrameBake/Loop", timing.loop);
+
+    const QString pngFilter = tr("Frame Strip PNG (*.png)");
+    const QString pfmFilter = tr("Frame Strip Float (*.pfm)");
+    const QString csvFilter = tr("Frame Table CSV (*.csv)");
+    QString selectedFilter = pngFilter;
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Save Baked Frames"), QString(),
+                                                    pngFilter + ";;" + pfmFilter + ";;" + csvFilter, &selectedFilter);
+    if (filePath.isEmpty()) return;
+
+    QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix != "png" && suffix != "pfm" && suffix != "csv") {
+        suffix = (selectedFilter == pfmFilter) ? "pfm" : (selectedFilter == csvFilter) ? "csv" : "png";
+        filePath += '.' + suffix;
     }
 
-    return image;
+    // Float strips keep overshoot like the float LUT export: unclamped, normalized to a range sidecar.
+    const CurveSampler::ChannelMap channels = m_curveWidget->getAllChannelNodes();
+    const LutExport::Content content = LutExport::contentFromName(ui->lutContentComboBox->currentData().toString());
+    const QVector<float> rgb = LutExport::bakeFrameRgb(channels, timing, content, suffix != "pfm");
+    const int frames = timing.frameCount();
+    QString errorMessage;
+    bool saved = false;
+    if (suffix == "csv") {
+        saved = LutExport::writeFrameTable(filePath, rgb, timing, &errorMessage);
+    } else if (suffix == "pfm") {
+        const FloatRange range = (content == LutExport::Content::Values) ? LutExport::normalizationRange(channels) : FloatRange();
+        QVector<float> normalized = rgb;
+        for (float& value : normalized) value = static_cast<float>(range.normalize(value));
+        saved = LutExport::writePfm(filePath, normalized.constData(), frames, 1, &errorMessage)
+                && LutExport::writeRangeSidecar(filePath, range, &errorMessage);
+    } else {
+        const int bitDepth = ui->exportBitDepthComboBox->currentData().toInt() == 8 ? 8 : 16;
+        saved = LutExport::rgbLutImage(rgb, frames, bitDepth).save(filePath, "PNG");
+    }
+
+    if (saved) {
+        QMessageBox::information(this, tr("Export Successful"), tr("%1 frames saved to:\n%2").arg(frames).arg(filePath));
+    } else {
+        QMessageBox::critical(this, tr("Export Error"), tr("Failed to save frames to:\n%1\n%2").arg(filePath, errorMessage));
+    }
 }
 
-QImage MainWindow::generateSingleChannelLut1D(CurveWidget::ActiveChannel channel, int width)
+/**
+ * @brief Exports several widths and bit depths of the combined RGB LUT at once, named
+ * after the export path (e.g. lut_64.png, lut_1024_16bit.png). All variants come from
+ * one walk over the curves and are written in parallel.
+ */
+void MainWindow::onExportVariantsTriggered()
 {
-    if (width < 1 || !ui->curveWidget) return QImage();
-    QImage image(width, 1, QImage::Format_Grayscale8);
-    if (image.isNull()) return QImage();
-    uchar *line = image.scanLine(0);
-    for (int i = 0; i < width; ++i) {
-        qreal t = (width == 1) ? 0.0 : static_cast<qreal>(i) / (width - 1.0);
-        qreal y_norm = ui->curveWidget->sampleCurveChannel(channel, t);
-        y_norm = std::max(0.0, std::min(1.0, y_norm));
-        uchar gray_byte = static_cast<uchar>(std::round(y_norm * 255.0));
-        line[i] = gray_byte;
+    if (!m_curveWidget) return;
+
+    const QString basePath = ui->filePathLineEdit->text();
+    if (basePath.isEmpty()) {
+        QMessageBox::warning(this, tr("Export Error"), tr("Please specify an export file path."));
+        return;
+    }
+
+    QSettings settings("MyCompany", "CurveMaker");
+    bool accepted = false;
+    const QString text = QInputDialog::getText(this, tr("Export LUT Variants"),
+                                               tr("Widths, optionally with bit depth (e.g. 64, 256, 1024:16):"),
+                                               QLineEdit::Normal, settings.value("Export/Variants", "64, 256, 1024").toString(),
+                                               &accepted);
+    if (!accepted) return;
+
+    bool valid = false;
+    QVector<LutTarget> targets = LutExport::parseTargets(text, ui->exportBitDepthComboBox->currentData().toInt(), &valid);
+    if (!valid || targets.isEmpty()) {
+        QMessageBox::warning(this, tr("Export Error"), tr("Please enter widths of at least 2, each optionally followed by :8, :16 or :32."));
+        return;
+    }
+    settings.setValue("Export/Variants", text);
+
+    QStringList paths;
+    for (LutTarget& target : targets) {
+        target.filePath = LutExport::targetPath(basePath, target);
+        paths.append(QFileInfo(target.filePath).fileName());
+    }
+
+    const LutExport::Content content = LutExport::contentFromName(ui->lutContentComboBox->currentData().toString());
+    const QStringList failures = LutExport::exportTargets(m_curveWidget->getAllChannelNodes(), targets, content,
+                                                          BakeService::instance().pool());
+    if (failures.isEmpty()) {
+        QMessageBox::information(this, tr("Export Successful"), tr("Saved %1 LUT variants:\n%2").arg(targets.size()).arg(paths.join('\n')));
+    } else {
+        QMessageBox::critical(this, tr("Export Error"), tr("Some variants could not be saved:\n%1").arg(failures.join('\n')));
     }
-    return image;
 }
 
 void MainWindow::on_resetButton_clicked()
 {
-    if (ui->curveWidget) {
-        ui->curveWidget->resetCurve();
+    if (m_curveWidget) {
+        m_curveWidget->resetCurve();
     }
 }
 
 QImage MainWindow::generateLutImage3D(int size)
 {
-    if (size < 2 || !ui->curveWidget) {
+    if (size < 2 || !m_curveWidget) {
         return QImage();
     }
 
@@ -494,9 +1126,9 @@ QImage MainWindow::generateLutImage3D(int size)
                 qreal inputG = static_cast<qreal>(g) / (size - 1.0);
                 qreal inputB = static_cast<qreal>(b) / (size - 1.0);
 
-                qreal outputR_norm = ui->curveWidget->sampleCurveChannel(CurveWidget::ActiveChannel::RED, inputR);
-                qreal outputG_norm = ui->curveWidget->sampleCurveChannel(CurveWidget::ActiveChannel::GREEN, inputG);
-                qreal outputB_norm = ui->curveWidget->sampleCurveChannel(CurveWidget::ActiveChannel::BLUE, inputB);
+                qreal outputR_norm = m_curveWidget->sampleCurveChannel(CurveWidget::ActiveChannel::RED, inputR);
+                qreal outputG_norm = m_curveWidget->sampleCurveChannel(CurveWidget::ActiveChannel::GREEN, inputG);
+                qreal outputB_norm = m_curveWidget->sampleCurveChannel(CurveWidget::ActiveChannel::BLUE, inputB);
 
                 outputR_norm = std::max(0.0, std::min(1.0, outputR_norm));
                 outputG_norm = std::max(0.0, std::min(1.0, outputG_norm));
@@ -521,14 +1153,14 @@ QImage MainWindow::generateLutImage3D(int size)
 
 void MainWindow::on_modeBtn_clicked(bool checked)
 {
+    // The action's toggled handler applies and persists the theme.
     ui->actionToggleDarkMode->setChecked(checked);
-    applyTheme(checked);
 }
 
 void MainWindow::on_actionInactiveChannels_toggled(bool checked)
 {
-    if (ui->curveWidget) {
-        ui->curveWidget->setDrawInactiveChannels(checked);
+    for (const Document& document : std::as_const(m_documents)) {
+        document.widget->setDrawInactiveChannels(checked);
     }
 }
 
@@ -538,11 +1170,11 @@ void MainWindow::on_actionInactiveChannels_toggled(bool checked)
  */
 void MainWindow::on_freeBtn_clicked()
 {
-    if (ui->curveWidget) {
-        QSet<int> selectedIndices = ui->curveWidget->getSelectedIndices();
+    if (m_curveWidget) {
+        const NodeSelection& selectedIndices = m_curveWidget->getSelectedIndices();
         if (selectedIndices.size() == 1) {
-            int index = *selectedIndices.constBegin();
-            ui->curveWidget->setNodeAlignment(index, CurveWidget::HandleAlignment::Free);
+            int index = selectedIndices.first();
+            m_curveWidget->setNodeAlignment(index, CurveWidget::HandleAlignment::Free);
         } else {
             qDebug() << "Free button clicked, but selection size is not 1.";
         }
@@ -555,11 +1187,11 @@ void MainWindow::on_freeBtn_clicked()
  */
 void MainWindow::on_alignedBtn_clicked()
 {
-    if (ui->curveWidget) {
-        QSet<int> selectedIndices = ui->curveWidget->getSelectedIndices();
+    if (m_curveWidget) {
+        const NodeSelection& selectedIndices = m_curveWidget->getSelectedIndices();
         if (selectedIndices.size() == 1) {
-            int index = *selectedIndices.constBegin();
-            ui->curveWidget->setNodeAlignment(index, CurveWidget::HandleAlignment::Aligned);
+            int index = selectedIndices.first();
+            m_curveWidget->setNodeAlignment(index, CurveWidget::HandleAlignment::Aligned);
         } else {
             qDebug() << "Aligned button clicked, but selection size is not 1.";
         }
@@ -572,11 +1204,11 @@ void MainWindow::on_alignedBtn_clicked()
  */
 void MainWindow::on_mirroredBtn_clicked()
 {
-    if (ui->curveWidget) {
-        QSet<int> selectedIndices = ui->curveWidget->getSelectedIndices();
+    if (m_curveWidget) {
+        const NodeSelection& selectedIndices = m_curveWidget->getSelectedIndices();
         if (selectedIndices.size() == 1) {
-            int index = *selectedIndices.constBegin();
-            ui->curveWidget->setNodeAlignment(index, CurveWidget::HandleAlignment::Mirrored);
+            int index = selectedIndices.first();
+            m_curveWidget->setNodeAlignment(index, CurveWidget::HandleAlignment::Mirrored);
         } else {
             qDebug() << "Mirrored button clicked, but selection size is not 1.";
         }
@@ -585,8 +1217,8 @@ void MainWindow::on_mirroredBtn_clicked()
 
 void MainWindow::on_clampHandlesCheckbox_stateChanged(int state)
 {
-    if (ui->curveWidget) {
-        ui->curveWidget->setHandlesClamping(state == Qt::Checked);
+    for (const Document& document : std::as_const(m_documents)) {
+        document.widget->setHandlesClamping(state == Qt::Checked);
     }
 }
 
@@ -595,7 +1227,7 @@ void MainWindow::on_clampHandlesCheckbox_stateChanged(int state)
  * Saves the current curve data and relevant UI settings to a JSON file.
  */
 void MainWindow::onSaveCurvesActionTriggered() {
-    if (!ui->curveWidget) {
+    if (!m_curveWidget) {
         QMessageBox::critical(this, tr("Save Error"), tr("Curve widget is not available."));
         return;
     }
@@ -618,69 +1250,25 @@ void MainWindow::onSaveCurvesActionTriggered() {
         fileName += ".json";
     }
 
-    QMap<CurveWidget::ActiveChannel, QVector<CurveWidget::CurveNode>> curveData = ui->curveWidget->getAllChannelNodes();
-    int lutWidth = ui->lutSizeComboBox->currentData().toInt();
-    int bitDepth = ui->exportBitDepthComboBox->currentData().toInt();
-    bool previewRgb = ui->actionPreviewRgb->isChecked();
-    bool drawInactive = ui->actionInactiveChannels->isChecked();
-    bool clampHandles = ui->clampHandlesCheckbox->isChecked();
-
-    QJsonObject rootObj;
-    rootObj["file_format_version"] = "1.1";
-
-    QJsonObject settingsObj;
-    settingsObj["lut_width"] = lutWidth;
-    settingsObj["export_bit_depth"] = bitDepth;
-    settingsObj["preview_rgb_combined"] = previewRgb;
-    settingsObj["draw_inactive"] = drawInactive;
-    settingsObj["clamp_handles"] = clampHandles;
-    rootObj["settings"] = settingsObj;
-
-    QJsonObject channelsObj;
-    for (auto it = curveData.constBegin(); it != curveData.constEnd(); ++it) {
-        CurveWidget::ActiveChannel channelKey = it.key();
-        const QVector<CurveWidget::CurveNode>& nodesVector = it.value();
-
-        QString channelStringKey;
-        switch(channelKey) {
-        case CurveWidget::ActiveChannel::RED:   channelStringKey = "RED";   break;
-        case CurveWidget::ActiveChannel::GREEN: channelStringKey = "GREEN"; break;
-        case CurveWidget::ActiveChannel::BLUE:  channelStringKey = "BLUE";  break;
-        default:
-            qWarning() << "Skipping unknown channel key during save:" << static_cast<int>(channelKey);
-            continue;
-        }
-
-        QJsonArray nodesArray;
-        for (const CurveWidget::CurveNode& node : nodesVector) {
-            QJsonObject nodeObj;
-            nodeObj["main"] = QJsonArray({node.mainPoint.x(), node.mainPoint.y()});
-            nodeObj["in"]   = QJsonArray({node.handleIn.x(), node.handleIn.y()});
-            nodeObj["out"]  = QJsonArray({node.handleOut.x(), node.handleOut.y()});
-            nodeObj["align"] = static_cast<int>(node.alignment);
-            nodesArray.append(nodeObj);
-        }
-        channelsObj[channelStringKey] = nodesArray;
-    }
-    rootObj["channels"] = channelsObj;
-
-    QJsonDocument saveDoc(rootObj);
-    QFile saveFile(fileName);
-    if (!saveFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open save file:" << fileName << saveFile.errorString();
-        QMessageBox::critical(this, tr("Save Error"), tr("Could not open file for writing:\n%1").arg(fileName));
+    ProjectSettings projectSettings;
+    projectSettings.lutWidth = ui->lutSizeComboBox->currentData().toInt();
+    projectSettings.exportBitDepth = ui->exportBitDepthComboBox->currentData().toInt();
+    projectSettings.lutContent = ui->lutContentComboBox->currentData().toString();
+    projectSettings.previewRgbCombined = ui->actionPreviewRgb->isChecked();
+    projectSettings.drawInactive = ui->actionInactiveChannels->isChecked();
+    projectSettings.clampHandles = ui->clampHandlesCheckbox->isChecked();
+
+    QString errorMessage;
+    if (!CurveProject::writeFile(fileName, m_curveWidget->getAllChannelNodes(), projectSettings, &errorMessage)) {
+        qWarning() << "Couldn't write save file:" << fileName << errorMessage;
+        QMessageBox::critical(this, tr("Save Error"), tr("Could not write file:\n%1\n%2").arg(fileName, errorMessage));
         return;
     }
 
-    QByteArray jsonData = saveDoc.toJson(QJsonDocument::Indented);
-    if (saveFile.write(jsonData) == -1) {
-        qWarning() << "Failed to write to save file:" << fileName << saveFile.errorString();
-        QMessageBox::critical(this, tr("Save Error"), tr("Failed to write data to file:\n%1").arg(fileName));
-        saveFile.close();
-        return;
-    }
-
-    saveFile.close();
+    const int documentIndex = m_documentTabs->currentIndex();
+    m_documents[documentIndex].filePath = fileName;
+    m_curveWidget->undoStack()->setClean();
+    updateDocumentTitle(documentIndex);
     QMessageBox::information(this, tr("Save Successful"), tr("Curves and settings saved to:\n%1").arg(fileName));
 }
 
@@ -689,7 +1277,7 @@ void MainWindow::onSaveCurvesActionTriggered() {
  * Loads curve data and UI settings from a JSON file.
  */
 void MainWindow::onLoadCurvesActionTriggered() {
-    if (!ui->curveWidget) {
+    if (!m_curveWidget) {
         QMessageBox::critical(this, tr("Load Error"), tr("Curve widget is not available."));
         return;
     }
@@ -705,162 +1293,330 @@ void MainWindow::onLoadCurvesActionTriggered() {
         return;
     }
 
-    QFile loadFile(fileName);
-    if (!loadFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qWarning() << "Couldn't open load file:" << fileName << loadFile.errorString();
-        QMessageBox::critical(this, tr("Load Error"), tr("Could not open file for reading:\n%1").arg(fileName));
-        return;
+    if (loadProjectFile(fileName)) {
+        QMessageBox::information(this, tr("Load Successful"), tr("Curves and settings loaded from:\n%1").arg(fileName));
     }
-    QByteArray saveData = loadFile.readAll();
-    loadFile.close();
+}
 
-    QJsonParseError parseError;
-    QJsonDocument loadDoc = QJsonDocument::fromJson(saveData, &parseError);
+/**
+ * @brief Opens a project file as a document and applies its settings. A file that is
+ * already open just has its tab made current.
+ * @return true on success; failures are reported to the user.
+ */
+bool MainWindow::loadProjectFile(const QString& fileName)
+{
+    const QString canonicalPath = QFileInfo(fileName).canonicalFilePath();
+    for (int i = 0; i < m_documents.size(); ++i) {
+        if (!m_documents[i].filePath.isEmpty() && QFileInfo(m_documents[i].filePath).canonicalFilePath() == canonicalPath) {
+            m_documentTabs->setCurrentIndex(i);
+            return true;
+        }
+    }
 
-    if (loadDoc.isNull()) {
-        qWarning() << "Failed to parse JSON:" << parseError.errorString() << "at offset" << parseError.offset;
-        QMessageBox::critical(this, tr("Load Error"), tr("Failed to parse curve file:\n%1\nError: %2").arg(fileName).arg(parseError.errorString()));
-        return;
+    CurveProject::ProjectData project;
+    QString errorMessage;
+    if (!CurveProject::readFile(fileName, project, &errorMessage)) {
+        qWarning() << "Failed to load curve file:" << fileName << errorMessage;
+        QMessageBox::critical(this, tr("Load Error"), tr("Failed to load curve file:\n%1\nError: %2").arg(fileName, errorMessage));
+        return false;
     }
-    if (!loadDoc.isObject()) {
-        QMessageBox::critical(this, tr("Load Error"), tr("Invalid curve file format (Root is not JSON object)."));
-        return;
+    qDebug() << "Loaded file version:" << project.formatVersion;
+    for (const QString& warning : std::as_const(project.warnings)) {
+        qWarning().noquote() << fileName << "-" << warning;
     }
 
-    QJsonObject rootObj = loadDoc.object();
+    // Files open in their own tab unless the current one is an untouched new document.
+    const int currentIndex = m_documentTabs->currentIndex();
+    if (!m_documents[currentIndex].filePath.isEmpty() || m_curveWidget->undoStack()->count() > 0) {
+        onNewDocumentTriggered();
+    }
+    m_curveWidget->setAllChannelNodes(project.channels);
+    const int documentIndex = m_documentTabs->currentIndex();
+    m_documents[documentIndex].filePath = fileName;
+    updateDocumentTitle(documentIndex);
+
+    bool foundWidth = false;
+    for(int i=0; i<ui->lutSizeComboBox->count(); ++i){
+        if(ui->lutSizeComboBox->itemData(i).toInt() == project.settings.lutWidth){
+            ui->lutSizeComboBox->setCurrentIndex(i);
+            foundWidth = true; break;
+        }
+    }
+    if (!foundWidth) {
+        qWarning() << "Loaded LUT Width" << project.settings.lutWidth << "not found in ComboBox list.";
+        ui->lutSizeComboBox->setCurrentText(QString::number(project.settings.lutWidth));
+    }
 
-    int loadedLutWidth = 256;
-    int loadedBitDepth = 8;
-    bool loadedPreviewRgb = true;
-    bool loadedDrawInactive = false;
-    bool loadedClampHandles = true;
-    QString fileVersion = rootObj.value("file_format_version").toString("unknown");
-    qDebug() << "Loading file version:" << fileVersion;
+    bool foundDepth = false;
+    for(int i=0; i<ui->exportBitDepthComboBox->count(); ++i){
+        if(ui->exportBitDepthComboBox->itemData(i).toInt() == project.settings.exportBitDepth){
+            ui->exportBitDepthComboBox->setCurrentIndex(i);
+            foundDepth = true; break;
+        }
+    }
+    if (!foundDepth) {
+        qWarning() << "Loaded Export Bit Depth" << project.settings.exportBitDepth << "not found in ComboBox list.";
+        ui->exportBitDepthComboBox->setCurrentIndex(0);
+    }
 
-    if (rootObj.contains("settings") && rootObj["settings"].isObject()) {
-        QJsonObject settingsObj = rootObj["settings"].toObject();
+    const int contentIndex = ui->lutContentComboBox->findData(
+        LutExport::contentName(LutExport::contentFromName(project.settings.lutContent)));
+    ui->lutContentComboBox->setCurrentIndex(std::max(0, contentIndex));
 
-        loadedLutWidth = settingsObj.value("lut_width").toInt(loadedLutWidth);
-        loadedBitDepth = settingsObj.value("export_bit_depth").toInt(loadedBitDepth);
-        loadedPreviewRgb = settingsObj.value("preview_rgb_combined").toBool(loadedPreviewRgb);
-        loadedDrawInactive = settingsObj.value("draw_inactive").toBool(loadedDrawInactive);
-        loadedClampHandles = settingsObj.value("clamp_handles").toBool(loadedClampHandles);
+    ui->clampHandlesCheckbox->setChecked(project.settings.clampHandles);
+    ui->actionInactiveChannels->setChecked(project.settings.drawInactive);
+    ui->actionPreviewRgb->setChecked(project.settings.previewRgbCombined);
+    return true;
+}
 
-        qDebug() << "Loaded Settings: Width" << loadedLutWidth << "Depth" << loadedBitDepth
-                 << "PreviewRGB" << loadedPreviewRgb << "DrawInactive" << loadedDrawInactive
-                 << "Clamp" << loadedClampHandles;
-    } else {
-        qWarning() << "Settings object missing in file, using defaults.";
-    }
+/**
+ * @brief Opens the transform dialog for the current selection and applies the result as one undo step.
+ */
+void MainWindow::onTransformSelectionTriggered()
+{
+    if (!m_curveWidget || m_curveWidget->getSelectedIndices().isEmpty()) return;
 
-    if (!rootObj.contains("channels") || !rootObj["channels"].isObject()) {
-        QMessageBox::critical(this, tr("Load Error"), tr("Invalid curve file format (Missing 'channels' object)."));
-        return;
-    }
-    QJsonObject channelsObj = rootObj["channels"].toObject();
-    QMap<CurveWidget::ActiveChannel, QVector<CurveWidget::CurveNode>> loadedChannelNodes;
-    bool loadOk = true;
+    TransformSelectionDialog dialog(m_curveWidget->selectionBounds(), this);
+    if (dialog.exec() != QDialog::Accepted) return;
 
-    QList<QPair<QString, CurveWidget::ActiveChannel>> expectedChannels = {
-        {"RED", CurveWidget::ActiveChannel::RED},
-        {"GREEN", CurveWidget::ActiveChannel::GREEN},
-        {"BLUE", CurveWidget::ActiveChannel::BLUE}
-    };
+    if (!m_curveWidget->transformSelection(dialog.transform())) {
+        qDebug() << "Transform Selection: nothing changed.";
+    }
+}
 
-    for (const auto& pair : expectedChannels) {
-        QString channelStringKey = pair.first;
-        CurveWidget::ActiveChannel channelKey = pair.second;
+/**
+ * @brief Bakes a vertex animation texture of an OBJ mesh driven by the current curves
+ * (R, G, B offset X, Y, Z) and saves it as PFM or DDS with a `.vat.json` report next to it.
+ */
+void MainWindow::onBakeVatTriggered()
+{
+    if (!m_curveWidget) return;
 
-        if (!channelsObj.contains(channelStringKey) || !channelsObj[channelStringKey].isArray()) {
-            qWarning() << "Channel data missing or invalid for:" << channelStringKey;
-            loadOk = false;
-            break;
-        }
+    QSettings settings("MyCompany", "CurveMaker");
+    VatSettings initial;
+    initial.timing.duration = settings.value("VatBake/Duration", initial.timing.duration).toDouble();
+    initial.timing.fps = settings.value("VatBake/Fps", initial.timing.fps).toDouble();
+    initial.timing.loop = settings.value("VatBake/Loop", initial.timing.loop).toBool();
+    initial.amplitude = settings.value("VatBake/Amplitude", QVariant::fromValue(initial.amplitude)).value<QVector3D>();
+    initial.center = settings.value("VatBake/Center", initial.center).toDouble();
+    initial.phaseSource = static_cast<VatSettings::PhaseSource>(settings.value("VatBake/PhaseSource", int(initial.phaseSource)).toInt());
+    initial.phaseAxis = settings.value("VatBake/PhaseAxis", QVariant::fromValue(initial.phaseAxis)).value<QVector3D>();
+    initial.phaseScale = settings.value("VatBake/PhaseScale", initial.phaseScale).toDouble();
+    initial.format = static_cast<VatSettings::Format>(settings.value("VatBake/Format", int(initial.format)).toInt());
+
+    VatBakeDialog dialog(settings.value("VatBake/Mesh").toString(), initial, this);
+    if (dialog.exec() != QDialog::Accepted) return;
+    const VatSettings vat = dialog.settings();
+    settings.setValue("VatBake/Mesh", dialog.meshPath());
+    settings.setValue("VatBake/Duration", vat.timing.duration);
+    settings.setValue("VatBake/Fps", vat.timing.fps);
+    settings.setValue("VatBake/Loop", vat.timing.loop);
+    settings.setValue("VatBake/Amplitude", QVariant::fromValue(vat.amplitude));
+    settings.setValue("VatBake/Center", vat.center);
+    settings.setValue("VatBake/PhaseSource", int(vat.phaseSource));
+    settings.setValue("VatBake/PhaseAxis", QVariant::fromValue(vat.phaseAxis));
+    settings.setValue("VatBake/PhaseScale", vat.phaseScale);
+    settings.setValue("VatBake/Format", int(vat.format));
+
+    ObjMesh mesh;
+    QString errorMessage;
+    if (!ObjMesh::load(dialog.meshPath(), mesh, &errorMessage)) {
+        QMessageBox::critical(this, tr("Export Error"), tr("Failed to read mesh:\n%1\n%2").arg(dialog.meshPath(), errorMessage));
+        return;
+    }
 
-        QJsonArray nodesArray = channelsObj[channelStringKey].toArray();
-        QVector<CurveWidget::CurveNode> nodesVector;
-        nodesVector.reserve(nodesArray.size());
-
-        for (const QJsonValue& nodeVal : nodesArray) {
-            if (!nodeVal.isObject()) { loadOk = false; qWarning("Node data not object"); break; }
-            QJsonObject nodeObj = nodeVal.toObject();
-
-            bool pointsOk = true;
-            auto extractPoint = [&](const QString& key, QPointF& point) -> bool {
-                if (!nodeObj.contains(key) || !nodeObj[key].isArray()) return false;
-                QJsonArray arr = nodeObj[key].toArray();
-                if (arr.size() != 2 || !arr[0].isDouble() || !arr[1].isDouble()) return false;
-                point.setX(arr[0].toDouble());
-                point.setY(arr[1].toDouble());
-                return true;
-            };
-
-            QPointF pMain, pIn, pOut;
-            if (!extractPoint("main", pMain)) pointsOk = false;
-            if (!extractPoint("in", pIn)) pointsOk = false;
-            if (!extractPoint("out", pOut)) pointsOk = false;
-
-            if (!pointsOk) { loadOk = false; qWarning("Invalid point data"); break; }
-
-            if (!nodeObj.contains("align")|| !nodeObj["align"].isDouble()) {
-                loadOk = false; qWarning("Invalid alignment data type"); break;
-            }
-            int alignInt = nodeObj["align"].toInt(-1);
-            if (alignInt < static_cast<int>(CurveWidget::HandleAlignment::Free) ||
-                alignInt > static_cast<int>(CurveWidget::HandleAlignment::Mirrored)) {
-                qWarning() << "Invalid alignment value in node:" << alignInt;
-                loadOk = false; break;
-            }
-            CurveWidget::HandleAlignment alignment = static_cast<CurveWidget::HandleAlignment>(alignInt);
+    const bool half = vat.format == VatSettings::Format::Half;
+    const QString pfmFilter = tr("Float RGB (*.pfm)");
+    const QString ddsFilter = tr("DirectDraw Surface (*.dds)");
+    QString selectedFilter = half ? ddsFilter : pfmFilter;
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Save Vertex Animation Texture"), QString(),
+                                                    half ? ddsFilter : QString(pfmFilter + ";;" + ddsFilter), &selectedFilter);
+    if (filePath.isEmpty()) return;
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix != "pfm" && suffix != "dds") {
+        filePath += (half || selectedFilter == ddsFilter) ? ".dds" : ".pfm";
+    }
 
-            CurveWidget::CurveNode node(pMain);
-            node.handleIn = pIn;
-            node.handleOut = pOut;
-            node.alignment = alignment;
-            nodesVector.append(node);
-        }
+    QJsonObject report;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool saved = VatBaker::bake(mesh, m_curveWidget->getAllChannelNodes(), vat, filePath, &errorMessage, &report,
+                                BakeService::instance().pool());
+    QApplication::restoreOverrideCursor();
+    if (saved) {
+        QFile reportFile(filePath + ".vat.json");
+        saved = reportFile.open(QIODevice::WriteOnly) && reportFile.write(QJsonDocument(report).toJson()) != -1;
+        if (!saved) errorMessage = reportFile.errorString();
+    }
 
-        if (!loadOk) break;
+    if (saved) {
+        QString message = tr("%1 frames of %2 vertices saved to:\n%3").arg(report["frames"].toInt()).arg(mesh.vertexCount()).arg(filePath);
+        if (report.contains("warning")) message += "\n\n" + report["warning"].toString();
+        QMessageBox::information(this, tr("Export Successful"), message);
+    } else {
+        QMessageBox::critical(this, tr("Export Error"), tr("Failed to save vertex animation to:\n%1\n%2").arg(filePath, errorMessage));
+    }
+}
 
-        loadedChannelNodes.insert(channelKey, nodesVector);
+/**
+ * @brief Writes per-vertex sway weights of an OBJ mesh (height, pivot distance, piece
+ * random as RGB) next to the LUT export path, in the LUT's bit depth, or as vertex
+ * colors of a mesh copy.
+ */
+void MainWindow::onExportWeightsTriggered()
+{
+    QSettings settings("MyCompany", "CurveMaker");
+    const QString meshPath = QFileDialog::getOpenFileName(this, tr("Choose Mesh"), settings.value("VatBake/Mesh").toString(),
+                                                          tr("Wavefront OBJ (*.obj)"));
+    if (meshPath.isEmpty()) return;
+    settings.setValue("VatBake/Mesh", meshPath);
+
+    ObjMesh mesh;
+    QString errorMessage;
+    if (!ObjMesh::load(meshPath, mesh, &errorMessage)) {
+        QMessageBox::critical(this, tr("Export Error"), tr("Failed to read mesh:\n%1\n%2").arg(meshPath, errorMessage));
+        return;
     }
 
-    if (loadOk && loadedChannelNodes.size() == expectedChannels.size()) {
-        qDebug() << "JSON parsing successful, applying state.";
+    const int bitDepth = ui->exportBitDepthComboBox->currentData().toInt();
+    const QString lutPath = ui->filePathLineEdit->text();
+    const QString imageFilter = (bitDepth == 32) ? tr("Float RGB (*.pfm)") : tr("PNG (*.png)");
+    const QString objFilter = tr("Mesh with vertex colors (*.obj)");
+    const QString filePath = QFileDialog::getSaveFileName(this, tr("Save Vertex Weights"),
+                                                          VertexWeights::weightsPath(lutPath.isEmpty() ? meshPath : lutPath, bitDepth),
+                                                          imageFilter + ";;" + objFilter);
+    if (filePath.isEmpty()) return;
+
+    int pieces = 0;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const QVector<float> rgb = VertexWeights::compute(mesh, VertexWeightSettings(), BakeService::instance().pool(), &pieces);
+    const bool saved = VertexWeights::write(filePath, mesh, rgb, bitDepth, &errorMessage);
+    QApplication::restoreOverrideCursor();
+
+    if (saved) {
+        QMessageBox::information(this, tr("Export Successful"),
+                                 tr("Weights of %1 vertices in %2 pieces saved to:\n%3").arg(mesh.vertexCount()).arg(pieces).arg(filePath));
+    } else {
+        QMessageBox::critical(this, tr("Export Error"), tr("Failed to save vertex weights to:\n%1\n%2").arg(filePath, errorMessage));
+    }
+}
 
-        ui->curveWidget->setAllChannelNodes(loadedChannelNodes);
+/**
+ * @brief Replaces the curves with equalization or auto-levels curves computed from an
+ * image's histograms, as one undoable edit.
+ */
+void MainWindow::onAutoCurvesTriggered()
+{
+    if (!m_curveWidget) return;
 
-        bool foundWidth = false;
-        for(int i=0; i<ui->lutSizeComboBox->count(); ++i){
-            if(ui->lutSizeComboBox->itemData(i).toInt() == loadedLutWidth){
-                ui->lutSizeComboBox->setCurrentIndex(i);
-                foundWidth = true; break;
-            }
-        }
-        if (!foundWidth) {
-            qWarning() << "Loaded LUT Width" << loadedLutWidth << "not found in ComboBox list.";
-            ui->lutSizeComboBox->setCurrentText(QString::number(loadedLutWidth));
-        }
+    QSettings settings("MyCompany", "CurveMaker");
+    const QString imagePath = QFileDialog::getOpenFileName(this, tr("Choose Image"), settings.value("AutoCurves/Image").toString(),
+                                                           tr("Images (*.png *.jpg *.jpeg *.bmp *.tif *.tiff)"));
+    if (imagePath.isEmpty()) return;
+    settings.setValue("AutoCurves/Image", imagePath);
 
-        bool foundDepth = false;
-        for(int i=0; i<ui->exportBitDepthComboBox->count(); ++i){
-            if(ui->exportBitDepthComboBox->itemData(i).toInt() == loadedBitDepth){
-                ui->exportBitDepthComboBox->setCurrentIndex(i);
-                foundDepth = true; break;
-            }
-        }
-        if (!foundDepth) {
-            qWarning() << "Loaded Export Bit Depth" << loadedBitDepth << "not found in ComboBox list.";
-            ui->exportBitDepthComboBox->setCurrentIndex(0);
+    const QStringList modes = {
+        tr("Equalize per channel"), tr("Equalize luminance"), tr("Auto levels per channel"), tr("Auto levels luminance")
+    };
+    bool accepted = false;
+    const QString mode = QInputDialog::getItem(this, tr("Auto Curves"), tr("Curves:"), modes,
+                                               settings.value("AutoCurves/Mode", 0).toInt(), false, &accepted);
+    if (!accepted) return;
+    const int modeIndex = modes.indexOf(mode);
+    settings.setValue("AutoCurves/Mode", modeIndex);
+
+    AutoCurveSettings autoSettings;
+    autoSettings.mode = (modeIndex >= 2) ? AutoCurveSettings::Mode::Levels : AutoCurveSettings::Mode::Equalize;
+    autoSettings.linked = (modeIndex % 2) == 1;
+    startImageCurvesJob(tr("Auto Curves"), [imagePath, autoSettings]() {
+        ImageCurves result;
+        const QImage image(imagePath);
+        if (image.isNull()) {
+            result.error = tr("Failed to read image:\n%1").arg(imagePath);
+            return result;
         }
+        qreal maxError = 0.0;
+        result.curves = AutoCurves::generate(AutoCurves::histogram(image, 256), autoSettings, &maxError);
+        result.message = tr("Auto curves from %1 (fit error %2)").arg(QFileInfo(imagePath).fileName()).arg(maxError, 0, 'g', 3);
+        return result;
+    });
+}
 
-        ui->clampHandlesCheckbox->setChecked(loadedClampHandles);
-        ui->actionInactiveChannels->setChecked(loadedDrawInactive);
-        ui->actionPreviewRgb->setChecked(loadedPreviewRgb);
+/**
+ * @brief Replaces the curves with the color transfer that gives a source image the
+ * per-channel (or luminance) distribution of a reference image, as one undoable edit.
+ */
+void MainWindow::onMatchColorsTriggered()
+{
+    if (!m_curveWidget) return;
 
-        QMessageBox::information(this, tr("Load Successful"), tr("Curves and settings loaded from:\n%1").arg(fileName));
+    QSettings settings("MyCompany", "CurveMaker");
+    const QString filter = tr("Images (*.png *.jpg *.jpeg *.bmp *.tif *.tiff)");
+    const QString sourcePath = QFileDialog::getOpenFileName(this, tr("Choose Source Image"),
+                                                            settings.value("MatchColors/Source").toString(), filter);
+    if (sourcePath.isEmpty()) return;
+    const QString referencePath = QFileDialog::getOpenFileName(this, tr("Choose Reference Image"),
+                                                               settings.value("MatchColors/Reference", sourcePath).toString(), filter);
+    if (referencePath.isEmpty()) return;
+    settings.setValue("MatchColors/Source", sourcePath);
+    settings.setValue("MatchColors/Reference", referencePath);
+
+    const QStringList modes = { tr("Per channel"), tr("Luminance only (keeps hues)") };
+    bool accepted = false;
+    const QString mode = QInputDialog::getItem(this, tr("Match Image Colors"), tr("Match:"), modes,
+                                               settings.value("MatchColors/Mode", 0).toInt(), false, &accepted);
+    if (!accepted) return;
+    settings.setValue("MatchColors/Mode", modes.indexOf(mode));
+
+    AutoCurveSettings matchSettings;
+    matchSettings.linked = modes.indexOf(mode) == 1;
+    startImageCurvesJob(tr("Match Image Colors"), [sourcePath, referencePath, matchSettings]() {
+        QElapsedTimer timer;
+        timer.start();
+        ImageCurves result;
+        const QImage source(sourcePath);
+        const QImage reference = source.isNull() ? QImage() : QImage(referencePath);
+        if (source.isNull() || reference.isNull()) {
+            result.error = tr("Failed to read image:\n%1").arg(source.isNull() ? sourcePath : referencePath);
+            return result;
+        }
+        qreal maxError = 0.0;
+        result.curves = AutoCurves::matchHistograms(AutoCurves::histogram(source, AutoCurves::matchBins(source)),
+                                                    AutoCurves::histogram(reference, AutoCurves::matchBins(reference)),
+                                                    matchSettings, &maxError);
+        result.message = tr("Matched %1 to %2 in %3 ms (fit error %4)")
+                             .arg(QFileInfo(sourcePath).fileName(), QFileInfo(referencePath).fileName())
+                             .arg(timer.elapsed()).arg(maxError, 0, 'g', 3);
+        return result;
+    });
+}
 
-    } else {
-        QMessageBox::critical(this, tr("Load Error"), tr("Failed to load curves/settings due to file format error or missing data in:\n%1").arg(fileName));
+/**
+ * @brief Runs job (image decoding, histograms and fitting) as one task on the bake
+ * pool and applies its curves to the document that was active when it started, as
+ * one undoable edit titled title. The GUI thread never waits for it. One job runs at
+ * a time; the job bins without a pool, since it already runs on one.
+ */
+void MainWindow::startImageCurvesJob(const QString& title, const std::function<ImageCurves()>& job)
+{
+    if (!m_imageCurvesIdle.tryAcquire()) {
+        statusBar()->showMessage(tr("Still reading the previous image..."), 3000);
+        return;
     }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const QPointer<CurveWidget> target = m_curveWidget;
+    BakeService::instance().pool()->start([this, title, job, target]() {
+        const ImageCurves result = job();
+        QMetaObject::invokeMethod(this, [this, title, target, result]() {
+            QApplication::restoreOverrideCursor();
+            if (!result.error.isEmpty()) {
+                QMessageBox::critical(this, title, result.error);
+            } else if (!target) {
+                statusBar()->showMessage(tr("%1: the document was closed").arg(title), 5000);
+            } else if (target->replaceChannelNodes(result.curves, title)) {
+                statusBar()->showMessage(result.message, 5000);
+            }
+        }, Qt::QueuedConnection);
+        m_imageCurvesIdle.release();
+    });
 }
@@ -4,16 +4,32 @@
 // Qt Includes
 #include <QMainWindow>
 #include <QImage>
+#include <QList>
+#include <QMetaObject>
+#include <QPointer>
+#include <QSemaphore>
+#include <QString>
+#include <QVector>
+
+// Standard Library Includes
+#include <functional>
 
 // Project Includes
 #include "curvewidget.h" // Requires CurveWidget::ActiveChannel
+#include "luterroranalyzer.h" // Requires LutErrorAnalysis for the analysisReady slot
 
 // Forward Declarations
 namespace Ui {
 class MainWindow;
 }
 class QButtonGroup;
+class QLabel;
 class QAbstractButton;
+class QAction;
+class CurveLibraryDock;
+class QStackedWidget;
+class QTabBar;
+class QUndoGroup;
 
 class MainWindow : public QMainWindow
 {
@@ -23,6 +39,14 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    CurveWidget* curveWidget() const;
+
+signals:
+    /**
+     * @brief Emitted after each LUT preview refresh with the time it took.
+     */
+    void previewBaked(qint64 nsecs);
+
 private slots:
     void on_browseButton_clicked();
     void on_exportButton_clicked();
@@ -33,6 +57,7 @@ private slots:
     void on_alignedBtn_clicked();
     void on_mirroredBtn_clicked();
     void updateLUTPreview();
+    void onCurveEdited(const QVector<CurveWidget::CurveChange>& changes);
     void onCurveSelectionChanged();
     void onChannelButtonClicked(QAbstractButton *button);
     void on_actionPreviewRgb_toggled(bool checked);
@@ -40,19 +65,78 @@ private slots:
     void on_clampHandlesCheckbox_stateChanged(int state);
     void onSaveCurvesActionTriggered();
     void onLoadCurvesActionTriggered();
+    void onPreviewQuantizationErrorToggled(bool checked);
+    void requestErrorAnalysis();
+    void onErrorAnalysisReady(const LutErrorAnalysis& analysis);
+    void onTransformSelectionTriggered();
+    void onExportEventsTriggered();
+    void onBakeFramesTriggered();
+    void onExportVariantsTriggered();
+    void onBakeVatTriggered();
+    void onExportWeightsTriggered();
+    void onAutoCurvesTriggered();
+    void onMatchColorsTriggered();
+    void onNewDocumentTriggered();
+    void closeDocument(int index);
+    void onDocumentTabChanged(int index);
+    bool loadProjectFile(const QString& fileName);
 
 private:
+    /**
+     * @brief One open curve project. The widget owns the curves and the undo stack.
+     */
+    struct Document {
+        CurveWidget *widget = nullptr;
+        QString filePath;
+    };
+
+    /**
+     * @brief Outcome of an image-driven curve job: the curves and a status message,
+     * or an error.
+     */
+    struct ImageCurves {
+        CurveSampler::ChannelMap curves;
+        QString message;
+        QString error;
+    };
+
     // Helper Functions
+    void setupDocumentArea();
+    int addDocument(CurveWidget *widget);
+    void bindDocument(CurveWidget *widget);
+    QString documentName(int index) const;
+    void updateDocumentTitle(int index);
     void applyTheme(bool dark);
     QImage generateLutImage3D(int size);
     QImage generateCombinedRgbLut1D(int width, int bitDepth = 8);
-    QImage generateSingleChannelLut1D(CurveWidget::ActiveChannel channel, int width);
+    void fillPreviewTexels(uchar *texels, const QVector<float>& rgb, int width, bool combined) const;
+    void updateBoundsLabel();
+    bool exportFloatLut(const QString& filePath, int width);
+    void startImageCurvesJob(const QString& title, const std::function<ImageCurves()>& job);
 
     // Member Variables
     Ui::MainWindow *ui;
     int m_selectedNodeIndex;
     QButtonGroup *m_channelGroup;
     bool m_isPreviewRgbCombined;
+    QAction *m_previewErrorAction;
+    QAction *m_transformSelectionAction;
+    QAction *m_linkChannelsAction;
+    LutErrorAnalyzer *m_errorAnalyzer;
+    CurveWidget *m_curveWidget;
+    QTabBar *m_documentTabs;
+    QStackedWidget *m_documentStack;
+    QUndoGroup *m_undoGroup;
+    CurveLibraryDock *m_libraryDock;
+    QLabel *m_boundsLabel;
+    QVector<Document> m_documents;
+    QList<QMetaObject::Connection> m_documentConnections;
+    QVector<float> m_previewRow;             // Baked RGB row shown in the previews.
+    QPointer<CurveWidget> m_previewRowWidget; // Document and revision m_previewRow was baked from.
+    quint64 m_previewRowRevision;
+    int m_gradientPreviewHeight;
+    int m_lutFrameMaxHeight;
+    QSemaphore m_imageCurvesIdle;  // Held by the running image-curves job, if any.
 };
 
 #endif
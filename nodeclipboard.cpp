@@ -0,0 +1,110 @@
+#include "nodeclipboard.h"
+
+#include <QClipboard>
+#include <QDataStream>
+#include <QDebug>
+#include <QGuiApplication>
+#include <QIODevice>
+#include <QMimeData>
+
+namespace {
+const quint32 NODE_CLIPBOARD_MAGIC = 0x434D4E44; // "CMND"
+const quint16 NODE_CLIPBOARD_VERSION = 1;
+const quint32 NODE_CLIPBOARD_MAX_NODES = 1u << 20;
+}
+
+const QString NodeClipboard::MimeType = QStringLiteral("application/x-curvemaker-nodes");
+
+/**
+ * @brief Serializes nodes into the clipboard's binary format.
+ */
+QByteArray NodeClipboard::encode(const QVector<CurveWidget::CurveNode>& nodes)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << NODE_CLIPBOARD_MAGIC << NODE_CLIPBOARD_VERSION << static_cast<quint32>(nodes.size());
+    for (const CurveWidget::CurveNode& node : nodes) {
+        stream << node.mainPoint.x() << node.mainPoint.y()
+               << node.handleIn.x() << node.handleIn.y()
+               << node.handleOut.x() << node.handleOut.y()
+               << static_cast<quint8>(node.alignment);
+    }
+    return data;
+}
+
+/**
+ * @brief Parses the clipboard's binary format. Nodes come back without ids.
+ * @return false if the data is not a node list this version understands.
+ */
+bool NodeClipboard::decode(const QByteArray& data, QVector<CurveWidget::CurveNode>& nodes)
+{
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0, count = 0;
+    quint16 version = 0;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != NODE_CLIPBOARD_MAGIC) return false;
+    if (version > NODE_CLIPBOARD_VERSION) {
+        qWarning() << "Clipboard nodes use a newer format version:" << version;
+        return false;
+    }
+    if (count > NODE_CLIPBOARD_MAX_NODES) return false;
+
+    QVector<CurveWidget::CurveNode> result;
+    result.reserve(count);
+    for (quint32 i = 0; i < count; ++i) {
+        double mx, my, ix, iy, ox, oy;
+        quint8 alignment;
+        stream >> mx >> my >> ix >> iy >> ox >> oy >> alignment;
+        if (stream.status() != QDataStream::Ok) return false;
+
+        CurveWidget::CurveNode node(QPointF(mx, my));
+        node.handleIn = QPointF(ix, iy);
+        node.handleOut = QPointF(ox, oy);
+        node.alignment = (alignment <= static_cast<quint8>(CurveWidget::HandleAlignment::Mirrored))
+                             ? static_cast<CurveWidget::HandleAlignment>(alignment)
+                             : CurveWidget::HandleAlignment::Free;
+        result.append(node);
+    }
+    nodes = result;
+    return true;
+}
+
+QMimeData* NodeClipboard::createMimeData(const QVector<CurveWidget::CurveNode>& nodes)
+{
+    QMimeData *mimeData = new QMimeData;
+    mimeData->setData(MimeType, encode(nodes));
+    return mimeData;
+}
+
+bool NodeClipboard::readMimeData(const QMimeData *mimeData, QVector<CurveWidget::CurveNode>& nodes)
+{
+    if (!mimeData || !mimeData->hasFormat(MimeType)) return false;
+    return decode(mimeData->data(MimeType), nodes);
+}
+
+/**
+ * @brief Puts nodes on the system clipboard.
+ */
+void NodeClipboard::copy(const QVector<CurveWidget::CurveNode>& nodes)
+{
+    QGuiApplication::clipboard()->setMimeData(createMimeData(nodes));
+}
+
+/**
+ * @brief Reads nodes from the system clipboard.
+ * @return false if the clipboard holds no nodes.
+ */
+bool NodeClipboard::paste(QVector<CurveWidget::CurveNode>& nodes)
+{
+    return readMimeData(QGuiApplication::clipboard()->mimeData(), nodes);
+}
+
+bool NodeClipboard::hasNodes()
+{
+    const QMimeData *mimeData = QGuiApplication::clipboard()->mimeData();
+    return mimeData && mimeData->hasFormat(MimeType);
+}
@@ -0,0 +1,38 @@
+#ifndef NODECLIPBOARD_H
+#define NODECLIPBOARD_H
+
+// Qt Includes
+#include <QVector>
+#include <QByteArray>
+
+// Project Includes
+#include "curvewidget.h" // Required for CurveWidget::CurveNode
+
+// Forward Declarations
+class QMimeData;
+
+/**
+ * @brief Moves runs of curve nodes through the system clipboard, so they can be
+ * pasted into another channel, another project or another CurveMaker instance.
+ *
+ * Nodes are stored in a small binary format under their own MIME type:
+ * magic, format version, node count, then per node the main point, both
+ * handles (as doubles) and the alignment. Node ids are not stored.
+ */
+class NodeClipboard
+{
+public:
+    static const QString MimeType;
+
+    static QByteArray encode(const QVector<CurveWidget::CurveNode>& nodes);
+    static bool decode(const QByteArray& data, QVector<CurveWidget::CurveNode>& nodes);
+
+    static QMimeData* createMimeData(const QVector<CurveWidget::CurveNode>& nodes);
+    static bool readMimeData(const QMimeData *mimeData, QVector<CurveWidget::CurveNode>& nodes);
+
+    static void copy(const QVector<CurveWidget::CurveNode>& nodes);
+    static bool paste(QVector<CurveWidget::CurveNode>& nodes);
+    static bool hasNodes();
+};
+
+#endif
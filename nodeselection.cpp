@@ -0,0 +1,165 @@
+#include "nodeselection.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+
+namespace {
+
+constexpr int kWordBits = 64;
+
+inline quint64 bitMask(int index) {
+    return quint64(1) << (index % kWordBits);
+}
+
+}
+
+NodeSelection::NodeSelection()
+    : m_count(0),
+    m_sortedValid(true)
+{
+}
+
+bool NodeSelection::contains(int index) const
+{
+    if (index < 0) return false;
+    const int word = index / kWordBits;
+    return word < m_words.size() && (m_words[word] & bitMask(index));
+}
+
+/**
+ * @brief Lowest selected index, or -1 if nothing is selected.
+ */
+int NodeSelection::first() const
+{
+    for (int word = 0; word < m_words.size(); ++word) {
+        if (m_words[word]) {
+            return word * kWordBits + qCountTrailingZeroBits(m_words[word]);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Selected indices in ascending order. The reference stays valid until the next change.
+ */
+const QVector<int>& NodeSelection::indices() const
+{
+    if (!m_sortedValid) {
+        m_sortedIndices.clear();
+        m_sortedIndices.reserve(m_count);
+        for (int word = 0; word < m_words.size(); ++word) {
+            quint64 bits = m_words[word];
+            while (bits) {
+                m_sortedIndices.append(word * kWordBits + qCountTrailingZeroBits(bits));
+                bits &= bits - 1;
+            }
+        }
+        m_sortedValid = true;
+    }
+    return m_sortedIndices;
+}
+
+void NodeSelection::insert(int index)
+{
+    if (index < 0 || contains(index)) return;
+    ensureCapacity(index);
+    m_words[index / kWordBits] |= bitMask(index);
+    ++m_count;
+    m_sortedValid = false;
+}
+
+void NodeSelection::remove(int index)
+{
+    if (!contains(index)) return;
+    m_words[index / kWordBits] &= ~bitMask(index);
+    --m_count;
+    m_sortedValid = false;
+}
+
+void NodeSelection::toggle(int index)
+{
+    if (contains(index)) remove(index); else insert(index);
+}
+
+void NodeSelection::clear()
+{
+    if (m_count == 0 && m_words.isEmpty()) return;
+    m_words.clear();
+    m_count = 0;
+    m_sortedIndices.clear();
+    m_sortedValid = true;
+}
+
+/**
+ * @brief Adds every index in [first, last] (inclusive) to the selection.
+ */
+void NodeSelection::selectRange(int first, int last)
+{
+    if (first > last) std::swap(first, last);
+    first = std::max(0, first);
+    if (last < 0) return;
+    ensureCapacity(last);
+
+    int index = first;
+    while (index <= last) {
+        const int word = index / kWordBits;
+        const int bit = index % kWordBits;
+        const int span = std::min(kWordBits - bit, last - index + 1);
+        const quint64 mask = (span == kWordBits) ? ~quint64(0) : (((quint64(1) << span) - 1) << bit);
+        m_words[word] |= mask;
+        index += span;
+    }
+    recount();
+}
+
+/**
+ * @brief Flips the selection state of every index in [0, nodeCount).
+ */
+void NodeSelection::invert(int nodeCount)
+{
+    if (nodeCount <= 0) { clear(); return; }
+    ensureCapacity(nodeCount - 1);
+    truncate(nodeCount);
+    for (quint64& word : m_words) word = ~word;
+    truncate(nodeCount);
+}
+
+/**
+ * @brief Drops selected indices >= nodeCount (e.g. after nodes were removed).
+ */
+void NodeSelection::truncate(int nodeCount)
+{
+    nodeCount = std::max(0, nodeCount);
+    const int words = (nodeCount + kWordBits - 1) / kWordBits;
+    if (m_words.size() > words) m_words.resize(words);
+    if (!m_words.isEmpty() && nodeCount % kWordBits) {
+        m_words.last() &= (quint64(1) << (nodeCount % kWordBits)) - 1;
+    }
+    recount();
+}
+
+bool NodeSelection::operator==(const NodeSelection& other) const
+{
+    if (m_count != other.m_count) return false;
+    const int common = std::min(m_words.size(), other.m_words.size());
+    for (int word = 0; word < common; ++word) {
+        if (m_words[word] != other.m_words[word]) return false;
+    }
+    // Equal counts and equal common words imply any extra words are zero.
+    return true;
+}
+
+void NodeSelection::ensureCapacity(int index)
+{
+    const int words = index / kWordBits + 1;
+    if (m_words.size() < words) m_words.resize(words, 0);
+}
+
+void NodeSelection::recount()
+{
+    int count = 0;
+    for (quint64 word : std::as_const(m_words)) count += qPopulationCount(word);
+    m_count = count;
+    m_sortedValid = false;
+}
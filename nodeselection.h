@@ -0,0 +1,47 @@
+#ifndef NODESELECTION_H
+#define NODESELECTION_H
+
+// Qt Includes
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief Dense bitset of selected node indices.
+ *
+ * Membership tests and updates are O(1) and range operations work a 64-bit word
+ * at a time. The ascending index list is built lazily and cached until the next
+ * change, so callers can iterate in node order without copying the selection.
+ */
+class NodeSelection
+{
+public:
+    NodeSelection();
+
+    bool isEmpty() const { return m_count == 0; }
+    int size() const { return m_count; }
+    bool contains(int index) const;
+    int first() const;
+    const QVector<int>& indices() const;
+
+    void insert(int index);
+    void remove(int index);
+    void toggle(int index);
+    void clear();
+    void selectRange(int first, int last);
+    void invert(int nodeCount);
+    void truncate(int nodeCount);
+
+    bool operator==(const NodeSelection& other) const;
+    bool operator!=(const NodeSelection& other) const { return !(*this == other); }
+
+private:
+    void ensureCapacity(int index);
+    void recount();
+
+    QVector<quint64> m_words;
+    int m_count;
+    mutable QVector<int> m_sortedIndices;
+    mutable bool m_sortedValid;
+};
+
+#endif
@@ -0,0 +1,189 @@
+#include "objmesh.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <numeric>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+bool isVertexLine(const QByteArray& line)
+{
+    return line.startsWith("v ") || line.startsWith("v\t");
+}
+
+/**
+ * @brief Root of i, halving the path on the way up.
+ */
+int findRoot(QVector<int>& parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+}
+
+/**
+ * @brief Reads the vertices and faces of an OBJ file line by line. Vertex colors are
+ * kept only if every vertex has them. Face corners may be `v`, `v/vt`, `v//vn` or
+ * `v/vt/vn`, with negative indices counting back from the last vertex so far.
+ * @return false if the file can't be read, a `v` or `f` line is malformed or there are no vertices.
+ */
+bool ObjMesh::load(const QString& filePath, ObjMesh& mesh, QString *errorMessage)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+
+    ObjMesh loaded;
+    loaded.m_filePath = filePath;
+    bool allColored = true;
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        ++lineNumber;
+        if (line.startsWith("f ") || line.startsWith("f\t")) {
+            const QList<QByteArray> corners = line.simplified().split(' ');
+            const int start = loaded.m_faceVertices.size();
+            for (int i = 1; i < corners.size(); ++i) {
+                // Only the part before the first '/' is the vertex index; plain `v` has none.
+                const int slash = corners[i].indexOf('/');
+                bool ok = false;
+                int index = (slash >= 0 ? corners[i].left(slash) : corners[i]).toInt(&ok);
+                index = (index < 0) ? loaded.m_positions.size() + index : index - 1;
+                if (!ok || index < 0 || index >= loaded.m_positions.size()) {
+                    if (errorMessage) *errorMessage = QString("Line %1: bad face vertex '%2'").arg(lineNumber).arg(QString::fromUtf8(corners[i]));
+                    return false;
+                }
+                loaded.m_faceVertices.append(index);
+            }
+            loaded.m_faceStarts.append(start);
+            continue;
+        }
+        if (!isVertexLine(line)) continue;
+
+        const QList<QByteArray> fields = line.simplified().split(' ');
+        if (fields.size() < 4) {
+            if (errorMessage) *errorMessage = QString("Line %1: vertex needs x y z").arg(lineNumber);
+            return false;
+        }
+        float values[6] = { 0, 0, 0, 0, 0, 0 };
+        const int count = std::min(static_cast<int>(fields.size()) - 1, 6);
+        for (int i = 0; i < count; ++i) {
+            bool ok = false;
+            values[i] = fields[i + 1].toFloat(&ok);
+            if (!ok) {
+                if (errorMessage) *errorMessage = QString("Line %1: '%2' is not a number").arg(lineNumber).arg(QString::fromUtf8(fields[i + 1]));
+                return false;
+            }
+        }
+        loaded.m_positions.append(QVector3D(values[0], values[1], values[2]));
+        if (count >= 6) {
+            loaded.m_colors.append(QVector3D(values[3], values[4], values[5]));
+        } else {
+            allColored = false;
+        }
+    }
+
+    if (loaded.m_positions.isEmpty()) {
+        if (errorMessage) *errorMessage = QStringLiteral("No vertices found");
+        return false;
+    }
+    if (!allColored) loaded.m_colors.clear();
+
+    loaded.m_boundsMin = loaded.m_boundsMax = loaded.m_positions.first();
+    for (const QVector3D& p : std::as_const(loaded.m_positions)) {
+        loaded.m_boundsMin = QVector3D(std::min(loaded.m_boundsMin.x(), p.x()), std::min(loaded.m_boundsMin.y(), p.y()),
+                                       std::min(loaded.m_boundsMin.z(), p.z()));
+        loaded.m_boundsMax = QVector3D(std::max(loaded.m_boundsMax.x(), p.x()), std::max(loaded.m_boundsMax.y(), p.y()),
+                                       std::max(loaded.m_boundsMax.z(), p.z()));
+    }
+
+    mesh = loaded;
+    return true;
+}
+
+/**
+ * @brief Copies the OBJ at sourcePath to filePath with every `v` line rewritten as
+ * `v x y z r g b`. Positions keep their original text; all other lines are untouched.
+ */
+bool ObjMesh::writeWithColors(const QString& sourcePath, const QString& filePath, const QVector<QVector3D>& colors,
+                              QString *errorMessage)
+{
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = source.errorString();
+        return false;
+    }
+    QByteArray out;
+    int vertex = 0;
+    while (!source.atEnd()) {
+        const QByteArray line = source.readLine();
+        const QByteArray trimmed = line.trimmed();
+        if (!isVertexLine(trimmed)) {
+            out.append(line);
+            continue;
+        }
+        if (vertex >= colors.size()) {
+            if (errorMessage) *errorMessage = QStringLiteral("The mesh has more vertices than colors");
+            return false;
+        }
+        const QList<QByteArray> fields = trimmed.simplified().split(' ');
+        const QVector3D& color = colors[vertex++];
+        out.append("v " + fields.mid(1, 3).join(' ') + ' ' + QByteArray::number(color.x(), 'g', 6) + ' '
+                   + QByteArray::number(color.y(), 'g', 6) + ' ' + QByteArray::number(color.z(), 'g', 6) + '\n');
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Labels every vertex with the index of the connected piece it belongs to
+ * (vertices sharing a face are connected), numbered in order of first vertex.
+ * Unreferenced vertices are pieces of their own.
+ * @return The number of pieces.
+ */
+int ObjMesh::connectedComponents(QVector<int>& labels) const
+{
+    const int vertices = m_positions.size();
+    QVector<int> parent(vertices);
+    QVector<int> size(vertices, 1);
+    std::iota(parent.begin(), parent.end(), 0);
+
+    for (int f = 0; f < m_faceStarts.size(); ++f) {
+        const int begin = m_faceStarts[f];
+        const int end = (f + 1 < m_faceStarts.size()) ? m_faceStarts[f + 1] : m_faceVertices.size();
+        for (int i = begin + 1; i < end; ++i) {
+            int a = findRoot(parent, m_faceVertices[begin]);
+            int b = findRoot(parent, m_faceVertices[i]);
+            if (a == b) continue;
+            if (size[a] < size[b]) std::swap(a, b);
+            parent[b] = a;
+            size[a] += size[b];
+        }
+    }
+
+    labels.fill(-1, vertices);
+    QVector<int> rootLabel(vertices, -1);
+    int count = 0;
+    for (int v = 0; v < vertices; ++v) {
+        const int root = findRoot(parent, v);
+        if (rootLabel[root] < 0) rootLabel[root] = count++;
+        labels[v] = rootLabel[root];
+    }
+    return count;
+}
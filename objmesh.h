@@ -0,0 +1,48 @@
+#ifndef OBJMESH_H
+#define OBJMESH_H
+
+// Qt Includes
+#include <QString>
+#include <QVector>
+#include <QVector3D>
+
+/**
+ * @brief The vertices of a Wavefront OBJ mesh, as needed for per-vertex bakes.
+ *
+ * `v` lines give positions plus the optional `v x y z r g b` vertex color extension;
+ * `f` lines are kept as vertex index lists so connected pieces can be found. Normals
+ * and texture coordinates are skipped, since the bakes work per vertex in file order
+ * (the order the engine's importer keeps).
+ */
+class ObjMesh
+{
+public:
+    static bool load(const QString& filePath, ObjMesh& mesh, QString *errorMessage = nullptr);
+    static bool writeWithColors(const QString& sourcePath, const QString& filePath, const QVector<QVector3D>& colors,
+                                QString *errorMessage = nullptr);
+
+    int connectedComponents(QVector<int>& labels) const;
+
+    int vertexCount() const { return m_positions.size(); }
+    bool hasColors() const { return m_colors.size() == m_positions.size() && !m_positions.isEmpty(); }
+    const QVector<QVector3D>& positions() const { return m_positions; }
+    const QVector<QVector3D>& colors() const { return m_colors; }
+    QVector3D boundsMin() const { return m_boundsMin; }
+    QVector3D boundsMax() const { return m_boundsMax; }
+    QString filePath() const { return m_filePath; }
+
+    int faceCount() const { return m_faceStarts.size(); }
+    const QVector<int>& faceVertices() const { return m_faceVertices; }
+    const QVector<int>& faceStarts() const { return m_faceStarts; }
+
+private:
+    QString m_filePath;
+    QVector<QVector3D> m_positions;
+    QVector<QVector3D> m_colors;
+    QVector<int> m_faceVertices;    // Zero based vertex indices of all faces, back to back.
+    QVector<int> m_faceStarts;      // Offset of each face in m_faceVertices.
+    QVector3D m_boundsMin;
+    QVector3D m_boundsMax;
+};
+
+#endif
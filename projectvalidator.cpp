@@ -0,0 +1,256 @@
+#include "projectvalidator.h"
+#include "bakeservice.h"
+#include "curvesampler.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QJsonArray>
+
+#include <algorithm>
+#include <cmath>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+const int CONVERGENCE_PROBES = 64;
+const qreal CONVERGENCE_TOLERANCE = 1e-5;
+
+bool isFinite(const QPointF& p)
+{
+    return std::isfinite(p.x()) && std::isfinite(p.y());
+}
+
+bool inUnitSquare(const QPointF& p)
+{
+    const qreal eps = 1e-9;
+    return p.x() >= -eps && p.x() <= 1.0 + eps && p.y() >= -eps && p.y() <= 1.0 + eps;
+}
+
+/**
+ * @brief true if x(t) of the segment decreases somewhere in [0, 1]. x'(t) / 3 is the
+ * Bernstein quadratic a(1-t)^2 + 2b t(1-t) + c t^2 of the control point x steps; with
+ * a, c >= 0 it stays non-negative exactly when b >= -sqrt(a c).
+ */
+bool isFolded(const CurveWidget::CurveNode& n0, const CurveWidget::CurveNode& n1)
+{
+    const qreal a = n0.handleOut.x() - n0.mainPoint.x();
+    const qreal b = n1.handleIn.x() - n0.handleOut.x();
+    const qreal c = n1.mainPoint.x() - n1.handleIn.x();
+    const qreal eps = 1e-12;
+    if (a < -eps || c < -eps) return true;
+    return b < -std::sqrt(std::max(0.0, a) * std::max(0.0, c)) - eps;
+}
+
+}
+
+QJsonObject ProjectIssue::toJson() const
+{
+    QJsonObject obj;
+    obj["severity"] = (severity == Severity::Error) ? "error" : "warning";
+    obj["code"] = code;
+    if (!channel.isEmpty()) obj["channel"] = channel;
+    if (node >= 0) obj["node"] = node;
+    obj["message"] = message;
+    return obj;
+}
+
+int ProjectReport::count(ProjectIssue::Severity severity) const
+{
+    return std::count_if(issues.cbegin(), issues.cend(),
+                         [severity](const ProjectIssue& issue) { return issue.severity == severity; });
+}
+
+QJsonObject ProjectReport::toJson() const
+{
+    QJsonObject obj;
+    obj["path"] = filePath;
+    obj["readable"] = readable;
+    if (!formatVersion.isEmpty()) obj["format_version"] = formatVersion;
+    obj["migrated"] = migrated;
+    QJsonArray issueArray;
+    for (const ProjectIssue& issue : issues) issueArray.append(issue.toJson());
+    obj["issues"] = issueArray;
+    return obj;
+}
+
+/**
+ * @brief Runs the structural checks on already loaded channels.
+ */
+QVector<ProjectIssue> ProjectValidator::validateChannels(const CurveProject::ChannelMap& channels)
+{
+    QVector<ProjectIssue> issues;
+    auto add = [&issues](ProjectIssue::Severity severity, const QString& code, const QString& channel,
+                         int node, const QString& message) {
+        issues.append({severity, code, channel, node, message});
+    };
+    const ProjectIssue::Severity Error = ProjectIssue::Severity::Error;
+    const ProjectIssue::Severity Warning = ProjectIssue::Severity::Warning;
+
+    for (auto it = channels.constBegin(); it != channels.constEnd(); ++it) {
+        const QString channel = CurveProject::channelName(it.key());
+        const QVector<CurveWidget::CurveNode>& nodes = it.value();
+
+        if (nodes.size() < 2) {
+            add(Error, "too_few_nodes", channel, -1, QString("Channel has %1 node(s), at least 2 are needed").arg(nodes.size()));
+            continue;
+        }
+
+        bool finite = true;
+        for (int i = 0; i < nodes.size(); ++i) {
+            const CurveWidget::CurveNode& node = nodes[i];
+            if (!isFinite(node.mainPoint) || !isFinite(node.handleIn) || !isFinite(node.handleOut)) {
+                add(Error, "non_finite", channel, i, "Node has a NaN or infinite coordinate");
+                finite = false;
+                continue;
+            }
+            if (!inUnitSquare(node.mainPoint)) {
+                add(Error, "point_out_of_range", channel, i, "Main point lies outside [0, 1] x [0, 1]");
+            }
+            if (!inUnitSquare(node.handleIn) || !inUnitSquare(node.handleOut)) {
+                add(Warning, "handle_out_of_range", channel, i, "Handle lies outside [0, 1] x [0, 1]");
+            }
+            if (i > 0) {
+                const qreal dx = node.mainPoint.x() - nodes[i - 1].mainPoint.x();
+                if (dx < 0.0) {
+                    add(Error, "unsorted_x", channel, i, QString("Node x %1 is left of the previous node").arg(node.mainPoint.x()));
+                } else if (dx <= 1e-9) {
+                    add(Warning, "duplicate_x", channel, i, "Node has the same x as the previous node");
+                }
+            }
+        }
+        if (!finite) continue;
+
+        if (std::abs(nodes.first().mainPoint.x()) > 1e-9 || std::abs(nodes.last().mainPoint.x() - 1.0) > 1e-9) {
+            add(Warning, "endpoints_not_at_bounds", channel, -1, "Curve does not start at x = 0 and end at x = 1");
+        }
+
+        for (int i = 0; i + 1 < nodes.size(); ++i) {
+            const CurveWidget::CurveNode& n0 = nodes[i];
+            const CurveWidget::CurveNode& n1 = nodes[i + 1];
+            if (n1.mainPoint.x() - n0.mainPoint.x() <= 1e-9) continue;
+
+            if (isFolded(n0, n1)) {
+                add(Error, "folded_segment", channel, i, QString("Segment %1-%2 folds back in x, so y(x) is ambiguous").arg(i).arg(i + 1));
+            }
+
+            qreal worst = 0.0;
+            for (int k = 0; k < CONVERGENCE_PROBES; ++k) {
+                const qreal x = n0.mainPoint.x() + (n1.mainPoint.x() - n0.mainPoint.x()) * (k + 0.5) / CONVERGENCE_PROBES;
+                const qreal t = CurveSampler::solveSegmentT(n0, n1, x);
+                const qreal reached = CurveSampler::bezierComponent(n0.mainPoint.x(), n0.handleOut.x(), n1.handleIn.x(), n1.mainPoint.x(), t);
+                worst = std::max(worst, std::abs(reached - x));
+            }
+            if (worst > CONVERGENCE_TOLERANCE) {
+                add(Warning, "sampler_nonconvergence", channel, i,
+                    QString("Sampler misses x by up to %1 on segment %2-%3").arg(worst, 0, 'g', 3).arg(i).arg(i + 1));
+            }
+        }
+    }
+    return issues;
+}
+
+/**
+ * @brief Loads, checks and (if asked and the file is older than the current format)
+ * rewrites one project.
+ */
+ProjectReport ProjectValidator::processFile(const QString& filePath, bool migrate)
+{
+    ProjectReport report;
+    report.filePath = filePath;
+
+    CurveProject::ProjectData project;
+    QString errorMessage;
+    if (!CurveProject::readFile(filePath, project, &errorMessage)) {
+        report.issues.append({ProjectIssue::Severity::Error, "unreadable", QString(), -1, errorMessage});
+        return report;
+    }
+    report.readable = true;
+    report.formatVersion = project.formatVersion;
+
+    for (const QString& warning : std::as_const(project.warnings)) {
+        report.issues.append({ProjectIssue::Severity::Warning, "load_repair", QString(), -1, warning});
+    }
+    report.issues += validateChannels(project.channels);
+
+    const int versionOrder = CurveProject::compareVersions(project.formatVersion, CurveProject::FormatVersion);
+    if (versionOrder > 0) {
+        // Rewriting would drop whatever the newer format added, so such files are never migrated.
+        if (migrate) {
+            report.issues.append({ProjectIssue::Severity::Error, "unsupported_version", QString(), -1,
+                                  QString("Format %1 is newer than %2 and cannot be migrated")
+                                      .arg(project.formatVersion, QString(CurveProject::FormatVersion))});
+        }
+        return report;
+    }
+    if (migrate && (versionOrder < 0 || !project.warnings.isEmpty())) {
+        CurveProject::assignMissingIds(project.channels);
+        if (CurveProject::writeFile(filePath, project.channels, project.settings, &errorMessage)) {
+            report.migrated = true;
+        } else {
+            report.issues.append({ProjectIssue::Severity::Error, "write_failed", QString(), -1, errorMessage});
+        }
+    }
+    return report;
+}
+
+/**
+ * @brief Processes files in parallel. Reports come back in the order of filePaths.
+ */
+QVector<ProjectReport> ProjectValidator::processFiles(const QStringList& filePaths, bool migrate)
+{
+    QVector<ProjectReport> reports(filePaths.size());
+    ProjectReport *results = reports.data();
+    BakeService::parallelFor(filePaths.size(), 1, [results, &filePaths, migrate](int first, int last) {
+        for (int i = first; i < last; ++i) results[i] = processFile(filePaths[i], migrate);
+    }, BakeService::instance().pool());
+    return reports;
+}
+
+/**
+ * @brief Expands directories (recursively, `*.json`) and keeps plain file paths.
+ */
+QStringList ProjectValidator::collectProjectFiles(const QStringList& paths)
+{
+    QStringList files;
+    for (const QString& path : paths) {
+        const QFileInfo info(path);
+        if (info.isDir()) {
+            QDirIterator it(path, {"*.json"}, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) files.append(it.next());
+        } else {
+            files.append(path);
+        }
+    }
+    return files;
+}
+
+/**
+ * @brief The machine-readable report: totals plus one entry per file.
+ */
+QJsonObject ProjectValidator::summaryJson(const QVector<ProjectReport>& reports)
+{
+    int errors = 0, warnings = 0, migrated = 0, unreadable = 0, clean = 0;
+    QJsonArray projects;
+    for (const ProjectReport& report : reports) {
+        const int fileErrors = report.count(ProjectIssue::Severity::Error);
+        errors += fileErrors;
+        warnings += report.count(ProjectIssue::Severity::Warning);
+        if (report.migrated) ++migrated;
+        if (!report.readable) ++unreadable;
+        if (report.issues.isEmpty()) ++clean;
+        projects.append(report.toJson());
+    }
+
+    QJsonObject root;
+    root["report_format_version"] = 1;
+    root["latest_file_format_version"] = CurveProject::FormatVersion;
+    root["files"] = reports.size();
+    root["clean_files"] = clean;
+    root["unreadable_files"] = unreadable;
+    root["migrated_files"] = migrated;
+    root["errors"] = errors;
+    root["warnings"] = warnings;
+    root["projects"] = projects;
+    return root;
+}
@@ -0,0 +1,62 @@
+#ifndef PROJECTVALIDATOR_H
+#define PROJECTVALIDATOR_H
+
+// Qt Includes
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Project Includes
+#include "curveproject.h"
+
+/**
+ * @brief One problem found in a project. node is -1 for channel or file level issues.
+ */
+struct ProjectIssue {
+    enum class Severity { Warning, Error };
+
+    Severity severity = Severity::Warning;
+    QString code;       // Stable machine-readable id, e.g. "unsorted_x".
+    QString channel;    // RED/GREEN/BLUE, empty for file level issues.
+    int node = -1;
+    QString message;
+
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief Outcome of validating (and optionally migrating) one project file.
+ */
+struct ProjectReport {
+    QString filePath;
+    QString formatVersion;
+    bool readable = false;
+    bool migrated = false;
+    QVector<ProjectIssue> issues;
+
+    int count(ProjectIssue::Severity severity) const;
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief Headless structural checks for curve projects, used by `--validate`.
+ *
+ * Files are processed in parallel on the shared BakeService pool. Each report lists
+ * load repairs (missing channels, alignments), unsorted or duplicate node x, folded
+ * segments (x(t) not monotonic, so y(x) is ambiguous), handles outside the unit
+ * square and x positions where the sampler's Newton solve does not converge.
+ * With migration enabled, readable files in an older format are rewritten in the
+ * current one; curve geometry is never changed.
+ */
+class ProjectValidator
+{
+public:
+    static QVector<ProjectIssue> validateChannels(const CurveProject::ChannelMap& channels);
+    static ProjectReport processFile(const QString& filePath, bool migrate);
+    static QVector<ProjectReport> processFiles(const QStringList& filePaths, bool migrate);
+    static QStringList collectProjectFiles(const QStringList& paths);
+    static QJsonObject summaryJson(const QVector<ProjectReport>& reports);
+};
+
+#endif
@@ -0,0 +1,141 @@
+#include "sessionrecorder.h"
+#include "curvewidget.h"
+#include "curveproject.h"
+
+#include <QDebug>
+#include <QEvent>
+#include <QFile>
+#include <QJsonDocument>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QResizeEvent>
+
+SessionRecorder::SessionRecorder(CurveWidget *widget, QObject *parent)
+    : QObject(parent),
+    m_curveWidget(widget),
+    m_initialWidth(0),
+    m_initialHeight(0),
+    m_recording(false)
+{
+}
+
+/**
+ * @brief Captures the current curve state and starts listening to widget input.
+ * Any previously recorded events are discarded.
+ */
+void SessionRecorder::start()
+{
+    if (!m_curveWidget) {
+        qWarning() << "SessionRecorder::start - CurveWidget pointer is null.";
+        return;
+    }
+    if (m_recording) return;
+
+    m_events = QJsonArray();
+    m_initialState = CurveProject::channelsToJson(m_curveWidget->getAllChannelNodes());
+    m_initialWidth = m_curveWidget->width();
+    m_initialHeight = m_curveWidget->height();
+
+    m_curveWidget->installEventFilter(this);
+    m_clock.start();
+    m_recording = true;
+    qDebug() << "Session recording started.";
+}
+
+/**
+ * @brief Stops listening to widget input. Recorded events are kept until the next start().
+ */
+void SessionRecorder::stop()
+{
+    if (!m_recording) return;
+    if (m_curveWidget) {
+        m_curveWidget->removeEventFilter(this);
+    }
+    m_recording = false;
+    qDebug() << "Session recording stopped after" << m_events.size() << "events.";
+}
+
+bool SessionRecorder::isRecording() const
+{
+    return m_recording;
+}
+
+int SessionRecorder::eventCount() const
+{
+    return m_events.size();
+}
+
+/**
+ * @brief Writes the recorded session to a JSON file.
+ * @return false if the file could not be written.
+ */
+bool SessionRecorder::save(const QString& filePath) const
+{
+    QJsonObject rootObj;
+    rootObj["session_format_version"] = 1;
+    rootObj["widget_size"] = QJsonArray({m_initialWidth, m_initialHeight});
+    rootObj["channels"] = m_initialState;
+    rootObj["events"] = m_events;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Couldn't open session file:" << filePath << file.errorString();
+        return false;
+    }
+    if (file.write(QJsonDocument(rootObj).toJson(QJsonDocument::Compact)) == -1) {
+        qWarning() << "Failed to write session file:" << filePath << file.errorString();
+        return false;
+    }
+    qDebug() << "Session with" << m_events.size() << "events saved to" << filePath;
+    return true;
+}
+
+/**
+ * @brief Appends mouse, key and resize events to the session. Never consumes the event.
+ */
+bool SessionRecorder::eventFilter(QObject *watched, QEvent *event)
+{
+    if (!m_recording || watched != m_curveWidget.data()) {
+        return QObject::eventFilter(watched, event);
+    }
+
+    QJsonObject entry;
+    switch (event->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseMove: {
+        const QMouseEvent *mouseEvent = static_cast<const QMouseEvent*>(event);
+        entry["type"] = static_cast<int>(event->type());
+        entry["x"] = mouseEvent->position().x();
+        entry["y"] = mouseEvent->position().y();
+        entry["button"] = static_cast<int>(mouseEvent->button());
+        entry["buttons"] = static_cast<int>(mouseEvent->buttons());
+        entry["mods"] = static_cast<int>(mouseEvent->modifiers());
+        break;
+    }
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease: {
+        const QKeyEvent *keyEvent = static_cast<const QKeyEvent*>(event);
+        entry["type"] = static_cast<int>(event->type());
+        entry["key"] = keyEvent->key();
+        entry["mods"] = static_cast<int>(keyEvent->modifiers());
+        entry["text"] = keyEvent->text();
+        entry["autorep"] = keyEvent->isAutoRepeat();
+        break;
+    }
+    case QEvent::Resize: {
+        const QResizeEvent *resizeEvent = static_cast<const QResizeEvent*>(event);
+        entry["type"] = static_cast<int>(event->type());
+        entry["w"] = resizeEvent->size().width();
+        entry["h"] = resizeEvent->size().height();
+        break;
+    }
+    default:
+        return QObject::eventFilter(watched, event);
+    }
+
+    entry["t"] = m_clock.nsecsElapsed() / 1.0e6;
+    m_events.append(entry);
+    return QObject::eventFilter(watched, event);
+}
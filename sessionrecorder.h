@@ -0,0 +1,49 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+// Qt Includes
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+// Forward Declarations
+class CurveWidget;
+class QEvent;
+
+/**
+ * @brief Records mouse and key input delivered to a CurveWidget so the session
+ * can be replayed later by SessionReplayer.
+ *
+ * The file is a JSON document holding the starting curve state, the widget size
+ * and one entry per event (timestamp in ms, position, buttons, modifiers, key).
+ */
+class SessionRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionRecorder(CurveWidget *widget, QObject *parent = nullptr);
+
+    void start();
+    void stop();
+    bool isRecording() const;
+    int eventCount() const;
+    bool save(const QString& filePath) const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    QPointer<CurveWidget> m_curveWidget;
+    QElapsedTimer m_clock;
+    QJsonObject m_initialState;
+    QJsonArray m_events;
+    int m_initialWidth;
+    int m_initialHeight;
+    bool m_recording;
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "sessionreplayer.h"
+#include "curvewidget.h"
+#include "curveproject.h"
+#include "curvedeltacommand.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QUndoStack>
+
+#include <algorithm>
+
+SessionReplayer::SessionReplayer(CurveWidget *widget, QObject *parent)
+    : QObject(parent),
+    m_curveWidget(widget),
+    m_recordedWidth(0),
+    m_recordedHeight(0),
+    m_totalNs(0),
+    m_peakUndoBytes(0),
+    m_finalUndoBytes(0),
+    m_finalUndoCount(0)
+{
+}
+
+/**
+ * @brief Reads a session file written by SessionRecorder.
+ * @param errorMessage - Optional; receives a description of the failure.
+ * @return false if the file is missing or malformed.
+ */
+bool SessionReplayer::load(const QString& filePath, QString *errorMessage)
+{
+    auto fail = [&](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        return false;
+    };
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(QString("Could not open session file %1: %2").arg(filePath, file.errorString()));
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull() || !doc.isObject()) {
+        return fail(QString("Failed to parse session file %1: %2").arg(filePath, parseError.errorString()));
+    }
+
+    QJsonObject rootObj = doc.object();
+    if (rootObj.value("session_format_version").toInt() != 1) {
+        return fail(QString("Unsupported session format in %1").arg(filePath));
+    }
+
+    QJsonArray sizeArray = rootObj.value("widget_size").toArray();
+    if (sizeArray.size() != 2 || sizeArray[0].toInt() <= 0 || sizeArray[1].toInt() <= 0) {
+        return fail(QString("Session file %1 has no valid widget_size").arg(filePath));
+    }
+
+    m_recordedWidth = sizeArray[0].toInt();
+    m_recordedHeight = sizeArray[1].toInt();
+    m_initialState = rootObj.value("channels").toObject();
+    m_events = rootObj.value("events").toArray();
+    return true;
+}
+
+/**
+ * @brief Restores the recorded starting curves and delivers every event in order.
+ * Positions are rescaled from the recorded widget size to the current one.
+ */
+void SessionReplayer::run()
+{
+    if (!m_curveWidget) {
+        qWarning() << "SessionReplayer::run - CurveWidget pointer is null.";
+        return;
+    }
+
+    QCoreApplication::processEvents();
+
+    CurveProject::ChannelMap initialNodes;
+    if (CurveProject::channelsFromJson(m_initialState, initialNodes)) {
+        m_curveWidget->setAllChannelNodes(initialNodes);
+    } else {
+        qWarning() << "SessionReplayer::run - Session has no usable initial state, replaying on current curves.";
+    }
+
+    m_dispatchNs.clear();
+    m_paintNs.clear();
+    m_bakeNs.clear();
+    m_dispatchNs.reserve(m_events.size());
+    m_paintNs.reserve(m_events.size());
+    m_peakUndoBytes = 0;
+
+    int recordedWidth = m_recordedWidth;
+    int recordedHeight = m_recordedHeight;
+
+    QElapsedTimer totalTimer;
+    totalTimer.start();
+
+    for (const QJsonValue& value : std::as_const(m_events)) {
+        const QJsonObject entry = value.toObject();
+        const QEvent::Type type = static_cast<QEvent::Type>(entry.value("type").toInt());
+        const Qt::KeyboardModifiers mods(entry.value("mods").toInt());
+
+        QElapsedTimer dispatchTimer;
+        dispatchTimer.start();
+
+        switch (type) {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove: {
+            const qreal sx = static_cast<qreal>(m_curveWidget->width()) / recordedWidth;
+            const qreal sy = static_cast<qreal>(m_curveWidget->height()) / recordedHeight;
+            const QPointF localPos(entry.value("x").toDouble() * sx, entry.value("y").toDouble() * sy);
+            QMouseEvent mouseEvent(type, localPos, m_curveWidget->mapToGlobal(localPos),
+                                   static_cast<Qt::MouseButton>(entry.value("button").toInt()),
+                                   Qt::MouseButtons(entry.value("buttons").toInt()),
+                                   mods);
+            QCoreApplication::sendEvent(m_curveWidget, &mouseEvent);
+            break;
+        }
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease: {
+            QKeyEvent keyEvent(type, entry.value("key").toInt(), mods,
+                               entry.value("text").toString(), entry.value("autorep").toBool());
+            QCoreApplication::sendEvent(m_curveWidget, &keyEvent);
+            break;
+        }
+        case QEvent::Resize:
+            recordedWidth = std::max(1, entry.value("w").toInt());
+            recordedHeight = std::max(1, entry.value("h").toInt());
+            continue;
+        default:
+            qWarning() << "SessionReplayer::run - Skipping unknown event type" << static_cast<int>(type);
+            continue;
+        }
+        m_dispatchNs.append(dispatchTimer.nsecsElapsed());
+
+        QElapsedTimer paintTimer;
+        paintTimer.start();
+        m_curveWidget->repaint();
+        m_paintNs.append(paintTimer.nsecsElapsed());
+
+        if (type == QEvent::MouseButtonRelease || type == QEvent::KeyPress) {
+            m_peakUndoBytes = std::max(m_peakUndoBytes, undoStackMemory());
+        }
+    }
+
+    m_totalNs = totalTimer.nsecsElapsed();
+    m_finalUndoBytes = undoStackMemory();
+    m_peakUndoBytes = std::max(m_peakUndoBytes, m_finalUndoBytes);
+    m_finalUndoCount = m_curveWidget->undoStack()->count();
+}
+
+/**
+ * @brief Builds the benchmark report for the last run().
+ */
+QJsonObject SessionReplayer::report() const
+{
+    QJsonObject rootObj;
+    rootObj["events"] = m_dispatchNs.size();
+    rootObj["total_ms"] = m_totalNs / 1.0e6;
+    rootObj["dispatch"] = summarize(m_dispatchNs);
+    rootObj["paint"] = summarize(m_paintNs);
+    rootObj["preview_bake"] = summarize(m_bakeNs);
+
+    QJsonObject undoObj;
+    undoObj["commands"] = m_finalUndoCount;
+    undoObj["final_bytes"] = static_cast<qint64>(m_finalUndoBytes);
+    undoObj["peak_bytes"] = static_cast<qint64>(m_peakUndoBytes);
+    rootObj["undo_stack"] = undoObj;
+    return rootObj;
+}
+
+/**
+ * @brief Collects the duration of a LUT preview refresh triggered during replay.
+ */
+void SessionReplayer::recordPreviewBake(qint64 nsecs)
+{
+    m_bakeNs.append(nsecs);
+}
+
+/**
+ * @brief Sums the estimated size of every command on the widget's undo stack.
+ */
+qsizetype SessionReplayer::undoStackMemory() const
+{
+    qsizetype bytes = 0;
+    const QUndoStack *stack = m_curveWidget->undoStack();
+    for (int i = 0; i < stack->count(); ++i) {
+        if (const CurveDeltaCommand *delta = dynamic_cast<const CurveDeltaCommand*>(stack->command(i))) {
+            bytes += delta->approximateMemoryUsage();
+        }
+    }
+    return bytes;
+}
+
+/**
+ * @brief Reduces a list of durations (ns) to count/mean/percentiles in milliseconds.
+ */
+QJsonObject SessionReplayer::summarize(QVector<qint64> samples)
+{
+    QJsonObject summary;
+    summary["count"] = samples.size();
+    if (samples.isEmpty()) return summary;
+
+    std::sort(samples.begin(), samples.end());
+    qint64 total = 0;
+    for (qint64 sample : std::as_const(samples)) total += sample;
+
+    auto percentile = [&](qreal p) {
+        const int index = std::min(static_cast<int>(samples.size()) - 1,
+                                   static_cast<int>(p * (samples.size() - 1) + 0.5));
+        return samples[index] / 1.0e6;
+    };
+
+    summary["total_ms"] = total / 1.0e6;
+    summary["mean_ms"] = (total / 1.0e6) / samples.size();
+    summary["p50_ms"] = percentile(0.50);
+    summary["p95_ms"] = percentile(0.95);
+    summary["max_ms"] = samples.last() / 1.0e6;
+    return summary;
+}
@@ -0,0 +1,56 @@
+#ifndef SESSIONREPLAYER_H
+#define SESSIONREPLAYER_H
+
+// Qt Includes
+#include <QObject>
+#include <QPointer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+// Forward Declarations
+class CurveWidget;
+
+/**
+ * @brief Replays a session recorded by SessionRecorder against a CurveWidget
+ * as fast as possible and collects interaction timings.
+ *
+ * Intended for headless benchmarking (QT_QPA_PLATFORM=offscreen): each event is
+ * delivered synchronously, followed by a forced repaint, and the report contains
+ * event dispatch, paint and preview bake timings plus undo stack memory.
+ */
+class SessionReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionReplayer(CurveWidget *widget, QObject *parent = nullptr);
+
+    bool load(const QString& filePath, QString *errorMessage = nullptr);
+    void run();
+    QJsonObject report() const;
+
+public slots:
+    void recordPreviewBake(qint64 nsecs);
+
+private:
+    qsizetype undoStackMemory() const;
+    static QJsonObject summarize(QVector<qint64> samples);
+
+    QPointer<CurveWidget> m_curveWidget;
+    QJsonObject m_initialState;
+    QJsonArray m_events;
+    int m_recordedWidth;
+    int m_recordedHeight;
+
+    QVector<qint64> m_dispatchNs;
+    QVector<qint64> m_paintNs;
+    QVector<qint64> m_bakeNs;
+    qint64 m_totalNs;
+    qsizetype m_peakUndoBytes;
+    qsizetype m_finalUndoBytes;
+    int m_finalUndoCount;
+};
+
+#endif
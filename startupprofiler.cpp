@@ -0,0 +1,54 @@
+#include "startupprofiler.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+namespace {
+
+struct ProfilerState {
+    QElapsedTimer clock;
+    qint64 lastMarkNs = 0;
+    bool enabled = qEnvironmentVariableIsSet("CURVEMAKER_STARTUP_TIMING");
+};
+
+ProfilerState& state() {
+    static ProfilerState s;
+    return s;
+}
+
+}
+
+/**
+ * @brief Starts the startup clock. Later calls are ignored.
+ */
+void StartupProfiler::start()
+{
+    ProfilerState& s = state();
+    if (!s.clock.isValid()) {
+        s.clock.start();
+        s.lastMarkNs = 0;
+    }
+}
+
+/**
+ * @brief Logs the duration of the phase that just finished.
+ */
+void StartupProfiler::mark(const char *phase)
+{
+    ProfilerState& s = state();
+    if (!s.enabled) return;
+    start();
+
+    const qint64 nowNs = s.clock.nsecsElapsed();
+    qInfo().noquote() << QString("startup: %1 +%2 ms (total %3 ms)")
+                             .arg(QString::fromLatin1(phase))
+                             .arg((nowNs - s.lastMarkNs) / 1.0e6, 0, 'f', 2)
+                             .arg(nowNs / 1.0e6, 0, 'f', 2);
+    s.lastMarkNs = nowNs;
+}
+
+bool StartupProfiler::isEnabled()
+{
+    return state().enabled;
+}
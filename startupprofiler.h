@@ -0,0 +1,19 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+/**
+ * @brief Prints cold-start phase timings when CURVEMAKER_STARTUP_TIMING is set.
+ *
+ * The clock starts at the first call to start() (or mark()); every mark() logs the
+ * time spent since the previous mark and since startup. Disabled marks cost one
+ * branch, so they can stay in release builds.
+ */
+class StartupProfiler
+{
+public:
+    static void start();
+    static void mark(const char *phase);
+    static bool isEnabled();
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "themestyle.h"
+
+#include <QPainter>
+#include <QStyleOption>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+/**
+ * @brief Fills rect and draws a one-pixel border just inside it.
+ */
+void drawFlatPanel(QPainter *painter, const QRect& rect, const QColor& fill, const QColor& border)
+{
+    painter->save();
+    if (fill.isValid()) painter->fillRect(rect, fill);
+    painter->setPen(border);
+    painter->setBrush(Qt::NoBrush);
+    painter->drawRect(rect.adjusted(0, 0, -1, -1));
+    painter->restore();
+}
+
+}
+
+ThemeStyle::ThemeStyle(QStyle *baseStyle)
+    : QProxyStyle(baseStyle)
+{
+}
+
+void ThemeStyle::drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter,
+                               const QWidget *widget) const
+{
+    const QPalette& pal = option->palette;
+    switch (element) {
+    case PE_PanelButtonCommand: {
+        QColor fill = pal.color(QPalette::Button);
+        QColor border = pal.color(QPalette::Mid);
+        if (option->state & State_On) {
+            fill = pal.color(QPalette::Highlight);
+            border = fill.darker(130);
+        } else if ((option->state & State_Enabled) && (option->state & State_Sunken)) {
+            fill = fill.darker(115);
+        } else if ((option->state & State_Enabled) && (option->state & State_MouseOver)) {
+            fill = pal.color(QPalette::Light);
+        }
+        drawFlatPanel(painter, option->rect, fill, border);
+        return;
+    }
+    case PE_PanelLineEdit:
+        // Line edits embedded in spin and combo boxes come without a frame; those keep Fusion's.
+        if (const QStyleOptionFrame *frame = qstyleoption_cast<const QStyleOptionFrame*>(option)) {
+            if (frame->lineWidth > 0) {
+                drawFlatPanel(painter, option->rect, pal.color(QPalette::Base), pal.color(QPalette::Mid));
+                return;
+            }
+        }
+        break;
+    case PE_FrameMenu:
+        drawFlatPanel(painter, option->rect, QColor(), pal.color(QPalette::Mid));
+        return;
+    default:
+        break;
+    }
+    QProxyStyle::drawPrimitive(element, option, painter, widget);
+}
+
+void ThemeStyle::drawControl(ControlElement element, const QStyleOption *option, QPainter *painter,
+                             const QWidget *widget) const
+{
+    if (element == CE_PushButtonLabel && (option->state & State_On)) {
+        if (const QStyleOptionButton *button = qstyleoption_cast<const QStyleOptionButton*>(option)) {
+            QStyleOptionButton onAccent(*button);
+            onAccent.palette.setColor(QPalette::ButtonText, option->palette.color(QPalette::HighlightedText));
+            QProxyStyle::drawControl(element, &onAccent, painter, widget);
+            return;
+        }
+    }
+    QProxyStyle::drawControl(element, option, painter, widget);
+}
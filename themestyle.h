@@ -0,0 +1,26 @@
+#ifndef THEMESTYLE_H
+#define THEMESTYLE_H
+
+// Qt Includes
+#include <QProxyStyle>
+
+/**
+ * @brief Fusion with the few looks the themes need beyond a palette: checked push
+ * buttons in the highlight color, and flat one-pixel borders (palette Mid) on push
+ * buttons, line edits and menus.
+ *
+ * Everything is drawn from the widget's palette, so switching themes only swaps the
+ * application palette; nothing is parsed or repolished.
+ */
+class ThemeStyle : public QProxyStyle
+{
+public:
+    explicit ThemeStyle(QStyle *baseStyle = nullptr);
+
+    void drawPrimitive(PrimitiveElement element, const QStyleOption *option, QPainter *painter,
+                       const QWidget *widget = nullptr) const override;
+    void drawControl(ControlElement element, const QStyleOption *option, QPainter *painter,
+                     const QWidget *widget = nullptr) const override;
+};
+
+#endif
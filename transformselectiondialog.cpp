@@ -0,0 +1,71 @@
+#include "transformselectiondialog.h"
+
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+TransformSelectionDialog::TransformSelectionDialog(const QRectF& selectionBounds, QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Transform Selection"));
+
+    const QPointF center = selectionBounds.center();
+    m_pivotX = createSpinBox(0.0, 1.0, center.x());
+    m_pivotY = createSpinBox(0.0, 1.0, center.y());
+    m_scaleX = createSpinBox(-10.0, 10.0, 1.0);
+    m_scaleY = createSpinBox(-10.0, 10.0, 1.0);
+    m_offsetX = createSpinBox(-1.0, 1.0, 0.0);
+    m_offsetY = createSpinBox(-1.0, 1.0, 0.0);
+    m_flipX = new QCheckBox(tr("Flip horizontally"), this);
+    m_flipY = new QCheckBox(tr("Flip vertically"), this);
+
+    auto pair = [this](QDoubleSpinBox *x, QDoubleSpinBox *y) {
+        QHBoxLayout *row = new QHBoxLayout;
+        row->addWidget(x);
+        row->addWidget(y);
+        return row;
+    };
+
+    QFormLayout *form = new QFormLayout;
+    form->addRow(tr("Pivot (X, Y):"), pair(m_pivotX, m_pivotY));
+    form->addRow(tr("Scale (X, Y):"), pair(m_scaleX, m_scaleY));
+    form->addRow(tr("Offset (X, Y):"), pair(m_offsetX, m_offsetY));
+    form->addRow(m_flipX);
+    form->addRow(m_flipY);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(form);
+    layout->addWidget(buttons);
+}
+
+/**
+ * @brief Returns the transform described by the current field values.
+ */
+CurveWidget::NodeTransform TransformSelectionDialog::transform() const
+{
+    CurveWidget::NodeTransform result;
+    result.pivot = QPointF(m_pivotX->value(), m_pivotY->value());
+    result.scaleX = m_scaleX->value();
+    result.scaleY = m_scaleY->value();
+    result.offset = QPointF(m_offsetX->value(), m_offsetY->value());
+    result.flipX = m_flipX->isChecked();
+    result.flipY = m_flipY->isChecked();
+    return result;
+}
+
+QDoubleSpinBox* TransformSelectionDialog::createSpinBox(qreal minimum, qreal maximum, qreal value)
+{
+    QDoubleSpinBox *spinBox = new QDoubleSpinBox(this);
+    spinBox->setDecimals(3);
+    spinBox->setSingleStep(0.05);
+    spinBox->setRange(minimum, maximum);
+    spinBox->setValue(value);
+    return spinBox;
+}
@@ -0,0 +1,42 @@
+#ifndef TRANSFORMSELECTIONDIALOG_H
+#define TRANSFORMSELECTIONDIALOG_H
+
+// Qt Includes
+#include <QDialog>
+#include <QRectF>
+
+// Project Includes
+#include "curvewidget.h" // Required for CurveWidget::NodeTransform
+
+// Forward Declarations
+class QDoubleSpinBox;
+class QCheckBox;
+
+/**
+ * @brief Asks for the scale, pivot, offset and flips of a selection transform.
+ * The pivot starts at the center of the selection's bounding box, which may have zero
+ * size, e.g. for a single node.
+ */
+class TransformSelectionDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    TransformSelectionDialog(const QRectF& selectionBounds, QWidget *parent = nullptr);
+
+    CurveWidget::NodeTransform transform() const;
+
+private:
+    QDoubleSpinBox* createSpinBox(qreal minimum, qreal maximum, qreal value);
+
+    QDoubleSpinBox *m_pivotX;
+    QDoubleSpinBox *m_pivotY;
+    QDoubleSpinBox *m_scaleX;
+    QDoubleSpinBox *m_scaleY;
+    QDoubleSpinBox *m_offsetX;
+    QDoubleSpinBox *m_offsetY;
+    QCheckBox *m_flipX;
+    QCheckBox *m_flipY;
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "vatbakedialog.h"
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QDoubleSpinBox>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include <cmath>
+
+VatBakeDialog::VatBakeDialog(const QString& meshPath, const VatSettings& initial, QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Bake Vertex Animation"));
+
+    m_meshPath = new QLineEdit(meshPath, this);
+    QPushButton *browseButton = new QPushButton(tr("Browse..."), this);
+    QHBoxLayout *meshLayout = new QHBoxLayout;
+    meshLayout->addWidget(m_meshPath, 1);
+    meshLayout->addWidget(browseButton);
+
+    m_duration = new QDoubleSpinBox(this);
+    m_duration->setDecimals(3);
+    m_duration->setRange(0.001, 3600.0);
+    m_duration->setSuffix(tr(" s"));
+    m_duration->setValue(initial.timing.duration);
+
+    m_fps = new QDoubleSpinBox(this);
+    m_fps->setDecimals(3);
+    m_fps->setRange(0.001, 1000.0);
+    m_fps->setValue(initial.timing.fps);
+
+    m_loop = new QCheckBox(tr("Loop (leave out the frame at the end and wrap phases)"), this);
+    m_loop->setChecked(initial.timing.loop);
+
+    QHBoxLayout *amplitudeLayout = new QHBoxLayout;
+    const float amplitude[3] = { initial.amplitude.x(), initial.amplitude.y(), initial.amplitude.z() };
+    const char *axisNames[3] = { "X", "Y", "Z" };
+    for (int i = 0; i < 3; ++i) {
+        m_amplitude[i] = new QDoubleSpinBox(this);
+        m_amplitude[i]->setDecimals(4);
+        m_amplitude[i]->setRange(-10000.0, 10000.0);
+        m_amplitude[i]->setPrefix(QString("%1 ").arg(axisNames[i]));
+        m_amplitude[i]->setValue(amplitude[i]);
+        amplitudeLayout->addWidget(m_amplitude[i]);
+    }
+    m_amplitude[0]->setToolTip(tr("X offset per unit of the red curve"));
+    m_amplitude[1]->setToolTip(tr("Y offset per unit of the green curve"));
+    m_amplitude[2]->setToolTip(tr("Z offset per unit of the blue curve"));
+
+    m_center = new QDoubleSpinBox(this);
+    m_center->setDecimals(4);
+    m_center->setRange(-1.0, 2.0);
+    m_center->setSingleStep(0.5);
+    m_center->setValue(initial.center);
+    m_center->setToolTip(tr("Curve value that leaves a vertex in place"));
+
+    m_phaseSource = new QComboBox(this);
+    m_phaseSource->addItem(tr("None"), int(VatSettings::PhaseSource::None));
+    m_phaseSource->addItem(tr("Position along axis"), int(VatSettings::PhaseSource::Position));
+    m_phaseSource->addItem(tr("Vertex color (red)"), int(VatSettings::PhaseSource::VertexColor));
+    m_phaseSource->setCurrentIndex(m_phaseSource->findData(int(initial.phaseSource)));
+
+    m_phaseAxis = new QComboBox(this);
+    m_phaseAxis->addItem("X", QVector3D(1.0f, 0.0f, 0.0f));
+    m_phaseAxis->addItem("Y", QVector3D(0.0f, 1.0f, 0.0f));
+    m_phaseAxis->addItem("Z", QVector3D(0.0f, 0.0f, 1.0f));
+    const QVector3D axis = initial.phaseAxis.normalized();
+    m_phaseAxis->setCurrentIndex(std::abs(axis.x()) > 0.5f ? 0 : std::abs(axis.z()) > 0.5f ? 2 : 1);
+
+    m_phaseScale = new QDoubleSpinBox(this);
+    m_phaseScale->setDecimals(4);
+    m_phaseScale->setRange(-100.0, 100.0);
+    m_phaseScale->setSingleStep(0.1);
+    m_phaseScale->setValue(initial.phaseScale);
+    m_phaseScale->setToolTip(tr("Largest phase, in curve x units"));
+
+    m_format = new QComboBox(this);
+    m_format->addItem(tr("32-bit float"), int(VatSettings::Format::Float32));
+    m_format->addItem(tr("16-bit half float (DDS)"), int(VatSettings::Format::Half));
+    m_format->setCurrentIndex(m_format->findData(int(initial.format)));
+
+    m_sizeLabel = new QLabel(this);
+
+    QFormLayout *form = new QFormLayout;
+    form->addRow(tr("Mesh (OBJ):"), meshLayout);
+    form->addRow(tr("Duration:"), m_duration);
+    form->addRow(tr("Frames per second:"), m_fps);
+    form->addRow(m_loop);
+    form->addRow(tr("Amplitude:"), amplitudeLayout);
+    form->addRow(tr("Rest value:"), m_center);
+    form->addRow(tr("Phase:"), m_phaseSource);
+    form->addRow(tr("Phase axis:"), m_phaseAxis);
+    form->addRow(tr("Phase scale:"), m_phaseScale);
+    form->addRow(tr("Format:"), m_format);
+    form->addRow(tr("Frames:"), m_sizeLabel);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(form);
+    layout->addWidget(buttons);
+
+    connect(browseButton, &QPushButton::clicked, this, &VatBakeDialog::onBrowseClicked);
+    connect(m_duration, &QDoubleSpinBox::valueChanged, this, &VatBakeDialog::updateState);
+    connect(m_fps, &QDoubleSpinBox::valueChanged, this, &VatBakeDialog::updateState);
+    connect(m_loop, &QCheckBox::toggled, this, &VatBakeDialog::updateState);
+    connect(m_phaseSource, &QComboBox::currentIndexChanged, this, &VatBakeDialog::updateState);
+    updateState();
+}
+
+QString VatBakeDialog::meshPath() const
+{
+    return m_meshPath->text();
+}
+
+/**
+ * @brief Returns the settings described by the current field values.
+ */
+VatSettings VatBakeDialog::settings() const
+{
+    VatSettings result;
+    result.timing.duration = m_duration->value();
+    result.timing.fps = m_fps->value();
+    result.timing.loop = m_loop->isChecked();
+    result.amplitude = QVector3D(m_amplitude[0]->value(), m_amplitude[1]->value(), m_amplitude[2]->value());
+    result.center = m_center->value();
+    result.phaseSource = static_cast<VatSettings::PhaseSource>(m_phaseSource->currentData().toInt());
+    result.phaseAxis = m_phaseAxis->currentData().value<QVector3D>();
+    result.phaseScale = m_phaseScale->value();
+    result.format = static_cast<VatSettings::Format>(m_format->currentData().toInt());
+    return result;
+}
+
+void VatBakeDialog::onBrowseClicked()
+{
+    const QString filePath = QFileDialog::getOpenFileName(this, tr("Choose Mesh"), m_meshPath->text(), tr("Wavefront OBJ (*.obj)"));
+    if (!filePath.isEmpty()) {
+        m_meshPath->setText(filePath);
+    }
+}
+
+void VatBakeDialog::updateState()
+{
+    const VatSettings current = settings();
+    m_sizeLabel->setText(QString::number(current.timing.frameCount()));
+    m_phaseAxis->setEnabled(current.phaseSource == VatSettings::PhaseSource::Position);
+    m_phaseScale->setEnabled(current.phaseSource != VatSettings::PhaseSource::None);
+}
@@ -0,0 +1,49 @@
+#ifndef VATBAKEDIALOG_H
+#define VATBAKEDIALOG_H
+
+// Qt Includes
+#include <QDialog>
+
+// Project Includes
+#include "vatbaker.h"
+
+// Forward Declarations
+class QCheckBox;
+class QComboBox;
+class QDoubleSpinBox;
+class QLabel;
+class QLineEdit;
+
+/**
+ * @brief Asks for the mesh, timing, per-axis amplitude, phase and texel format of a
+ * vertex animation texture bake.
+ */
+class VatBakeDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit VatBakeDialog(const QString& meshPath, const VatSettings& initial, QWidget *parent = nullptr);
+
+    QString meshPath() const;
+    VatSettings settings() const;
+
+private slots:
+    void onBrowseClicked();
+    void updateState();
+
+private:
+    QLineEdit *m_meshPath;
+    QDoubleSpinBox *m_duration;
+    QDoubleSpinBox *m_fps;
+    QCheckBox *m_loop;
+    QDoubleSpinBox *m_amplitude[3];
+    QDoubleSpinBox *m_center;
+    QComboBox *m_phaseSource;
+    QComboBox *m_phaseAxis;
+    QDoubleSpinBox *m_phaseScale;
+    QComboBox *m_format;
+    QLabel *m_sizeLabel;
+};
+
+#endif
@@ -0,0 +1,236 @@
+#include "vatbaker.h"
+#include "bakeservice.h"
+#include "objmesh.h"
+
+#include <QFloat16>
+#include <QJsonArray>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+// Legacy D3DFORMAT codes, stored as the DDS FourCC of float formats.
+const quint32 D3DFMT_A16B16G16R16F = 113;
+const quint32 D3DFMT_A32B32G32R32F = 116;
+
+// Widest texture most engines accept without a wrapped layout.
+const int MAX_TEXTURE_WIDTH = 16384;
+
+QByteArray ddsHeader(int width, int height, bool half)
+{
+    quint32 header[32] = {};
+    header[0] = 0x20534444;                 // "DDS "
+    quint32 *h = header + 1;
+    h[0] = 124;                             // dwSize
+    h[1] = 0x1 | 0x2 | 0x4 | 0x8 | 0x1000;  // CAPS | HEIGHT | WIDTH | PITCH | PIXELFORMAT
+    h[2] = static_cast<quint32>(height);
+    h[3] = static_cast<quint32>(width);
+    h[4] = static_cast<quint32>(width) * (half ? 8u : 16u);
+    h[6] = 1;                               // dwMipMapCount
+    h[18] = 32;                             // ddspf.dwSize
+    h[19] = 0x4;                            // DDPF_FOURCC
+    h[20] = half ? D3DFMT_A16B16G16R16F : D3DFMT_A32B32G32R32F;
+    h[26] = 0x1000;                         // DDSCAPS_TEXTURE
+    for (quint32& value : header) value = qToLittleEndian(value);
+    return QByteArray(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+/**
+ * @brief Appends one row of xyz offsets in the output's pixel format.
+ */
+void appendRow(QByteArray& out, const float *xyz, int width, VatSettings::Format format, bool dds)
+{
+    if (!dds) {
+        for (int i = 0; i < width * 3; ++i) {
+            const float value = qToLittleEndian(xyz[i]);
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        return;
+    }
+    for (int v = 0; v < width; ++v) {
+        const float rgba[4] = { xyz[v * 3 + 0], xyz[v * 3 + 1], xyz[v * 3 + 2], 1.0f };
+        for (float component : rgba) {
+            if (format == VatSettings::Format::Half) {
+                const qfloat16 half(component);
+                quint16 bits = 0;
+                std::memcpy(&bits, &half, sizeof(bits));
+                bits = qToLittleEndian(bits);
+                out.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+            } else {
+                const float value = qToLittleEndian(component);
+                out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+        }
+    }
+}
+
+}
+
+/**
+ * @brief Per-vertex phase, in curve x units, for the configured phase source.
+ */
+QVector<qreal> VatBaker::vertexPhases(const ObjMesh& mesh, const VatSettings& settings)
+{
+    QVector<qreal> phases(mesh.vertexCount(), 0.0);
+    switch (settings.phaseSource) {
+    case VatSettings::PhaseSource::None:
+        break;
+    case VatSettings::PhaseSource::Position: {
+        const QVector3D axis = settings.phaseAxis.normalized();
+        if (axis.isNull()) break;
+        qreal lowest = std::numeric_limits<qreal>::max();
+        qreal highest = std::numeric_limits<qreal>::lowest();
+        for (int i = 0; i < phases.size(); ++i) {
+            phases[i] = QVector3D::dotProduct(mesh.positions()[i], axis);
+            lowest = std::min(lowest, phases[i]);
+            highest = std::max(highest, phases[i]);
+        }
+        const qreal extent = highest - lowest;
+        for (qreal& phase : phases) {
+            phase = (extent > 0.0) ? (phase - lowest) / extent * settings.phaseScale : 0.0;
+        }
+        break;
+    }
+    case VatSettings::PhaseSource::VertexColor:
+        if (!mesh.hasColors()) break;
+        for (int i = 0; i < phases.size(); ++i) {
+            phases[i] = mesh.colors()[i].x() * settings.phaseScale;
+        }
+        break;
+    }
+    return phases;
+}
+
+/**
+ * @brief Bakes the texture to outputPath: `.dds` for DDS, anything else for PFM (which
+ * has no half format).
+ * @param report - If not null, receives size, format and the offset range.
+ * @param pool - Pool for the per-block jobs; null bakes on the calling thread.
+ */
+bool VatBaker::bake(const ObjMesh& mesh, const CurveSampler::ChannelMap& channels, const VatSettings& settings,
+                    const QString& outputPath, QString *errorMessage, QJsonObject *report, QThreadPool *pool)
+{
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        return false;
+    };
+
+    const int vertices = mesh.vertexCount();
+    const int frames = settings.timing.frameCount();
+    const bool dds = outputPath.endsWith(QStringLiteral(".dds"), Qt::CaseInsensitive);
+    if (vertices < 1) return fail(QStringLiteral("Mesh has no vertices"));
+    if (frames < 1) return fail(QStringLiteral("Duration and frame rate must be positive"));
+    if (settings.format == VatSettings::Format::Half && !dds) return fail(QStringLiteral("Half floats need a .dds output"));
+    if (settings.phaseSource == VatSettings::PhaseSource::VertexColor && !mesh.hasColors()) {
+        return fail(QStringLiteral("Phase from vertex color, but the mesh has no vertex colors"));
+    }
+
+    // Visiting vertices in phase order keeps each frame's x values sorted, apart
+    // from the places where a looping phase wraps past 1.
+    const QVector<qreal> phases = vertexPhases(mesh, settings);
+    QVector<int> order(vertices);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&phases](int l, int r) { return phases[l] < phases[r]; });
+    QVector<qreal> sortedPhases(vertices);
+    for (int i = 0; i < vertices; ++i) sortedPhases[i] = phases[order[i]];
+
+    QSaveFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly)) return fail(file.errorString());
+    const QByteArray header = dds ? ddsHeader(vertices, frames, settings.format == VatSettings::Format::Half)
+                                  : QByteArray("PF\n%1 %2\n-1.0\n").replace("%1", QByteArray::number(vertices))
+                                                                     .replace("%2", QByteArray::number(frames));
+    if (file.write(header) != header.size()) return fail(file.errorString());
+
+    const CurveSampler sampler(channels);
+    const CurveWidget::ActiveChannel channelOrder[3] = {
+        CurveWidget::ActiveChannel::RED, CurveWidget::ActiveChannel::GREEN, CurveWidget::ActiveChannel::BLUE
+    };
+    const float amplitude[3] = { settings.amplitude.x(), settings.amplitude.y(), settings.amplitude.z() };
+
+    // One job: one frame's offsets for the sorted vertex range [first, last).
+    auto bakeRange = [&](int frame, int first, int last, float *row) {
+        const int count = last - first;
+        QVector<qreal> xs(count);
+        QVector<qreal> ys(count);
+        const qreal frameX = settings.timing.frameX(frame);
+        for (int i = 0; i < count; ++i) {
+            const qreal x = frameX + sortedPhases[first + i];
+            xs[i] = settings.timing.loop ? x - std::floor(x) : x;
+        }
+        for (int c = 0; c < 3; ++c) {
+            for (int runStart = 0; runStart < count;) {
+                int runEnd = runStart + 1;
+                while (runEnd < count && xs[runEnd] >= xs[runEnd - 1]) ++runEnd;
+                sampler.sampleSorted(channelOrder[c], xs.constData() + runStart, runEnd - runStart, ys.data() + runStart, false);
+                runStart = runEnd;
+            }
+            for (int i = 0; i < count; ++i) {
+                row[order[first + i] * 3 + c] = static_cast<float>(amplitude[c] * (ys[i] - settings.center));
+            }
+        }
+    };
+
+    float lowest[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+    float highest[3] = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+    QVector<float> block(static_cast<qsizetype>(FramesPerBlock) * vertices * 3);
+    QByteArray encoded;
+
+    // PFM stores rows bottom to top, so frames are streamed last to first there.
+    for (int blockStart = 0; blockStart < frames; blockStart += FramesPerBlock) {
+        const int blockFrames = std::min(FramesPerBlock, frames - blockStart);
+        auto frameOf = [&](int rowInBlock) {
+            const int row = blockStart + rowInBlock;
+            return dds ? row : frames - 1 - row;
+        };
+
+        const int chunksPerRow = (vertices + VerticesPerJob - 1) / VerticesPerJob;
+        float *blockData = block.data();
+        BakeService::parallelFor(blockFrames * chunksPerRow, 1, [&](int firstJob, int lastJob) {
+            for (int j = firstJob; j < lastJob; ++j) {
+                const int r = j / chunksPerRow;
+                const int first = (j % chunksPerRow) * VerticesPerJob;
+                const int last = std::min(vertices, first + VerticesPerJob);
+                bakeRange(frameOf(r), first, last, blockData + static_cast<qsizetype>(r) * vertices * 3);
+            }
+        }, pool);
+
+        encoded.clear();
+        for (int r = 0; r < blockFrames; ++r) {
+            const float *row = block.constData() + static_cast<qsizetype>(r) * vertices * 3;
+            for (int i = 0; i < vertices * 3; ++i) {
+                lowest[i % 3] = std::min(lowest[i % 3], row[i]);
+                highest[i % 3] = std::max(highest[i % 3], row[i]);
+            }
+            appendRow(encoded, row, vertices, settings.format, dds);
+        }
+        if (file.write(encoded) != encoded.size()) return fail(file.errorString());
+    }
+
+    if (!file.commit()) return fail(file.errorString());
+
+    if (report) {
+        QJsonObject obj;
+        obj["output"] = outputPath;
+        obj["vertices"] = vertices;
+        obj["frames"] = frames;
+        obj["fps"] = settings.timing.fps;
+        obj["duration"] = settings.timing.duration;
+        obj["loop"] = settings.timing.loop;
+        obj["format"] = dds ? (settings.format == VatSettings::Format::Half ? "dds_rgba16f" : "dds_rgba32f") : "pfm_rgb32f";
+        obj["offset_min"] = QJsonArray{ lowest[0], lowest[1], lowest[2] };
+        obj["offset_max"] = QJsonArray{ highest[0], highest[1], highest[2] };
+        if (vertices > MAX_TEXTURE_WIDTH) {
+            obj["warning"] = QString("Width %1 exceeds %2 texels; many engines need a wrapped layout").arg(vertices).arg(MAX_TEXTURE_WIDTH);
+        }
+        *report = obj;
+    }
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef VATBAKER_H
+#define VATBAKER_H
+
+// Qt Includes
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <QVector3D>
+
+// Project Includes
+#include "curvesampler.h"
+#include "lutexport.h" // Required for FrameTiming
+
+// Forward Declarations
+class ObjMesh;
+class QThreadPool;
+
+/**
+ * @brief Parameters of a vertex animation texture bake.
+ *
+ * Each frame, a vertex is offset along X, Y and Z by the R, G and B curves:
+ * offset = amplitude * (y(x) - center) per axis. x is the frame's curve position
+ * plus the vertex's phase, so waves can travel across the mesh.
+ */
+struct VatSettings {
+    enum class PhaseSource {
+        None,           // Every vertex moves in sync.
+        Position,       // Phase grows along phaseAxis across the mesh's extent.
+        VertexColor     // Phase is the vertex color's red component.
+    };
+
+    enum class Format {
+        Float32,
+        Half
+    };
+
+    FrameTiming timing;                 // One texture row per frame; supersamples is ignored.
+    QVector3D amplitude = QVector3D(1.0f, 1.0f, 1.0f);
+    qreal center = 0.0;                 // Curve value that means "no offset".
+    PhaseSource phaseSource = PhaseSource::None;
+    QVector3D phaseAxis = QVector3D(0.0f, 1.0f, 0.0f);
+    qreal phaseScale = 1.0;             // Phase at the far end of the axis, or at color 1.
+    Format format = Format::Float32;
+};
+
+/**
+ * @brief Bakes per-vertex position offsets driven by the channel curves into a
+ * frames x vertices texture (one row per frame, one texel per vertex, in OBJ order).
+ *
+ * Output is a PFM (float32 RGB) or a DDS (float32 or half RGBA). Rows are baked in
+ * blocks of frames, each block spread over the BakeService pool by frame and vertex
+ * range and written before the next starts, so memory stays bounded for large meshes.
+ * Vertices are visited in phase order, which keeps every frame's curve positions in a few
+ * ascending runs (split where a looping phase wraps) for the sorted batch sampler.
+ */
+class VatBaker
+{
+public:
+    static bool bake(const ObjMesh& mesh, const CurveSampler::ChannelMap& channels, const VatSettings& settings,
+                     const QString& outputPath, QString *errorMessage = nullptr, QJsonObject *report = nullptr,
+                     QThreadPool *pool = nullptr);
+    static QVector<qreal> vertexPhases(const ObjMesh& mesh, const VatSettings& settings);
+
+    static const int FramesPerBlock = 16;
+    static const int VerticesPerJob = 65536;
+};
+
+#endif
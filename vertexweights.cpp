@@ -0,0 +1,154 @@
+#include "vertexweights.h"
+#include "bakeservice.h"
+#include "lutexport.h"
+#include "objmesh.h"
+
+#include <QFileInfo>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// --- Anonymous Namespace for Local File Helpers ---
+namespace {
+
+quint64 splitMix(quint64 x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief A value in [0, 1) from a position quantized to 1e-4 units, so float noise
+ * from re-exporting the mesh does not change it.
+ */
+float hashedRandom(const QVector3D& position, quint32 seed)
+{
+    quint64 h = splitMix(seed);
+    for (float component : { position.x(), position.y(), position.z() }) {
+        h = splitMix(h ^ static_cast<quint64>(std::llround(component * 1e4)));
+    }
+    return static_cast<float>((h >> 11) * (1.0 / 9007199254740992.0));
+}
+
+/**
+ * @brief Extent along the axis and summed position of one piece.
+ */
+struct Piece {
+    float lowest = std::numeric_limits<float>::max();
+    float highest = std::numeric_limits<float>::lowest();
+    QVector3D sum;
+    int vertices = 0;
+    float farthest = 0.0f;
+    QVector3D pivot;
+    float random = 0.0f;
+};
+
+}
+
+/**
+ * @brief Computes the RGB weights of every vertex, in OBJ order (3 floats per vertex).
+ * @param pieceCount - If not null, receives the number of connected pieces.
+ */
+QVector<float> VertexWeights::compute(const ObjMesh& mesh, const VertexWeightSettings& settings,
+                                      QThreadPool *pool, int *pieceCount)
+{
+    const int vertices = mesh.vertexCount();
+    const QVector3D axis = settings.axis.isNull() ? QVector3D(0.0f, 1.0f, 0.0f) : settings.axis.normalized();
+    const QVector<QVector3D>& positions = mesh.positions();
+
+    QVector<int> labels;
+    int count = 1;
+    if (settings.perPiece) {
+        count = mesh.connectedComponents(labels);
+    } else {
+        labels.fill(0, vertices);
+    }
+    if (pieceCount) *pieceCount = count;
+
+    // Jobs write disjoint ranges through raw pointers, so nothing detaches or locks.
+    QVector<float> heights(vertices);
+    float *heightData = heights.data();
+    BakeService::parallelFor(vertices, VerticesPerJob, [&](int first, int last) {
+        for (int v = first; v < last; ++v) heightData[v] = QVector3D::dotProduct(positions[v], axis);
+    }, pool);
+
+    QVector<Piece> pieces(count);
+    for (int v = 0; v < vertices; ++v) {
+        Piece& piece = pieces[labels[v]];
+        piece.lowest = std::min(piece.lowest, heights[v]);
+        piece.highest = std::max(piece.highest, heights[v]);
+        piece.sum += positions[v];
+        ++piece.vertices;
+    }
+    for (Piece& piece : pieces) {
+        if (piece.vertices == 0) continue;
+        const QVector3D centroid = piece.sum / piece.vertices;
+        // The base center: the centroid moved down the axis to the piece's lowest point.
+        piece.pivot = settings.fixedPivot ? settings.pivot
+                                          : centroid - axis * (QVector3D::dotProduct(centroid, axis) - piece.lowest);
+        piece.random = hashedRandom(centroid, settings.seed);
+    }
+
+    const Piece *pieceData = pieces.constData();
+    const int *labelData = labels.constData();
+    QVector<float> distances(vertices);
+    float *distanceData = distances.data();
+    BakeService::parallelFor(vertices, VerticesPerJob, [&](int first, int last) {
+        for (int v = first; v < last; ++v) distanceData[v] = (positions[v] - pieceData[labelData[v]].pivot).length();
+    }, pool);
+    for (int v = 0; v < vertices; ++v) {
+        Piece& piece = pieces[labels[v]];
+        piece.farthest = std::max(piece.farthest, distances[v]);
+    }
+
+    QVector<float> rgb(vertices * 3);
+    float *rgbData = rgb.data();
+    BakeService::parallelFor(vertices, VerticesPerJob, [&](int first, int last) {
+        for (int v = first; v < last; ++v) {
+            const Piece& piece = pieceData[labelData[v]];
+            const float height = piece.highest - piece.lowest;
+            rgbData[v * 3 + 0] = (height > 0.0f) ? (heightData[v] - piece.lowest) / height : 0.0f;
+            rgbData[v * 3 + 1] = (piece.farthest > 0.0f) ? distanceData[v] / piece.farthest : 0.0f;
+            rgbData[v * 3 + 2] = piece.random;
+        }
+    }, pool);
+    return rgb;
+}
+
+/**
+ * @brief Writes the weights by file type: `.obj` as vertex colors of a copy of the
+ * mesh, `.pfm` as float, anything else as a one row PNG of the given bit depth.
+ */
+bool VertexWeights::write(const QString& filePath, const ObjMesh& mesh, const QVector<float>& rgb, int bitDepth,
+                          QString *errorMessage)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    const int vertices = mesh.vertexCount();
+    if (suffix == "obj") {
+        QVector<QVector3D> colors(vertices);
+        for (int v = 0; v < vertices; ++v) colors[v] = QVector3D(rgb[v * 3], rgb[v * 3 + 1], rgb[v * 3 + 2]);
+        return ObjMesh::writeWithColors(mesh.filePath(), filePath, colors, errorMessage);
+    }
+    if (suffix == "pfm") {
+        return LutExport::writePfm(filePath, rgb.constData(), vertices, 1, errorMessage);
+    }
+    if (!LutExport::rgbLutImage(rgb, vertices, bitDepth == 8 ? 8 : 16).save(filePath, "PNG")) {
+        if (errorMessage) *errorMessage = QStringLiteral("Failed to write the image");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief The weights file next to a LUT or mesh: `<base>.weights.png`, or `.pfm` for
+ * 32-bit float.
+ */
+QString VertexWeights::weightsPath(const QString& basePath, int bitDepth)
+{
+    const QFileInfo info(basePath);
+    return info.path() + '/' + info.completeBaseName() + (bitDepth == 32 ? ".weights.pfm" : ".weights.png");
+}
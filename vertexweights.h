@@ -0,0 +1,51 @@
+#ifndef VERTEXWEIGHTS_H
+#define VERTEXWEIGHTS_H
+
+// Qt Includes
+#include <QString>
+#include <QVector>
+#include <QVector3D>
+
+// Forward Declarations
+class ObjMesh;
+class QThreadPool;
+
+/**
+ * @brief Parameters of a per-vertex weight bake.
+ */
+struct VertexWeightSettings {
+    QVector3D axis = QVector3D(0.0f, 1.0f, 0.0f);   // "Up" for heights and piece bases.
+    bool perPiece = true;       // Measure from each connected piece's own base, not the mesh's.
+    bool fixedPivot = false;    // Measure distances from pivot instead of each piece's base center.
+    QVector3D pivot;
+    quint32 seed = 0;           // Changes every piece's random value.
+};
+
+/**
+ * @brief Per-vertex attributes for staggering curve-driven sway across foliage.
+ *
+ * Each vertex gets three values in [0, 1], stored as RGB so one texture fetch (or the
+ * vertex color) pairs with the curve LUT fetch in the shader:
+ * - R: height along the axis above its piece's base, divided by the piece's height
+ *   (a stiffness weight: 0 at the root, 1 at the tip).
+ * - G: distance from the pivot (by default the piece's base center), divided by the
+ *   piece's largest distance.
+ * - B: a random value hashed from the piece's centroid, the same for every vertex of
+ *   a piece and stable when the file is re-exported in another vertex order; used
+ *   as the phase offset into the curve.
+ * Pieces are the connected components of the faces, found with union-find. The per
+ * vertex passes run in parallel on the given pool.
+ */
+class VertexWeights
+{
+public:
+    static QVector<float> compute(const ObjMesh& mesh, const VertexWeightSettings& settings,
+                                  QThreadPool *pool = nullptr, int *pieceCount = nullptr);
+    static bool write(const QString& filePath, const ObjMesh& mesh, const QVector<float>& rgb, int bitDepth,
+                      QString *errorMessage = nullptr);
+    static QString weightsPath(const QString& basePath, int bitDepth);
+
+    static const int VerticesPerJob = 65536;
+};
+
+#endif